@@ -0,0 +1,105 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "ConcurrencyHelpers/AppendOnlyManifest.h"
+#include "ConcurrencyHelpers/LogConcurrencyHelpers.h"
+
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+FString FAppendOnlyManifest::GetFile() const
+{
+	IPlatformFile::GetPlatformPhysical().CreateDirectory(*FPaths::ProjectSavedDir());
+	return FPaths::Combine(FPaths::ProjectSavedDir(), FileName);
+}
+
+void FAppendOnlyManifest::Load(TFunctionRef<bool(const FString& Key, const TArray<FString>& Fields)> OnAdd, TFunctionRef<void(const FString& Key)> OnRemove)
+{
+	ManifestLines = 0;
+
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *GetFile())) return;
+
+	for (auto& Line : Lines)
+	{
+		TArray<FString> Fields;
+		Line.ParseIntoArray(Fields, TEXT("\t"), false);
+
+		bool bValid = false;
+		if (Fields.Num() == 2 && Fields[0] == "-")
+		{
+			OnRemove(Fields[1]);
+			bValid = true;
+		}
+		else if (Fields.Num() >= 2 && Fields[0] == "+")
+		{
+			FString Key = Fields[1];
+			Fields.RemoveAt(0, 2);
+			bValid = OnAdd(Key, Fields);
+		}
+
+		if (!bValid)
+		{
+			// most likely a line that was being written when the editor was closed
+			UE_LOG(LogConcurrencyHelpers, Warning, TEXT("Ignoring invalid line in %s manifest: %s"), *Name, *Line);
+			continue;
+		}
+
+		ManifestLines++;
+	}
+
+	UE_LOG(LogConcurrencyHelpers, Log, TEXT("Loaded %d %s entries from %d manifest lines"), NumEntries(), *Name, ManifestLines);
+}
+
+void FAppendOnlyManifest::Add(const FString& Key, const TArray<FString>& Fields)
+{
+	AppendLine(MakeLine(Key, Fields));
+}
+
+void FAppendOnlyManifest::Remove(const FString& Key)
+{
+	AppendLine(FString::Printf(TEXT("-\t%s"), *Key));
+}
+
+void FAppendOnlyManifest::Clear()
+{
+	ManifestLines = 0;
+	IFileManager::Get().Delete(*GetFile());
+}
+
+void FAppendOnlyManifest::AppendLine(const FString& Line)
+{
+	ManifestLines++;
+	if (!FFileHelper::SaveStringToFile(Line + "\n", *GetFile(), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &IFileManager::Get(), FILEWRITE_Append))
+	{
+		UE_LOG(LogConcurrencyHelpers, Error, TEXT("Failed to append to %s manifest '%s'"), *Name, *GetFile());
+	}
+
+	Compact();
+}
+
+void FAppendOnlyManifest::Compact()
+{
+	// keep the number of obsolete lines proportional to the number of entries
+	if (ManifestLines <= 2 * NumEntries() + 64) return;
+
+	TArray<FString> Lines = GetLines();
+
+	FString Manifest = GetFile();
+	FString TempManifest = Manifest + ".tmp";
+	if (!FFileHelper::SaveStringArrayToFile(Lines, *TempManifest, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM) || !IFileManager::Get().Move(*Manifest, *TempManifest))
+	{
+		UE_LOG(LogConcurrencyHelpers, Error, TEXT("Failed to compact %s manifest '%s'"), *Name, *Manifest);
+		return;
+	}
+
+	UE_LOG(LogConcurrencyHelpers, Log, TEXT("Compacted %s manifest from %d to %d lines"), *Name, ManifestLines, Lines.Num());
+	ManifestLines = Lines.Num();
+}
+
+FString FAppendOnlyManifest::MakeLine(const FString& Key, const TArray<FString>& Fields)
+{
+	TArray<FString> LineFields({ "+", Key });
+	LineFields.Append(Fields);
+	return FString::Join(LineFields, TEXT("\t"));
+}
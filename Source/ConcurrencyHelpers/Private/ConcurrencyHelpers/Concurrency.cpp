@@ -4,31 +4,58 @@
 #include "ConcurrencyHelpers/LogConcurrencyHelpers.h"
 
 #include "Async/Async.h"
+#include "HAL/Event.h"
 
 #define LOCTEXT_NAMESPACE "FConcurrencyHelpersModule"
 
 void Concurrency::RunAsync(TFunction<void()> Action)
 {
+	// not on the pool: the action may block for a long time waiting for other tasks
 	Async(EAsyncExecution::Thread, [Action]() { Action(); });
 	return;
 }
 
-void Concurrency::RunMany(int n, TFunction<void( int i, TFunction<void(bool)> )> Action, TFunction<void(bool)> OnComplete)
+void Concurrency::RunMany(int n, TFunction<void( int i, TFunction<void(bool)> )> Action, TFunction<void(bool)> OnComplete, int32 MaxParallelism, FCancellationToken CancellationToken)
 {
-	TArray<int> Elements;
-	Elements.Reserve(n);
-	for (int i = 0; i < n; i++)
-	{
-		Elements.Add(i);
-	}
-	RunMany(Elements, Action, OnComplete);
+	FTaskBatch::Run(FTaskPool::Get(), n, MaxParallelism, Action, OnComplete, CancellationToken);
 }
 
 void Concurrency::RunOne(TFunction<bool(void)> Action, TFunction<void(bool)> OnComplete)
 {
-	TFuture<bool> bSuccessFuture = Async(EAsyncExecution::Thread, Action);
-	bSuccessFuture.Next(OnComplete);
+	FTaskPool::Get().Submit([Action, OnComplete]()
+	{
+		bool bSuccess = Action();
+		if (OnComplete) OnComplete(bSuccess);
+	});
 }
 
+bool Concurrency::Wait(TFunction<void(TFunction<void(bool)>)> Action, float TimeoutSeconds)
+{
+	// shared with the callback, which may be called after we gave up waiting
+	struct FWaitState
+	{
+		FWaitState() { Event = FPlatformProcess::GetSynchEventFromPool(true); }
+		~FWaitState() { FPlatformProcess::ReturnSynchEventToPool(Event); }
+
+		FEvent* Event;
+		std::atomic<bool> bSuccess { false };
+	};
+
+	TSharedRef<FWaitState, ESPMode::ThreadSafe> State = MakeShared<FWaitState, ESPMode::ThreadSafe>();
+	Action([State](bool bSuccess)
+	{
+		State->bSuccess = bSuccess;
+		State->Event->Trigger();
+	});
+
+	uint32 WaitMs = TimeoutSeconds > 0 ? FMath::CeilToInt(TimeoutSeconds * 1000) : MAX_uint32;
+	if (!State->Event->Wait(WaitMs))
+	{
+		UE_LOG(LogConcurrencyHelpers, Error, TEXT("Timed out after waiting for %.1f seconds"), TimeoutSeconds);
+		return false;
+	}
+
+	return State->bSuccess;
+}
 
-#undef LOCTEXT_NAMESPACE
\ No newline at end of file
+#undef LOCTEXT_NAMESPACE
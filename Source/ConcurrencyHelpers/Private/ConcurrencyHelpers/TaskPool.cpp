@@ -0,0 +1,343 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "ConcurrencyHelpers/TaskPool.h"
+#include "ConcurrencyHelpers/LogConcurrencyHelpers.h"
+
+#include "Algo/BinarySearch.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/ScopeLock.h"
+
+#define LOCTEXT_NAMESPACE "FConcurrencyHelpersModule"
+
+// Worker running on the current thread (if any), used to push tasks submitted from a worker on its own queue
+static thread_local void* CurrentWorker = nullptr;
+
+FTaskPool::FWorker::FWorker(FTaskPool* Pool0, int32 Index0) : Pool(Pool0), Index(Index0)
+{
+	WakeUp = FPlatformProcess::GetSynchEventFromPool(false);
+}
+
+FTaskPool::FWorker::~FWorker()
+{
+	FPlatformProcess::ReturnSynchEventToPool(WakeUp);
+}
+
+uint32 FTaskPool::FWorker::Run()
+{
+	CurrentWorker = this;
+
+	while (!Pool->bStopping)
+	{
+		TUniqueFunction<void()> Task;
+		if (Pool->FindTask(Index, Task))
+		{
+			Task();
+			Pool->PendingTasks--;
+			continue;
+		}
+
+		bSleeping = true;
+
+		// check again after announcing that we are sleeping, so that we don't miss a task submitted in between
+		if (Pool->FindTask(Index, Task))
+		{
+			bSleeping = false;
+			Task();
+			Pool->PendingTasks--;
+			continue;
+		}
+
+		WakeUp->Wait(100);
+		bSleeping = false;
+	}
+
+	CurrentWorker = nullptr;
+	return 0;
+}
+
+void FTaskPool::FWorker::Stop()
+{
+	WakeUp->Trigger();
+}
+
+bool FTaskPool::FWorker::PopLocal(TUniqueFunction<void()>& OutTask)
+{
+	FScopeLock Lock(&QueueLock);
+	if (Queue.IsEmpty()) return false;
+
+	OutTask = MoveTemp(Queue.Last());
+	Queue.PopLast();
+	return true;
+}
+
+bool FTaskPool::FWorker::StealFrom(TUniqueFunction<void()>& OutTask)
+{
+	FScopeLock Lock(&QueueLock);
+	if (Queue.IsEmpty()) return false;
+
+	OutTask = MoveTemp(Queue.First());
+	Queue.PopFirst();
+	return true;
+}
+
+FTaskPool::FTimer::FTimer(FTaskPool* Pool0) : Pool(Pool0)
+{
+	WakeUp = FPlatformProcess::GetSynchEventFromPool(false);
+}
+
+FTaskPool::FTimer::~FTimer()
+{
+	FPlatformProcess::ReturnSynchEventToPool(WakeUp);
+}
+
+uint32 FTaskPool::FTimer::Run()
+{
+	while (!bStopping)
+	{
+		TArray<TUniqueFunction<void()>> Due;
+		uint32 WaitMs = 1000;
+		{
+			FScopeLock ScopeLock(&Lock);
+			double Now = FPlatformTime::Seconds();
+			int32 NumDue = 0;
+			while (NumDue < Delayed.Num() && Delayed[NumDue].Key <= Now)
+			{
+				Due.Add(MoveTemp(Delayed[NumDue].Value));
+				NumDue++;
+			}
+			Delayed.RemoveAt(0, NumDue);
+
+			if (!Delayed.IsEmpty())
+			{
+				WaitMs = FMath::Clamp<uint32>(FMath::CeilToInt((Delayed[0].Key - Now) * 1000), 1, 1000);
+			}
+		}
+
+		for (auto& Task : Due)
+		{
+			// the task was counted by SubmitAfter, and is counted again by Submit
+			Pool->Submit(MoveTemp(Task));
+			Pool->PendingTasks--;
+		}
+
+		WakeUp->Wait(WaitMs);
+	}
+	return 0;
+}
+
+void FTaskPool::FTimer::Stop()
+{
+	bStopping = true;
+	WakeUp->Trigger();
+}
+
+FTaskPool::FTaskPool(int32 NumWorkers, FString Name)
+{
+	PoolName = Name;
+	NumWorkers = FMath::Max(1, NumWorkers);
+	UE_LOG(LogConcurrencyHelpers, Log, TEXT("Creating task pool %s with %d workers"), *Name, NumWorkers);
+
+	for (int32 i = 0; i < NumWorkers; i++)
+	{
+		Workers.Add(MakeUnique<FWorker>(this, i));
+	}
+
+	// start the threads only once all workers exist, as they can steal from each other
+	for (int32 i = 0; i < NumWorkers; i++)
+	{
+		Workers[i]->Thread = FRunnableThread::Create(Workers[i].Get(), *FString::Format(TEXT("{0}{1}"), { Name, i }));
+	}
+}
+
+FTaskPool::~FTaskPool()
+{
+	bStopping = true;
+
+	if (TimerThread)
+	{
+		TimerThread->Kill(true);
+		delete TimerThread;
+		TimerThread = nullptr;
+	}
+	Timer.Reset();
+
+	for (auto& Worker : Workers)
+	{
+		if (Worker->Thread)
+		{
+			Worker->Thread->Kill(true);
+			delete Worker->Thread;
+			Worker->Thread = nullptr;
+		}
+	}
+
+	Workers.Empty();
+}
+
+void FTaskPool::Submit(TUniqueFunction<void()> Task)
+{
+	int32 Index = -1;
+	for (auto& Worker : Workers)
+	{
+		if (Worker.Get() == CurrentWorker)
+		{
+			Index = Worker->Index;
+			break;
+		}
+	}
+
+	if (Index == -1)
+	{
+		Index = NextWorker++ % Workers.Num();
+	}
+
+	PendingTasks++;
+
+	FWorker& Worker = *Workers[Index];
+	{
+		FScopeLock Lock(&Worker.QueueLock);
+		Worker.Queue.PushLast(MoveTemp(Task));
+	}
+
+	Worker.WakeUp->Trigger();
+	WakeOneSleeping(Index);
+}
+
+void FTaskPool::SubmitAfter(float Seconds, TUniqueFunction<void()> Task)
+{
+	if (Seconds <= 0)
+	{
+		Submit(MoveTemp(Task));
+		return;
+	}
+
+	{
+		FScopeLock ScopeLock(&TimerLock);
+		if (!Timer)
+		{
+			Timer = MakeUnique<FTimer>(this);
+			TimerThread = FRunnableThread::Create(Timer.Get(), *(PoolName + "Timer"));
+		}
+	}
+
+	PendingTasks++;
+
+	{
+		FScopeLock ScopeLock(&Timer->Lock);
+		double DueTime = FPlatformTime::Seconds() + Seconds;
+		int32 Index = Algo::UpperBoundBy(Timer->Delayed, DueTime, [](const TPair<double, TUniqueFunction<void()>>& Element) { return Element.Key; });
+		Timer->Delayed.Insert(TPair<double, TUniqueFunction<void()>>(DueTime, MoveTemp(Task)), Index);
+	}
+	Timer->WakeUp->Trigger();
+}
+
+bool FTaskPool::FindTask(int32 WorkerIndex, TUniqueFunction<void()>& OutTask)
+{
+	if (Workers[WorkerIndex]->PopLocal(OutTask)) return true;
+
+	const int32 N = Workers.Num();
+	for (int32 Offset = 1; Offset < N; Offset++)
+	{
+		if (Workers[(WorkerIndex + Offset) % N]->StealFrom(OutTask)) return true;
+	}
+
+	return false;
+}
+
+void FTaskPool::WakeOneSleeping(int32 SkipIndex)
+{
+	for (auto& Worker : Workers)
+	{
+		if (Worker->Index != SkipIndex && Worker->bSleeping)
+		{
+			Worker->WakeUp->Trigger();
+			return;
+		}
+	}
+}
+
+FTaskPool& FTaskPool::Get()
+{
+	FScopeLock Lock(&GlobalPoolLock);
+	if (!GlobalPool.IsValid())
+	{
+		GlobalPool = MakeUnique<FTaskPool>(FMath::Max(2, FPlatformMisc::NumberOfCoresIncludingHyperthreads() - 1), "LandscapeCombinatorWorker");
+	}
+	return *GlobalPool;
+}
+
+void FTaskPool::Shutdown()
+{
+	FScopeLock Lock(&GlobalPoolLock);
+	GlobalPool.Reset();
+}
+
+void FTaskBatch::Run(
+	FTaskPool& Pool, int32 NumTasks, int32 MaxParallelism,
+	TFunction<void(int i, TFunction<void(bool)>)> Action, TFunction<void(bool)> OnComplete,
+	FCancellationToken CancellationToken
+)
+{
+	if (NumTasks <= 0)
+	{
+		if (OnComplete) OnComplete(true);
+		return;
+	}
+
+	if (MaxParallelism <= 0) MaxParallelism = Pool.NumWorkers();
+	const int32 NumSlots = FMath::Min(MaxParallelism, NumTasks);
+
+	UE_LOG(LogConcurrencyHelpers, Log, TEXT("Starting %d tasks asynchronously with at most %d in flight"), NumTasks, NumSlots);
+
+	RunningBatches++;
+
+	TSharedRef<FTaskBatch, ESPMode::ThreadSafe> Batch = MakeShareable(new FTaskBatch(Pool, NumTasks, Action, OnComplete, CancellationToken));
+	for (int32 i = 0; i < NumSlots; i++)
+	{
+		Batch->LaunchNext();
+	}
+}
+
+void FTaskBatch::LaunchNext()
+{
+	const int32 i = NextTask++;
+	if (i >= NumTasks) return;
+
+	Pool.Submit([Self = AsShared(), i]()
+	{
+		if (Self->CancellationToken.IsCancelled())
+		{
+			Self->OnTaskComplete(false);
+			return;
+		}
+
+		// tasks are not always careful to call their callback only once
+		TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> bReported = MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+		Self->Action(i, [Self, bReported](bool bSuccess)
+		{
+			if (bReported->exchange(true)) return;
+			Self->OnTaskComplete(bSuccess);
+		});
+	});
+}
+
+void FTaskBatch::OnTaskComplete(bool bSuccess)
+{
+	if (bSuccess) SuccessfulTasks++;
+
+	if (++FinishedTasks == NumTasks)
+	{
+		const bool bAllSuccessful = SuccessfulTasks == NumTasks;
+		UE_LOG(LogConcurrencyHelpers, Log, TEXT("Finished %d tasks (%d successful)"), NumTasks, SuccessfulTasks.load());
+		if (OnComplete) OnComplete(bAllSuccessful);
+		RunningBatches--;
+	}
+	else
+	{
+		LaunchNext();
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -1,7 +1,15 @@
 // Copyright 2023 LandscapeCombinator. All Rights Reserved.
 
 #include "ConcurrencyHelpersModule.h"
+#include "ConcurrencyHelpers/TaskPool.h"
 
 #define LOCTEXT_NAMESPACE "FConcurrencyHelpersModule"
 	
 IMPLEMENT_MODULE(FConcurrencyHelpersModule, ConcurrencyHelpers)
+
+void FConcurrencyHelpersModule::ShutdownModule()
+{
+	FTaskPool::Shutdown();
+}
+
+#undef LOCTEXT_NAMESPACE
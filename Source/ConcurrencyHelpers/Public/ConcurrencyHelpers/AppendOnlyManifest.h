@@ -0,0 +1,43 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// File in the Saved folder persisting a map of entries, one tab-separated line per change: "+ Key Fields..." adds or
+// replaces the entry `Key` and "- Key" removes it, so that later lines override earlier ones.
+// The file is rewritten from the current entries when it contains too many obsolete lines.
+// The entries themselves are kept by the owner, which calls all methods while holding the lock protecting them.
+class CONCURRENCYHELPERS_API FAppendOnlyManifest
+{
+public:
+	// `Name` is used in logs, `NumEntries` returns the number of entries of the owner,
+	// and `GetLines` returns the lines of its entries (see MakeLine) to rewrite the manifest with
+	FAppendOnlyManifest(FString Name0, FString FileName0, TFunction<int32()> NumEntries0, TFunction<TArray<FString>()> GetLines0) :
+		Name(Name0), FileName(FileName0), NumEntries(NumEntries0), GetLines(GetLines0)
+	{}
+
+	FString GetFile() const;
+
+	// Calls `OnAdd` with the key and the fields after the key of each "+" line, and `OnRemove` with the key of each "-" line.
+	// `OnAdd` returns false for invalid lines, which are skipped.
+	void Load(TFunctionRef<bool(const FString& Key, const TArray<FString>& Fields)> OnAdd, TFunctionRef<void(const FString& Key)> OnRemove);
+
+	void Add(const FString& Key, const TArray<FString>& Fields);
+	void Remove(const FString& Key);
+	void Clear();
+
+	// Rewrites the manifest if it contains too many obsolete lines
+	void Compact();
+
+	static FString MakeLine(const FString& Key, const TArray<FString>& Fields);
+
+private:
+	void AppendLine(const FString& Line);
+
+	FString Name;
+	FString FileName;
+	TFunction<int32()> NumEntries;
+	TFunction<TArray<FString>()> GetLines;
+	int32 ManifestLines = 0;
+};
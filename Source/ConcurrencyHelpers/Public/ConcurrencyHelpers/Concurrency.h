@@ -4,41 +4,41 @@
 
 #include "CoreMinimal.h"
 #include "LogConcurrencyHelpers.h"
+#include "ConcurrencyHelpers/TaskPool.h"
 
 class CONCURRENCYHELPERS_API Concurrency
 {
 public:
+	// Maximum number of tasks in flight for CPU-bound and IO-bound batches (0 means one per worker of the pool)
+	static inline int32 MaxCPUParallelism = 0;
+	static inline int32 MaxIOParallelism = 8;
+
 	template<typename T>
-	static void RunMany(TArray<T> Elements, TFunction<void( T Element, TFunction<void(bool)> )> Action, TFunction<void(bool)> OnComplete)
+	static void RunMany(
+		TArray<T> Elements, TFunction<void( T Element, TFunction<void(bool)> )> Action, TFunction<void(bool)> OnComplete,
+		int32 MaxParallelism = MaxCPUParallelism, FCancellationToken CancellationToken = FCancellationToken()
+	)
 	{
-		int32 NumberOfTasks = Elements.Num();
-		std::atomic<int32> *SuccessfulTasks = new std::atomic<int>(0);
-		std::atomic<int32> *FinishedTasks = new std::atomic<int>(0);
-		UE_LOG(LogTemp, Log, TEXT("Starting %d tasks asynchronously"), NumberOfTasks);
-
-		TFunction<void(bool)> OnCompleteAction = [FinishedTasks, SuccessfulTasks, NumberOfTasks, OnComplete](bool bWasSuccessful) {
-			int FinishedTasksLocal = ++(*FinishedTasks);
-			if (bWasSuccessful) (*SuccessfulTasks)++;
-
-			if (FinishedTasksLocal == NumberOfTasks)
+		RunMany(
+			Elements.Num(),
+			[Elements, Action](int i, TFunction<void(bool)> OnCompleteElement)
 			{
-				if (OnComplete) OnComplete(*SuccessfulTasks == NumberOfTasks);
-			}
-		};
-
-		for (const T& Element : Elements)
-		{
-			Async(EAsyncExecution::Thread,
-				[Element, Action, OnCompleteAction]() {
-					Action(Element, OnCompleteAction);
-				}
-			);
-		}
-
-		return;
+				Action(Elements[i], OnCompleteElement);
+			},
+			OnComplete,
+			MaxParallelism,
+			CancellationToken
+		);
 	}
 
 	static void RunAsync(TFunction<void()> Action);
-	static void RunMany(int n, TFunction<void( int i, TFunction<void(bool)> )> Action, TFunction<void(bool)> OnComplete);
+	static void RunMany(
+		int n, TFunction<void( int i, TFunction<void(bool)> )> Action, TFunction<void(bool)> OnComplete,
+		int32 MaxParallelism = MaxCPUParallelism, FCancellationToken CancellationToken = FCancellationToken()
+	);
 	static void RunOne(TFunction<bool(void)> Action, TFunction<void(bool)> OnComplete);
+
+	// Starts `Action` and blocks the calling thread until it calls its completion callback or `TimeoutSeconds` elapse (0 means no timeout).
+	// Returns false on timeout. `Action` must not need the calling thread to make progress.
+	static bool Wait(TFunction<void(TFunction<void(bool)>)> Action, float TimeoutSeconds);
 };
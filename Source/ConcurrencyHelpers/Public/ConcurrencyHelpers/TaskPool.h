@@ -0,0 +1,138 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Deque.h"
+#include "HAL/Runnable.h"
+
+#include <atomic>
+
+class FRunnableThread;
+class FEvent;
+
+// Shared flag that can be used to cancel all the not-yet-started tasks of a batch
+class CONCURRENCYHELPERS_API FCancellationToken
+{
+public:
+	FCancellationToken() : bCancelled(MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false)) {}
+
+	void Cancel() const { *bCancelled = true; }
+	bool IsCancelled() const { return *bCancelled; }
+
+private:
+	TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> bCancelled;
+};
+
+// Fixed-size pool of worker threads, each owning a queue of tasks.
+// Idle workers steal the oldest tasks from the queues of busy workers.
+class CONCURRENCYHELPERS_API FTaskPool
+{
+public:
+	FTaskPool(int32 NumWorkers, FString Name);
+	~FTaskPool();
+
+	void Submit(TUniqueFunction<void()> Task);
+
+	// Submits `Task` once `Seconds` have elapsed, without holding a worker in the meantime
+	void SubmitAfter(float Seconds, TUniqueFunction<void()> Task);
+
+	int32 NumWorkers() const { return Workers.Num(); }
+
+	// Tasks that were submitted and have not finished running yet, including the ones waiting for SubmitAfter
+	int32 NumPendingTasks() const { return PendingTasks; }
+
+	static FTaskPool& Get();
+	static void Shutdown();
+
+private:
+	class FWorker : public FRunnable
+	{
+	public:
+		FWorker(FTaskPool* Pool0, int32 Index0);
+		~FWorker();
+
+		uint32 Run() override;
+		void Stop() override;
+
+		bool PopLocal(TUniqueFunction<void()>& OutTask);
+		bool StealFrom(TUniqueFunction<void()>& OutTask);
+
+		FTaskPool* Pool;
+		int32 Index;
+		FCriticalSection QueueLock;
+		TDeque<TUniqueFunction<void()>> Queue;
+		FEvent* WakeUp = nullptr;
+		FRunnableThread* Thread = nullptr;
+		std::atomic<bool> bSleeping { false };
+	};
+
+	// Thread holding the tasks submitted with SubmitAfter until they are due
+	class FTimer : public FRunnable
+	{
+	public:
+		FTimer(FTaskPool* Pool0);
+		~FTimer();
+
+		uint32 Run() override;
+		void Stop() override;
+
+		FTaskPool* Pool;
+		FCriticalSection Lock;
+		TArray<TPair<double, TUniqueFunction<void()>>> Delayed; // sorted by due time
+		FEvent* WakeUp = nullptr;
+		std::atomic<bool> bStopping { false };
+	};
+
+	bool FindTask(int32 WorkerIndex, TUniqueFunction<void()>& OutTask);
+	void WakeOneSleeping(int32 SkipIndex);
+
+	TArray<TUniquePtr<FWorker>> Workers;
+	TUniquePtr<FTimer> Timer;
+	FCriticalSection TimerLock;
+	FRunnableThread* TimerThread = nullptr;
+	FString PoolName;
+	std::atomic<uint32> NextWorker { 0 };
+	std::atomic<int32> PendingTasks { 0 };
+	std::atomic<bool> bStopping { false };
+
+	static inline TUniquePtr<FTaskPool> GlobalPool;
+	static inline FCriticalSection GlobalPoolLock;
+};
+
+// A batch of `NumTasks` tasks running on a pool with at most `MaxParallelism` tasks in flight.
+// A task is in flight from the moment it starts until it calls its completion callback, so
+// asynchronous tasks (e.g. downloads) also count towards the limit.
+// `OnComplete` is called exactly once, after every task has reported completion.
+class CONCURRENCYHELPERS_API FTaskBatch : public TSharedFromThis<FTaskBatch, ESPMode::ThreadSafe>
+{
+public:
+	static void Run(
+		FTaskPool& Pool, int32 NumTasks, int32 MaxParallelism,
+		TFunction<void(int i, TFunction<void(bool)>)> Action, TFunction<void(bool)> OnComplete,
+		FCancellationToken CancellationToken
+	);
+
+	// Batches whose OnComplete has not been called yet, on all pools
+	static int32 NumRunning() { return RunningBatches; }
+
+private:
+	FTaskBatch(FTaskPool& Pool0, int32 NumTasks0, TFunction<void(int i, TFunction<void(bool)>)> Action0, TFunction<void(bool)> OnComplete0, FCancellationToken CancellationToken0) :
+		Pool(Pool0), NumTasks(NumTasks0), Action(Action0), OnComplete(OnComplete0), CancellationToken(CancellationToken0)
+	{}
+
+	void LaunchNext();
+	void OnTaskComplete(bool bSuccess);
+
+	FTaskPool& Pool;
+	int32 NumTasks;
+	TFunction<void(int i, TFunction<void(bool)>)> Action;
+	TFunction<void(bool)> OnComplete;
+	FCancellationToken CancellationToken;
+
+	std::atomic<int32> NextTask { 0 };
+	std::atomic<int32> FinishedTasks { 0 };
+	std::atomic<int32> SuccessfulTasks { 0 };
+
+	static inline std::atomic<int32> RunningBatches { 0 };
+};
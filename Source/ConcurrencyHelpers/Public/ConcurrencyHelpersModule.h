@@ -5,4 +5,7 @@
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
 
-class FConcurrencyHelpersModule : public IModuleInterface {};
+class FConcurrencyHelpersModule : public IModuleInterface
+{
+	void ShutdownModule() override;
+};
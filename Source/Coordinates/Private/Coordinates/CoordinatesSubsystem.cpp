@@ -0,0 +1,198 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "Coordinates/CoordinatesSubsystem.h"
+#include "Coordinates/LevelCoordinates.h"
+
+#include "Async/Async.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/MessageDialog.h"
+#include "UObject/UObjectGlobals.h"
+
+#if WITH_EDITOR
+#include "Editor.h"
+#endif
+
+#define LOCTEXT_NAMESPACE "FCoordinatesModule"
+
+void UCoordinatesSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	UWorld* World = GetWorld();
+	ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UCoordinatesSubsystem::OnActorSpawnedOrDestroyed));
+	ActorDestroyedHandle = World->AddOnActorDestroyedHandler(FOnActorDestroyed::FDelegate::CreateUObject(this, &UCoordinatesSubsystem::OnActorSpawnedOrDestroyed));
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UCoordinatesSubsystem::OnLevelAddedOrRemoved);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UCoordinatesSubsystem::OnLevelAddedOrRemoved);
+	PropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddUObject(this, &UCoordinatesSubsystem::OnObjectPropertyChanged);
+
+#if WITH_EDITOR
+	UndoRedoHandle = FEditorDelegates::PostUndoRedo.AddUObject(this, &UCoordinatesSubsystem::Invalidate);
+#endif
+}
+
+void UCoordinatesSubsystem::PostInitialize()
+{
+	Super::PostInitialize();
+
+	// the actors of the persistent level are loaded by now, and other threads may need the coordinates before anything
+	// on the game thread asks for them
+	GetGlobalCoordinates(false);
+}
+
+void UCoordinatesSubsystem::Deinitialize()
+{
+	UWorld* World = GetWorld();
+	World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	World->RemoveOnActorDestroyededHandler(ActorDestroyedHandle); // sic, this is the engine's spelling
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(PropertyChangedHandle);
+
+#if WITH_EDITOR
+	FEditorDelegates::PostUndoRedo.Remove(UndoRedoHandle);
+#endif
+
+	Super::Deinitialize();
+}
+
+UGlobalCoordinates* UCoordinatesSubsystem::GetGlobalCoordinates(bool bShowDialog)
+{
+	// the lookup goes through the actors of the world, which is only allowed on the game thread
+	if (!IsInGameThread())
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (Lookup == ELookup::Outdated) ScheduleRefresh();
+		return Lookup == ELookup::Found ? GlobalCoordinates.Get() : nullptr;
+	}
+
+	ELookup Result;
+	UGlobalCoordinates* Found;
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		// actors can also be hidden, or destroyed, without notifications
+		bool bStillValid = GlobalCoordinates.IsValid() && IsValid(GlobalCoordinates->GetOwner()) && !GlobalCoordinates->GetOwner()->IsHidden();
+		if (Lookup == ELookup::Outdated || (Lookup == ELookup::Found && !bStillValid))
+		{
+			Find();
+		}
+		else if (Lookup == ELookup::Found)
+		{
+			Snapshot = GlobalCoordinates->GetSnapshot();
+		}
+
+		Result = Lookup;
+		Found = GlobalCoordinates.Get();
+	}
+
+	if (Result == ELookup::NotFound)
+	{
+		if (bShowDialog)
+		{
+			FMessageDialog::Open(EAppMsgType::Ok,
+				LOCTEXT("NoLevelCoordinates", "Please add a visible (not Hidden in Game) LevelCoordinates actor to your level .")
+			);
+		}
+		return nullptr;
+	}
+
+	if (Result == ELookup::Ambiguous)
+	{
+		if (bShowDialog)
+		{
+			FMessageDialog::Open(EAppMsgType::Ok,
+				LOCTEXT("MoreThanOneLevelCoordinates", "You must have only one visible (not Hidden in Game) LevelCoordinates actor in your level.")
+			);
+		}
+		return nullptr;
+	}
+
+	return Found;
+}
+
+bool UCoordinatesSubsystem::GetSnapshot(FGlobalCoordinatesSnapshot& OutSnapshot)
+{
+	if (IsInGameThread() && !GetGlobalCoordinates(false)) return false;
+
+	FScopeLock ScopeLock(&Lock);
+
+	// other threads only read the snapshot of the last lookup, and leave outdated lookups to the game thread
+	if (Lookup == ELookup::Outdated) ScheduleRefresh();
+	if (Lookup != ELookup::Found) return false;
+
+	OutSnapshot = Snapshot;
+	return true;
+}
+
+void UCoordinatesSubsystem::Invalidate()
+{
+	FScopeLock ScopeLock(&Lock);
+	Lookup = ELookup::Outdated;
+	ScheduleRefresh();
+}
+
+void UCoordinatesSubsystem::ScheduleRefresh()
+{
+	if (bRefreshScheduled) return;
+	bRefreshScheduled = true;
+
+	// not done right away, as the notifications come in the middle of spawning, destroying or editing actors
+	AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakObjectPtr<UCoordinatesSubsystem>(this)]()
+	{
+		UCoordinatesSubsystem* This = WeakThis.Get();
+		if (!This) return;
+
+		{
+			FScopeLock ScopeLock(&This->Lock);
+			This->bRefreshScheduled = false;
+		}
+		This->GetGlobalCoordinates(false);
+	});
+}
+
+void UCoordinatesSubsystem::Find()
+{
+	TArray<AActor*> LevelCoordinatesCandidates0;
+	UGameplayStatics::GetAllActorsOfClass(GetWorld(), ALevelCoordinates::StaticClass(), LevelCoordinatesCandidates0);
+	TArray<AActor*> LevelCoordinatesCandidates = LevelCoordinatesCandidates0.FilterByPredicate([](AActor* Actor) { return !Actor->IsHidden(); });
+
+	GlobalCoordinates = nullptr;
+	if (LevelCoordinatesCandidates.Num() == 0)
+	{
+		Lookup = ELookup::NotFound;
+	}
+	else if (LevelCoordinatesCandidates.Num() > 1)
+	{
+		Lookup = ELookup::Ambiguous;
+	}
+	else
+	{
+		GlobalCoordinates = Cast<ALevelCoordinates>(LevelCoordinatesCandidates[0])->GlobalCoordinates;
+
+		// a LevelCoordinates actor without GlobalCoordinates is treated like a missing one
+		Lookup = GlobalCoordinates.IsValid() ? ELookup::Found : ELookup::NotFound;
+		if (GlobalCoordinates.IsValid()) Snapshot = GlobalCoordinates->GetSnapshot();
+	}
+}
+
+void UCoordinatesSubsystem::OnActorSpawnedOrDestroyed(AActor* Actor)
+{
+	// spline importers and building generators spawn many other actors, which must not throw the lookup away
+	if (Actor && Actor->IsA<ALevelCoordinates>()) Invalidate();
+}
+
+void UCoordinatesSubsystem::OnLevelAddedOrRemoved(ULevel* Level, UWorld* World)
+{
+	if (World == GetWorld()) Invalidate();
+}
+
+void UCoordinatesSubsystem::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& Event)
+{
+	if (Object && (Object->IsA<ALevelCoordinates>() || Object->IsA<UGlobalCoordinates>()) && Object->GetWorld() == GetWorld())
+	{
+		Invalidate();
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
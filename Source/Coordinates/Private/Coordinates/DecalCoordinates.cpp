@@ -64,9 +64,10 @@ void UDecalCoordinates::PlaceDecal(FVector4d &OutCoordinates)
 	double South = Coordinates[2];
 	double North = Coordinates[3];
 
-	FVector2D TopLeft, BottomRight;
-	if (!GlobalCoordinates->GetUnrealCoordinatesFromCRS(West, North, GlobalCoordinates->CRS, TopLeft)) return;
-	if (!GlobalCoordinates->GetUnrealCoordinatesFromCRS(East, South, GlobalCoordinates->CRS, BottomRight)) return;
+	FVector2D Corners[2] = { { West, North }, { East, South } };
+	if (!GlobalCoordinates->GetUnrealCoordinatesFromCRS(Corners, GlobalCoordinates->CRS)) return;
+	FVector2D TopLeft = Corners[0];
+	FVector2D BottomRight = Corners[1];
 
 	// Unreal Coordinates
 	double Left = TopLeft[0];
@@ -13,15 +13,9 @@ void UGlobalCoordinates::GetUnrealCoordinatesFromCRS(double Longitude, double La
 	XY[1] = (Latitude - WorldOriginLat) * CmPerLatUnit;
 }
 
-OGRCoordinateTransformation* UGlobalCoordinates::GetCRSTransformer(FString FromCRS)
+TransformRegistry::FTransformRef UGlobalCoordinates::GetCRSTransformer(FString FromCRS)
 {
-	OGRSpatialReference InRs, OutRs;
-	if (!GDALInterface::SetCRSFromUserInput(InRs, FromCRS) || !GDALInterface::SetCRSFromUserInput(OutRs, CRS))
-	{ 
-		return nullptr;
-	}
-	
-	return OGRCreateCoordinateTransformation(&InRs, &OutRs);
+	return TransformRegistry::Get(FromCRS, CRS);
 }
 
 bool UGlobalCoordinates::GetUnrealCoordinatesFromCRS(double Longitude, double Latitude, FString FromCRS, FVector2D &XY)
@@ -29,12 +23,7 @@ bool UGlobalCoordinates::GetUnrealCoordinatesFromCRS(double Longitude, double La
 	double ConvertedLongitude = Longitude;
 	double ConvertedLatitude = Latitude;
 	
-	OGRSpatialReference InRs, OutRs;
-	if (
-		!GDALInterface::SetCRSFromUserInput(InRs, FromCRS) ||
-		!GDALInterface::SetCRSFromUserInput(OutRs, CRS) ||
-		!OGRCreateCoordinateTransformation(&InRs, &OutRs)->Transform(1, &ConvertedLongitude, &ConvertedLatitude)
-	)
+	if (!TransformRegistry::Transform(FromCRS, CRS, 1, &ConvertedLongitude, &ConvertedLatitude))
 	{	
 		FMessageDialog::Open(EAppMsgType::Ok,
 			LOCTEXT("GetUnrealCoordinatesFromCRS", "Internal error while transforming coordinates.")
@@ -63,12 +52,7 @@ bool UGlobalCoordinates::GetCRSCoordinatesFromUnrealLocation(FVector2D Location,
 	OutCoordinates[1] = Location.Y / CmPerLatUnit + WorldOriginLat;
 	
 	// convert to ToCRS
-	OGRSpatialReference InRs, OutRs;
-	if (
-		!GDALInterface::SetCRSFromUserInput(InRs, CRS) ||
-		!GDALInterface::SetCRSFromUserInput(OutRs, ToCRS) ||
-		!OGRCreateCoordinateTransformation(&InRs, &OutRs)->Transform(1, &OutCoordinates[0], &OutCoordinates[1])
-	)
+	if (!TransformRegistry::Transform(CRS, ToCRS, 1, &OutCoordinates[0], &OutCoordinates[1]))
 	{	
 		FMessageDialog::Open(EAppMsgType::Ok,
 			LOCTEXT("GetCRSCoordinatesFromUnrealLocation", "Internal error while transforming coordinates.")
@@ -98,12 +82,7 @@ bool UGlobalCoordinates::GetCRSCoordinatesFromUnrealLocations(FVector4d Location
 	double ys[2] = { Locations[3] / CmPerLatUnit + WorldOriginLat, Locations[2] / CmPerLatUnit + WorldOriginLat };
 
 	// convert to ToCRS
-	OGRSpatialReference InRs, OutRs;
-	if (
-		!GDALInterface::SetCRSFromUserInput(InRs, CRS) ||
-		!GDALInterface::SetCRSFromUserInput(OutRs, ToCRS) ||
-		!OGRCreateCoordinateTransformation(&InRs, &OutRs)->Transform(2, xs, ys)
-	)
+	if (!TransformRegistry::Transform(CRS, ToCRS, 2, xs, ys))
 	{	
 		FMessageDialog::Open(EAppMsgType::Ok,
 			LOCTEXT("GetCRSCoordinatesFromUnrealLocation", "Internal error while transforming coordinates.")
@@ -119,6 +98,69 @@ bool UGlobalCoordinates::GetCRSCoordinatesFromUnrealLocations(FVector4d Location
 	return true;
 }
 
+bool FGlobalCoordinatesSnapshot::GetUnrealCoordinatesFromCRS(TArrayView<FVector2D> Points, const FString& FromCRS) const
+{
+	if (!TransformRegistry::Transform(FromCRS, CRS, Points)) return false;
+
+	for (FVector2D& Point : Points)
+	{
+		Point[0] = (Point[0] - WorldOriginLong) * CmPerLongUnit;
+		Point[1] = (Point[1] - WorldOriginLat) * CmPerLatUnit;
+	}
+
+	return true;
+}
+
+bool FGlobalCoordinatesSnapshot::GetCRSCoordinatesFromUnrealLocations(TArrayView<FVector2D> Locations, const FString& ToCRS) const
+{
+	// in Global CRS
+	for (FVector2D& Location : Locations)
+	{
+		Location[0] = Location[0] / CmPerLongUnit + WorldOriginLong;
+		Location[1] = Location[1] / CmPerLatUnit + WorldOriginLat;
+	}
+
+	// convert to ToCRS
+	return TransformRegistry::Transform(CRS, ToCRS, Locations);
+}
+
+FGlobalCoordinatesSnapshot UGlobalCoordinates::GetSnapshot() const
+{
+	FGlobalCoordinatesSnapshot Snapshot;
+	Snapshot.CRS = CRS;
+	Snapshot.CmPerLongUnit = CmPerLongUnit;
+	Snapshot.CmPerLatUnit = CmPerLatUnit;
+	Snapshot.WorldOriginLong = WorldOriginLong;
+	Snapshot.WorldOriginLat = WorldOriginLat;
+	return Snapshot;
+}
+
+bool UGlobalCoordinates::GetUnrealCoordinatesFromCRS(TArrayView<FVector2D> Points, FString FromCRS)
+{
+	if (!GetSnapshot().GetUnrealCoordinatesFromCRS(Points, FromCRS))
+	{
+		FMessageDialog::Open(EAppMsgType::Ok,
+			LOCTEXT("GetUnrealCoordinatesFromCRS", "Internal error while transforming coordinates.")
+		);
+		return false;
+	}
+
+	return true;
+}
+
+bool UGlobalCoordinates::GetCRSCoordinatesFromUnrealLocations(TArrayView<FVector2D> Locations, FString ToCRS)
+{
+	if (!GetSnapshot().GetCRSCoordinatesFromUnrealLocations(Locations, ToCRS))
+	{
+		FMessageDialog::Open(EAppMsgType::Ok,
+			LOCTEXT("GetCRSCoordinatesFromUnrealLocation", "Internal error while transforming coordinates.")
+		);
+		return false;
+	}
+
+	return true;
+}
+
 bool UGlobalCoordinates::GetCRSCoordinatesFromFBox(FBox Box, FString ToCRS, FVector4d& OutCoordinates)
 {
 	return GetCRSCoordinatesFromOriginExtent(Box.GetCenter(), Box.GetExtent(), ToCRS, OutCoordinates);
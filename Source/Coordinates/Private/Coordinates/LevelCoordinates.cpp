@@ -1,6 +1,7 @@
 // Copyright 2023 LandscapeCombinator. All Rights Reserved.
 
 #include "Coordinates/LevelCoordinates.h"
+#include "Coordinates/CoordinatesSubsystem.h"
 #include "Coordinates/DecalCoordinates.h"
 #include "FileDownloader/Download.h"
 
@@ -20,13 +21,8 @@ ALevelCoordinates::ALevelCoordinates()
 
 TObjectPtr<UGlobalCoordinates> ALevelCoordinates::GetGlobalCoordinates(UWorld* World, bool bShowDialog)
 {
-	TArray<AActor*> LevelCoordinatesCandidates0;
-
-	UGameplayStatics::GetAllActorsOfClass(World, ALevelCoordinates::StaticClass(), LevelCoordinatesCandidates0);
-
-	TArray<AActor*> LevelCoordinatesCandidates = LevelCoordinatesCandidates0.FilterByPredicate([](AActor* Actor) { return !Actor->IsHidden(); });
-
-	if (LevelCoordinatesCandidates.Num() == 0)
+	UCoordinatesSubsystem* CoordinatesSubsystem = World ? World->GetSubsystem<UCoordinatesSubsystem>() : nullptr;
+	if (!CoordinatesSubsystem)
 	{
 		if (bShowDialog)
 		{
@@ -37,22 +33,11 @@ TObjectPtr<UGlobalCoordinates> ALevelCoordinates::GetGlobalCoordinates(UWorld* W
 		return nullptr;
 	}
 
-	if (LevelCoordinatesCandidates.Num() > 1)
-	{
-		if (bShowDialog)
-		{
-			FMessageDialog::Open(EAppMsgType::Ok,
-				LOCTEXT("MoreThanOneLevelCoordinates", "You must have only one visible (not Hidden in Game) LevelCoordinates actor in your level.")
-			);
-		}
-		return nullptr;
-	}
-
-	return Cast<ALevelCoordinates>(LevelCoordinatesCandidates[0])->GlobalCoordinates;
+	return CoordinatesSubsystem->GetGlobalCoordinates(bShowDialog);
 }
 
 
-OGRCoordinateTransformation *ALevelCoordinates::GetCRSTransformer(UWorld* World, FString CRS)
+TransformRegistry::FTransformRef ALevelCoordinates::GetCRSTransformer(UWorld* World, FString CRS)
 {
 	TObjectPtr<UGlobalCoordinates> GlobalCoordinates = ALevelCoordinates::GetGlobalCoordinates(World);
 	if (!GlobalCoordinates) return nullptr;
@@ -147,6 +132,20 @@ bool ALevelCoordinates::GetActorCRSBounds(AActor* Actor, FVector4d& OutCoordinat
 	return GlobalCoordinates->GetActorCRSBounds(Actor, OutCoordinates);
 }
 
+bool ALevelCoordinates::GetUnrealCoordinatesFromCRS(UWorld* World, TArrayView<FVector2D> Points, FString CRS)
+{
+	TObjectPtr<UGlobalCoordinates> GlobalCoordinates = ALevelCoordinates::GetGlobalCoordinates(World);
+	if (!GlobalCoordinates) return false;
+	return GlobalCoordinates->GetUnrealCoordinatesFromCRS(Points, CRS);
+}
+
+bool ALevelCoordinates::GetCRSCoordinatesFromUnrealLocations(UWorld* World, TArrayView<FVector2D> Locations, FString CRS)
+{
+	TObjectPtr<UGlobalCoordinates> GlobalCoordinates = ALevelCoordinates::GetGlobalCoordinates(World);
+	if (!GlobalCoordinates) return false;
+	return GlobalCoordinates->GetCRSCoordinatesFromUnrealLocations(Locations, CRS);
+}
+
 void ALevelCoordinates::CreateWorldMap()
 {
 	if (!GlobalCoordinates)
@@ -0,0 +1,69 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "Coordinates/GlobalCoordinates.h"
+
+#include "Subsystems/WorldSubsystem.h"
+
+#include "CoordinatesSubsystem.generated.h"
+
+#define LOCTEXT_NAMESPACE "FCoordinatesModule"
+
+/* Remembers the LevelCoordinates actor of a world, instead of going through all the actors of the world on each coordinate conversion.
+ * The lookup is done when the world is initialized, and again after a LevelCoordinates actor is spawned, destroyed or edited, after a level is added or removed,
+ * and after an undo or redo. */
+UCLASS()
+class COORDINATES_API UCoordinatesSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+	void PostInitialize() override;
+	void Deinitialize() override;
+
+	/* The GlobalCoordinates of the only visible LevelCoordinates actor of the world, or nullptr after showing a dialog if `bShowDialog` is true.
+	 * Outside of the game thread, this is the result of the last lookup, without dialogs, and an outdated lookup is scheduled on the game thread. */
+	UGlobalCoordinates* GetGlobalCoordinates(bool bShowDialog = true);
+
+	/* The parameters of the GlobalCoordinates, usable from any thread; they are refreshed by the calls from the game thread.
+	 * Other threads get false until the game thread has done the lookup, which is scheduled when it is outdated. */
+	bool GetSnapshot(FGlobalCoordinatesSnapshot& OutSnapshot);
+
+	void Invalidate();
+
+private:
+	enum class ELookup : uint8
+	{
+		Outdated,
+		Found,
+		NotFound,
+		Ambiguous
+	};
+
+	ELookup Lookup = ELookup::Outdated;
+	TWeakObjectPtr<UGlobalCoordinates> GlobalCoordinates;
+	FGlobalCoordinatesSnapshot Snapshot;
+	FCriticalSection Lock;
+	bool bRefreshScheduled = false;
+
+	// Must be called with `Lock` held
+	void Find();
+
+	// Must be called with `Lock` held, refreshes the lookup on the game thread soon
+	void ScheduleRefresh();
+
+	void OnActorSpawnedOrDestroyed(AActor* Actor);
+	void OnLevelAddedOrRemoved(ULevel* Level, UWorld* World);
+	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& Event);
+
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle ActorDestroyedHandle;
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+	FDelegateHandle PropertyChangedHandle;
+	FDelegateHandle UndoRedoHandle;
+};
+
+#undef LOCTEXT_NAMESPACE
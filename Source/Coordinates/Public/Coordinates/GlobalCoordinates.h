@@ -3,11 +3,26 @@
 #pragma once
 
 #include "GDALInterface/GDALInterface.h"
+#include "GDALInterface/TransformRegistry.h"
 
 #include "Landscape.h"
 
 #include "GlobalCoordinates.generated.h"
 
+/* A copy of the parameters of a UGlobalCoordinates, which worker threads can use without touching the component */
+struct COORDINATES_API FGlobalCoordinatesSnapshot
+{
+	FString CRS;
+	double CmPerLongUnit = 0;
+	double CmPerLatUnit = 0;
+	double WorldOriginLong = 0;
+	double WorldOriginLat = 0;
+
+	/* Same as the batch conversions of UGlobalCoordinates, without dialogs */
+	bool GetUnrealCoordinatesFromCRS(TArrayView<FVector2D> Points, const FString& FromCRS) const;
+	bool GetCRSCoordinatesFromUnrealLocations(TArrayView<FVector2D> Locations, const FString& ToCRS) const;
+};
+
 UCLASS(BlueprintType)
 class COORDINATES_API UGlobalCoordinates : public UActorComponent
 {
@@ -52,11 +67,12 @@ public:
 	
 
 
-	/* This function is slow. If you need to call it many times, make a single OGRCoordinateTransformation
-	 * with `GetCRSTransformer`and use this instead. */
+	/* Transformations between coordinate systems are cached by TransformRegistry, so this function is cheap
+	 * after its first call for `FromCRS`. */
 	bool GetUnrealCoordinatesFromCRS(double Longitude, double Latitude, FString FromCRS, FVector2D &XY);
 	
-	OGRCoordinateTransformation *GetCRSTransformer(FString FromCRS);
+	/* A transformation from `FromCRS` to `CRS`, to be used from the calling thread only */
+	TransformRegistry::FTransformRef GetCRSTransformer(FString FromCRS);
 	void GetCRSCoordinatesFromUnrealLocation(FVector2D Location, FVector2D& OutCoordinates);
 	void GetUnrealCoordinatesFromCRS(double Longitude, double Latitude, FVector2D &XY);
 	bool GetCRSCoordinatesFromUnrealLocation(FVector2D Location, FString ToCRS, FVector2D& OutCoordinates);
@@ -68,4 +84,11 @@ public:
 	bool GetLandscapeCRSBounds(ALandscape *Landscape, FVector4d &OutCoordinates);
 	bool GetActorCRSBounds(AActor *Actor, FString ToCRS, FVector4d &OutCoordinates);
 	bool GetActorCRSBounds(AActor *Actor, FVector4d &OutCoordinates);
+
+	/* Batch versions, converting many points in place in one call (in parallel for large arrays),
+	 * with exactly the same results as the single-point versions */
+	bool GetUnrealCoordinatesFromCRS(TArrayView<FVector2D> Points, FString FromCRS);
+	bool GetCRSCoordinatesFromUnrealLocations(TArrayView<FVector2D> Locations, FString ToCRS);
+
+	FGlobalCoordinatesSnapshot GetSnapshot() const;
 };
@@ -23,7 +23,7 @@ public:
 
 	static TObjectPtr<UGlobalCoordinates> GetGlobalCoordinates(UWorld *World, bool bShowDialog = true);
 	
-	static OGRCoordinateTransformation *GetCRSTransformer(UWorld *World, FString CRS);
+	static TransformRegistry::FTransformRef GetCRSTransformer(UWorld *World, FString CRS);
 	static bool GetUnrealCoordinatesFromCRS(UWorld *World, double Longitude, double Latitude, FString CRS, FVector2D &OutXY);
 	static bool GetCRSCoordinatesFromUnrealLocation(UWorld* World, FVector2D Location, FVector2D& OutCoordinates);
 	static bool GetCRSCoordinatesFromUnrealLocation(UWorld* World, FVector2D Location, FString CRS, FVector2D& OutCoordinates);
@@ -35,6 +35,8 @@ public:
 	static bool GetActorCRSBounds(AActor* Actor, FString CRS, FVector4d &OutCoordinates);
 	static bool GetLandscapeCRSBounds(ALandscape* Landscape, FVector4d &OutCoordinates);
 	static bool GetActorCRSBounds(AActor* Actor, FVector4d &OutCoordinates);
+	static bool GetUnrealCoordinatesFromCRS(UWorld* World, TArrayView<FVector2D> Points, FString CRS);
+	static bool GetCRSCoordinatesFromUnrealLocations(UWorld* World, TArrayView<FVector2D> Locations, FString CRS);
 	
 	UPROPERTY(
 		EditAnywhere, Category = "LevelCoordinates | WorldMap",
@@ -14,7 +14,8 @@ public class FileDownloader : ModuleRules
         PublicDependencyModuleNames.AddRange(
 			new string[]
 			{
-				"Core"
+				"Core",
+				"HTTP"
 			}
 		);
 
@@ -26,7 +27,6 @@ public class FileDownloader : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
-				"HTTP",
 				"ConcurrencyHelpers"
 			}
 		);
@@ -1,199 +1,351 @@
 // Copyright 2023 LandscapeCombinator. All Rights Reserved.
 
 #include "FileDownloader/Download.h"
+#include "FileDownloader/DownloadCache.h"
+#include "FileDownloader/DownloadProgress.h"
+#include "FileDownloader/DownloadProgressWindow.h"
 #include "FileDownloader/LogFileDownloader.h"
-#include "FileDownloader/FileDownloaderStyle.h"
+#include "FileDownloader/PartFileWriter.h"
+#include "FileDownloader/HostLimiter.h"
+#include "FileDownloader/StreamingSHA256.h"
 
 #include "ConcurrencyHelpers/Concurrency.h"
 
 #include "Async/Async.h"
 #include "Http.h"
-#include "Misc/FileHelper.h"
 #include "HAL/PlatformFileManager.h" 
-#include "Widgets/Notifications/SProgressBar.h"
-#include "Misc/ScopedSlowTask.h"
+#include "Misc/CommandLine.h"
+#include "Misc/MessageDialog.h"
+#include "Misc/Parse.h"
+#include "Misc/ScopeLock.h"
+
+#include <atomic>
 
 
 #define LOCTEXT_NAMESPACE "FLandscapeCombinatorModule"
 
-float SleepSeconds = 0.05;
-float TimeoutSeconds = 10;
-TMap<FString, int> ExpectedSizeCache; 
+// Whether `File` can be used without downloading it again
+bool IsAlreadyDownloaded(FString URL, FString File, int64 ExpectedSize)
+{
+	FDownloadCacheEntry Entry;
+	if (DownloadCache::Find(URL, Entry))
+	{
+		return DownloadCache::IsValid(URL, File);
+	}
+
+	// file downloaded before the cache knew about it: we can only trust its size
+	IPlatformFile &PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (ExpectedSize != 0 && PlatformFile.FileExists(*File))
+	{
+		int64 FileSize = PlatformFile.FileSize(*File);
+		if (FileSize == ExpectedSize)
+		{
+			DownloadCache::Record(URL, File, FStreamingSHA256::HashFile(File), FileSize, "", "");
+			return true;
+		}
+		UE_LOG(LogFileDownloader, Log, TEXT("File already exists with size %lld but the expected size is %lld. Redownloading"), FileSize, ExpectedSize);
+	}
+
+	return false;
+}
+
+// Ask the server to answer 304 Not Modified if our copy of an expired entry is still up to date
+void AddConditionalHeaders(TSharedRef<IHttpRequest> Request, FString URL, FString File)
+{
+	FDownloadCacheEntry Entry;
+	if (!DownloadCache::Find(URL, Entry) || !Entry.IsExpired()) return;
+	if (Entry.ETag.IsEmpty() && Entry.LastModified.IsEmpty()) return;
+	if (FStreamingSHA256::HashFile(File) != Entry.SHA256) return;
+
+	if (!Entry.ETag.IsEmpty()) Request->SetHeader("If-None-Match", Entry.ETag);
+	if (!Entry.LastModified.IsEmpty()) Request->SetHeader("If-Modified-Since", Entry.LastModified);
+}
+
+// Streams the body of a GET `Request` to `File`.part instead of keeping it in memory
+TSharedRef<FPartFileWriter> PrepareStreaming(TSharedRef<IHttpRequest> Request, FString URL, FString File)
+{
+	TSharedRef<FPartFileWriter> Writer = MakeShared<FPartFileWriter>(File);
+	Writer->Prepare(Request);
+	if (!Request->SetResponseBodyReceiveStream(Writer))
+	{
+		UE_LOG(LogFileDownloader, Error, TEXT("Could not stream the download of '%s' to '%s'"), *URL, *File);
+	}
+	return Writer;
+}
 
-FString Shorten(FString Input)
+// Moves the streamed part file to `File` and records it in the download cache
+bool FinishStreaming(FString URL, FString File, TSharedRef<FPartFileWriter> Writer, FHttpResponsePtr Response)
 {
-	if (Input.Len() > 83)
+	if (Response->GetResponseCode() == EHttpResponseCodes::NotModified)
 	{
-		return Input.Left(40) + "..." + Input.Right(40);
+		UE_LOG(LogFileDownloader, Log, TEXT("'%s' was not modified since it was downloaded to '%s'"), *URL, *File);
+		Writer->Fail(Response);
+		DownloadCache::Refresh(URL);
+		return true;
 	}
-	else
+
+	if (!Writer->Finish(Response))
 	{
-		return Input;
+		UE_LOG(LogFileDownloader, Error, TEXT("Error while saving '%s' to '%s'"), *URL, *File);
+		return false;
 	}
+
+	DownloadCache::Record(URL, File, Writer->GetSHA256(), Writer->GetFileSize(), Response->GetHeader("ETag"), Response->GetHeader("Last-Modified"));
+	UE_LOG(LogFileDownloader, Log, TEXT("Finished downloading '%s' to '%s'"), *URL, *File);
+	return true;
 }
 
-// FIXME: use TAtomic<bool> for bTriggered, but with TAtomic<bool> bTriggered { false}, everything blocks
-// We use bTriggered to avoid OnProcessRequestComplete being invoked multiple times
+bool IsSuccessfulResponse(bool bWasSuccessful, FHttpResponsePtr Response)
+{
+	return
+		bWasSuccessful && Response.IsValid() &&
+		(EHttpResponseCodes::IsOk(Response->GetResponseCode()) || Response->GetResponseCode() == EHttpResponseCodes::NotModified);
+}
 
-bool Download::SynchronousFromURL(FString URL, FString File)
+// State shared by the successive attempts of one download
+struct FDownloadState
 {
-	UE_LOG(LogFileDownloader, Log, TEXT("Downloading '%s' to '%s'"), *URL, *File);
+	FString URL;
+	FString File;
+	int32 ProgressId = -1;
+	int32 Attempt = 0;
+	std::atomic<bool> bCancelled { false };
+
+	FCriticalSection RequestLock;
+	FHttpRequestPtr Request;
 
-	if (ExpectedSizeCache.Contains(URL))
+	void Cancel()
 	{
-		UE_LOG(LogFileDownloader, Log, TEXT("Cache says expected size for '%s' is '%d'"), *URL, ExpectedSizeCache[URL]);
-		return SynchronousFromURLExpecting(URL, File, ExpectedSizeCache[URL]);
+		bCancelled = true;
+		FScopeLock ScopeLock(&RequestLock);
+		if (Request.IsValid()) Request->CancelRequest();
 	}
-	else
+};
+
+// Sends the GET request when the host limiter allows it, and retries according to Download::RetryPolicy.
+// Request completion and file IO happen on HTTP and pool threads; `OnDone` is called from one of them.
+void SendWithRetries(TSharedRef<FDownloadState, ESPMode::ThreadSafe> State, TFunction<void(bool)> OnDone)
+{
+	HostLimiter::Acquire(State->URL, [State, OnDone]()
 	{
-		TSharedRef<IHttpRequest> Request = FHttpModule::Get().CreateRequest();
-		Request->SetURL(URL);
-		Request->SetVerb("HEAD");
-		Request->SetHeader("User-Agent", "X-UnrealEngine-Agent");
+		// the limiter may call us from an HTTP thread, and AddConditionalHeaders can hash a file
+		FTaskPool::Get().Submit([State, OnDone]()
+		{
+			if (State->bCancelled)
+			{
+				HostLimiter::Release(State->URL);
+				OnDone(false);
+				return;
+			}
+
+			State->Attempt++;
+
+			TSharedRef<IHttpRequest> Request = FHttpModule::Get().CreateRequest();
+			Request->SetURL(Download::Redirect(State->URL));
+			Request->SetVerb("GET");
+			Request->SetHeader("User-Agent", "X-UnrealEngine-Agent");
+			Request->SetDelegateThreadPolicy(EHttpRequestDelegateThreadPolicy::CompleteOnHttpThread);
+			AddConditionalHeaders(Request, State->URL, State->File);
+			TSharedRef<FPartFileWriter> Writer = PrepareStreaming(Request, State->URL, State->File);
+			Request->OnRequestProgress().BindLambda([State, Writer](FHttpRequestPtr Request, int32 Sent, int32 Received) {
+				// when resuming, the bytes of the part file count as already downloaded
+				DownloadProgress::Update(State->ProgressId, Writer->GetStartOffset() + Received);
+			});
+			TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> bTriggered = MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+			Request->OnProcessRequestComplete().BindLambda([State, Writer, OnDone, bTriggered](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+			{
+				if (bTriggered->exchange(true)) return;
+
+				HostLimiter::Release(State->URL);
+
+				// renaming the part file and updating the cache manifest do not belong on the HTTP thread
+				FTaskPool::Get().Submit([State, Writer, OnDone, Response, bWasSuccessful]()
+				{
+					bool bRetryable;
+					if (IsSuccessfulResponse(bWasSuccessful, Response))
+					{
+						if (FinishStreaming(State->URL, State->File, Writer, Response))
+						{
+							OnDone(true);
+							return;
+						}
+						// a truncated body can be resumed from the part file
+						bRetryable = true;
+					}
+					else
+					{
+						Writer->Fail(Response);
+						bRetryable = Download::RetryPolicy.IsRetryable(bWasSuccessful, Response);
+					}
+
+					int32 Code = Response.IsValid() ? Response->GetResponseCode() : 0;
+					float Delay = bRetryable && !State->bCancelled ? Download::RetryPolicy.GetDelay(State->Attempt, Response) : -1;
+					if (Delay >= 0)
+					{
+						UE_LOG(LogFileDownloader, Warning, TEXT("Attempt %d to download '%s' failed (error %d), retrying in %.1f seconds"), State->Attempt, *State->URL, Code, Delay);
+
+						// the server asked everyone to slow down, not only this request
+						if (FRetryPolicy::GetRetryAfter(Response) >= 0) HostLimiter::Backoff(State->URL, Delay);
+
+						HostLimiter::RunAfter(Delay, [State, OnDone]() { SendWithRetries(State, OnDone); });
+						return;
+					}
+
+					UE_LOG(LogFileDownloader, Error, TEXT("Error while downloading '%s' to '%s'"), *State->URL, *State->File);
+					if (Response.IsValid())
+					{
+						UE_LOG(LogFileDownloader, Error, TEXT("Request was not successful after %d attempts. Error %d."), State->Attempt, Code);
+					}
+					OnDone(false);
+				});
+			});
 
-		bool bIsComplete = false;
-		int32 ExpectedSize = 0;
-		
-		bool *bTriggered = new bool(false);
-		Request->OnProcessRequestComplete().BindLambda([URL, File, &ExpectedSize, &bIsComplete, bTriggered](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
-			if (*bTriggered) return;
-			*bTriggered = true;
-			if (bWasSuccessful && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode()))
 			{
-				ExpectedSize = FCString::Atoi(*Response->GetHeader("Content-Length"));
+				FScopeLock ScopeLock(&State->RequestLock);
+				State->Request = Request;
 			}
-			bIsComplete = true;
+			// the download may have been cancelled while we were preparing the request
+			if (State->bCancelled) Request->CancelRequest();
+			Request->ProcessRequest();
 		});
-		Request->ProcessRequest();
+	});
+}
 
-		float StartTime = FPlatformTime::Seconds();
-		UE_LOG(LogFileDownloader, Log, TEXT("Actively waiting for Content-Length request to complete"));
-		while (!bIsComplete && FPlatformTime::Seconds() - StartTime <= TimeoutSeconds)
-		{
-			FPlatformProcess::Sleep(SleepSeconds);
-		}
-		UE_LOG(LogFileDownloader, Log, TEXT("Finished waiting for Content-Length request to complete"));
+// Downloads `URL` to `File` without using the game thread, and reports to DownloadProgress.
+// `OnDone` is called from an HTTP or pool thread.
+void DownloadInBackground(FString URL, FString File, int64 ExpectedSize, TFunction<void(bool)> OnDone)
+{
+	TSharedRef<FDownloadState, ESPMode::ThreadSafe> State = MakeShared<FDownloadState, ESPMode::ThreadSafe>();
+	State->URL = URL;
+	State->File = File;
+	State->ProgressId = DownloadProgress::Begin(URL, ExpectedSize, [State]() { State->Cancel(); });
 
-		Request->CancelRequest();
+	TFunction<void(bool)> OnDoneWithProgress = [State, OnDone](bool bSuccess)
+	{
+		DownloadProgress::End(State->ProgressId, bSuccess);
+		if (OnDone) OnDone(bSuccess);
+	};
+
+	// checking the cache may hash the file
+	Concurrency::RunOne(
+		[URL, File, ExpectedSize]() { return IsAlreadyDownloaded(URL, File, ExpectedSize); },
+		[State, OnDoneWithProgress](bool bAlreadyDownloaded)
+		{
+			if (bAlreadyDownloaded)
+			{
+				UE_LOG(LogFileDownloader, Log, TEXT("File already exists with the correct content, skipping download of '%s' to '%s' "), *State->URL, *State->File);
+				OnDoneWithProgress(true);
+				return;
+			}
 
-		return SynchronousFromURLExpecting(URL, File, ExpectedSize);
-	}
+			SendWithRetries(State, OnDoneWithProgress);
+		}
+	);
 }
 
-bool Download::SynchronousFromURLExpecting(FString URL, FString File, int32 ExpectedSize)
+// Calls `OnExpectedSize` with the size of `URL` according to the cache or to a HEAD request (0 if unknown),
+// from an HTTP or pool thread
+void FetchExpectedSize(FString URL, TFunction<void(int64)> OnExpectedSize)
 {
-	IPlatformFile &PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-	if (PlatformFile.FileExists(*File) && ExpectedSize != 0 && PlatformFile.FileSize(*File) == ExpectedSize)
+	FDownloadCacheEntry Entry;
+	if (DownloadCache::Find(URL, Entry))
 	{
-		UE_LOG(LogFileDownloader, Log, TEXT("File already exists with the correct size, skipping download of '%s' to '%s' "), *URL, *File);
-		return true;
+		UE_LOG(LogFileDownloader, Log, TEXT("Cache says expected size for '%s' is '%lld'"), *URL, Entry.Size);
+		OnExpectedSize(Entry.Size);
+		return;
 	}
 
-	bool bDownloadResult = false;
-	bool bIsComplete = false;
-
+	UE_LOG(LogFileDownloader, Log, TEXT("No cache for '%s'"), *URL);
 	TSharedRef<IHttpRequest> Request = FHttpModule::Get().CreateRequest();
-	Request->SetURL(URL);
-	Request->SetVerb("GET");
+	Request->SetURL(Download::Redirect(URL));
+	Request->SetVerb("HEAD");
 	Request->SetHeader("User-Agent", "X-UnrealEngine-Agent");
-	bool *bTriggered = new bool(false);
-	Request->OnProcessRequestComplete().BindLambda([URL, File, &bDownloadResult, &bIsComplete, bTriggered](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
-	{
-		if (*bTriggered) return;
-		*bTriggered = true;
-		IPlatformFile &PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-		bool DownloadSuccess = bWasSuccessful && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode());
-		bool SavedFile = false;
-		if (DownloadSuccess)
-		{
-			SavedFile = FFileHelper::SaveArrayToFile(Response->GetContent(), *File);
-			if (SavedFile)
-			{
-				AddExpectedSize(URL, PlatformFile.FileSize(*File));
-				bDownloadResult = true;
-				bIsComplete = true;
+	Request->SetDelegateThreadPolicy(EHttpRequestDelegateThreadPolicy::CompleteOnHttpThread);
+	TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> bTriggered = MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+	Request->OnProcessRequestComplete().BindLambda([URL, OnExpectedSize, bTriggered](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
+		if (bTriggered->exchange(true)) return;
 
-				UE_LOG(LogFileDownloader, Log, TEXT("Finished downloading '%s' to '%s'"), *URL, *File);
-			}
-			else
-			{
-				bDownloadResult = false;
-				bIsComplete = true;
-				UE_LOG(LogFileDownloader, Error, TEXT("Error while saving '%s' to '%s'"), *URL, *File);
-			}
+		HostLimiter::Release(URL);
+
+		if (bWasSuccessful && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+		{
+			OnExpectedSize(FCString::Atoi64(*Response->GetHeader("Content-Length")));
 		}
 		else
 		{
-			UE_LOG(LogFileDownloader, Error, TEXT("Error while downloading '%s' to '%s'"), *URL, *File);
-			UE_LOG(LogFileDownloader, Error, TEXT("Request was not successful. Error %d."), Response->GetResponseCode());
-			bDownloadResult = false;
-			bIsComplete = true;
+			OnExpectedSize(0);
 		}
 	});
-	Request->ProcessRequest();
-		
+	HostLimiter::Acquire(URL, [Request]() { Request->ProcessRequest(); });
+}
 
-	float StartTime = FPlatformTime::Seconds();
-	UE_LOG(LogFileDownloader, Log, TEXT("Actively waiting for download to complete"));
-	while (!bIsComplete && FPlatformTime::Seconds() - StartTime <= TimeoutSeconds)
+// Calls `OnComplete` on the game thread, as callers expect
+TFunction<void(bool)> OnGameThread(TFunction<void(bool)> OnComplete)
+{
+	return [OnComplete](bool bSuccess)
 	{
-		FPlatformProcess::Sleep(SleepSeconds);
-	}
-	UE_LOG(LogFileDownloader, Log, TEXT("Finished waiting for download to complete"));
-		
-	Request->CancelRequest();
+		if (!OnComplete) return;
+		AsyncTask(ENamedThreads::GameThread, [OnComplete, bSuccess]() { OnComplete(bSuccess); });
+	};
+}
 
-	return bDownloadResult;
+TFunction<void(bool)> Download::TrackInFlight(TFunction<void(bool)> OnComplete)
+{
+	InFlight++;
+	return [OnComplete](bool bSuccess)
+	{
+		if (OnComplete) OnComplete(bSuccess);
+		InFlight--;
+	};
 }
 
-void Download::FromURL(FString URL, FString File, bool bProgress, TFunction<void(bool)> OnComplete)
+bool Download::SynchronousFromURL(FString URL, FString File)
 {
-	UE_LOG(LogFileDownloader, Log, TEXT("Downloading from URL '%s' to '%s'"), *URL, *File);
+	UE_LOG(LogFileDownloader, Log, TEXT("Downloading '%s' to '%s'"), *URL, *File);
 
-	if (ExpectedSizeCache.Contains(URL))
-	{
-		UE_LOG(LogFileDownloader, Log, TEXT("Cache says expected size for '%s' is '%d'"), *URL, ExpectedSizeCache[URL]);
-		FromURLExpecting(URL, File, bProgress, ExpectedSizeCache[URL], OnComplete);
-	}
-	else
-	{
-		UE_LOG(LogFileDownloader, Log, TEXT("No cache for '%s'"), *URL);
-		TSharedRef<IHttpRequest> Request = FHttpModule::Get().CreateRequest();
-		Request->SetURL(URL);
-		Request->SetVerb("HEAD");
-		Request->SetHeader("User-Agent", "X-UnrealEngine-Agent");
-		bool *bTriggered = new bool(false);
+	return Concurrency::Wait(
+		[URL, File](TFunction<void(bool)> OnDone0)
+		{
+			TFunction<void(bool)> OnDone = TrackInFlight(OnDone0);
+			FetchExpectedSize(URL, [URL, File, OnDone](int64 ExpectedSize)
+			{
+				DownloadInBackground(URL, File, ExpectedSize, OnDone);
+			});
+		},
+		SynchronousTimeoutSeconds
+	);
+}
 
-		FScopedSlowTask* Task;
+bool Download::SynchronousFromURLExpecting(FString URL, FString File, int32 ExpectedSize)
+{
+	UE_LOG(LogFileDownloader, Log, TEXT("Downloading '%s' to '%s'"), *URL, *File);
 
-		if (bProgress)
+	return Concurrency::Wait(
+		[URL, File, ExpectedSize](TFunction<void(bool)> OnDone)
 		{
-			Task = new FScopedSlowTask(0, LOCTEXT("Download::FromURL", "Fetching Content Length from URL"));
-			Task->MakeDialog();
-		}
+			DownloadInBackground(URL, File, ExpectedSize, TrackInFlight(OnDone));
+		},
+		SynchronousTimeoutSeconds
+	);
+}
 
-		Request->OnProcessRequestComplete().BindLambda([Task, bProgress, URL, File, OnComplete, bTriggered](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
-			if (*bTriggered) return;
-			*bTriggered = true;
+void Download::FromURL(FString URL, FString File, bool bProgress, TFunction<void(bool)> OnComplete)
+{
+	UE_LOG(LogFileDownloader, Log, TEXT("Downloading from URL '%s' to '%s'"), *URL, *File);
 
-			if (bProgress)
-			{
-				Task->Destroy();
-			}
+	// the HEAD request may take a while, and the download is not known to DownloadProgress until it is done
+	TFunction<void(bool)> OnCompleteInFlight = TrackInFlight(OnComplete);
+	FetchExpectedSize(URL, [URL, File, bProgress, OnCompleteInFlight](int64 ExpectedSize)
+	{
+		FromURLExpecting(URL, File, bProgress, ExpectedSize, OnCompleteInFlight);
+	});
+}
 
-			if (bWasSuccessful && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode()))
-			{
-				int64 ExpectedSize = FCString::Atoi64(*Response->GetHeader("Content-Length"));
-				FromURLExpecting(URL, File, bProgress, ExpectedSize, OnComplete);
-			}
-			else
-			{
-				FromURLExpecting(URL, File, bProgress, 0, OnComplete);
-			}
-		});
-		Request->ProcessRequest();
-	}
+void Download::FromURLExpecting(FString URL, FString File, bool bProgress, int64 ExpectedSize, TFunction<void(bool)> OnComplete)
+{
+	DownloadInBackground(URL, File, ExpectedSize, OnGameThread(TrackInFlight(OnComplete)));
 
+	if (bProgress) FDownloadProgressWindow::Open();
 }
 
 void Download::DownloadMany(TArray<FString> URLs, FString Directory, TFunction<void(TArray<FString>)> OnComplete)
@@ -244,192 +396,66 @@ void Download::DownloadMany(TArray<FString> URLs, TArray<FString> Files, TFuncti
 			{
 				if (OnComplete) OnComplete(TArray<FString>());
 			}
-		}
+		},
+		Concurrency::MaxIOParallelism
 	);
 }
-
-void Download::FromURLExpecting(FString URL, FString File, bool bProgress, int64 ExpectedSize, TFunction<void(bool)> OnComplete)
+void Download::AddRedirect(FString Prefix, FString Replacement)
 {
-	// make sure we are in game thread to spawn download progress windows
-	AsyncTask(ENamedThreads::GameThread, [=]()
-	{
-		double *Downloaded = new double();
-
-		IPlatformFile &PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-
-		if (ExpectedSize != 0 && PlatformFile.FileExists(*File))
-		{
-			int64 FileSize = PlatformFile.FileSize(*File);
-			if (FileSize == ExpectedSize)
-			{
-				UE_LOG(LogFileDownloader, Log, TEXT("File already exists with the correct size, skipping download of '%s' to '%s' "), *URL, *File);
-				if (OnComplete) OnComplete(true);
-				return;
-			}
-			else
-			{
-				UE_LOG(LogFileDownloader, Log, TEXT("File already exists with size %ld but the expected size is %ld. Redownloading"), FileSize, ExpectedSize);
-			}
-		}
-
-		TSharedPtr<SWindow> Window;
-		
-		if (bProgress)
-		{
-			Window = SNew(SWindow)
-				.SizingRule(ESizingRule::Autosized)
-				.AutoCenter(EAutoCenter::PrimaryWorkArea)
-				.Title(LOCTEXT("DownloadProgress", "Download Progress"));
-		}
-
-		TSharedPtr<IHttpRequest> Request = FHttpModule::Get().CreateRequest().ToSharedPtr();
-		Request->SetURL(URL);
-		Request->SetVerb("GET");
-		Request->SetHeader("User-Agent", "X-UnrealEngine-Agent");
-		Request->OnRequestProgress().BindLambda([Downloaded](FHttpRequestPtr Request, int32 Sent, int32 Received) {
-			*Downloaded = Received;
-		});
-		bool *bTriggered = new bool(false);
-		Request->OnProcessRequestComplete().BindLambda([URL, File, OnComplete, Window, bTriggered, bProgress](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
-		{
-			if (*bTriggered) return;
-			*bTriggered = true;
-
-			IPlatformFile &PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-			bool DownloadSuccess = bWasSuccessful && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode());
-			bool SavedFile = false;
-			if (DownloadSuccess)
-			{
-				SavedFile = FFileHelper::SaveArrayToFile(Response->GetContent(), *File);
-				if (SavedFile)
-				{
-					AddExpectedSize(URL, PlatformFile.FileSize(*File));
-					UE_LOG(LogFileDownloader, Log, TEXT("Finished downloading '%s' to '%s'"), *URL, *File);
-				}
-				else
-				{
-					UE_LOG(LogFileDownloader, Error, TEXT("Error while saving '%s' to '%s'"), *URL, *File);
-				}
-			}
-			else
-			{
-				UE_LOG(LogFileDownloader, Error, TEXT("Error while downloading '%s' to '%s'"), *URL, *File);
-				if (Response.IsValid())
-				{
-					UE_LOG(LogFileDownloader, Error, TEXT("Request was not successful. Error %d."), Response->GetResponseCode());
-				}
-			}
-			
-			if (bProgress)
-			{
-				Window->RequestDestroyWindow();
-			}
-
-			if (OnComplete) OnComplete(DownloadSuccess && SavedFile);
-		});
-
-
-		Request->ProcessRequest();
-
-		if (bProgress)
-		{
-			Window->SetContent(
-				SNew(SBox).Padding(FMargin(30, 30, 30, 30))
-				[
-					SNew(SVerticalBox)
-						+SVerticalBox::Slot().AutoHeight()
-						[
-							SNew(STextBlock).Text(
-								FText::Format(
-									LOCTEXT("DowloadingURL", "Dowloading {0} to {1}."),
-									FText::FromString(Shorten(URL)),
-									FText::FromString(Shorten(File))
-								)
-							).Font(FFileDownloaderStyle::RegularFont())
-						]
-						+SVerticalBox::Slot().AutoHeight().Padding(FMargin(0, 0, 0, 20))
-						[
-							SNew(SProgressBar)
-								.Percent_Lambda([Downloaded, ExpectedSize, Request]() {
-								if (ExpectedSize) return *Downloaded / ExpectedSize;
-								return *Downloaded / MAX_int32;
-									})
-								.RefreshRate(0.1)
-						]
-						+SVerticalBox::Slot().AutoHeight().HAlign(EHorizontalAlignment::HAlign_Center)
-						[
-							SNew(SHorizontalBox)
-								+ SHorizontalBox::Slot().AutoWidth().HAlign(EHorizontalAlignment::HAlign_Center)
-								[
-									SNew(SButton)
-										.OnClicked_Lambda([Window, Request]()->FReply {
-										Request->CancelRequest();
-										Window->RequestDestroyWindow();
-										return FReply::Handled();
-											})
-										[
-											SNew(STextBlock).Font(FFileDownloaderStyle::RegularFont()).Text(FText::FromString(" Cancel "))
-										]
-								]
-						]
-				]
-			);
-
-			Window->SetOnWindowClosed(FOnWindowClosed::CreateLambda([Request](const TSharedRef<SWindow>& Window) {
-				Request->CancelRequest();
-			}));
-
-			FSlateApplication::Get().AddWindow(Window.ToSharedRef());
-		}
-
-
-		if (bProgress && Request->GetStatus() != EHttpRequestStatus::Processing)
-		{
-			Window->RequestDestroyWindow();
-		}
-	});
+	UE_LOG(LogFileDownloader, Log, TEXT("Redirecting downloads from '%s' to '%s'"), *Prefix, *Replacement);
+	FScopeLock ScopeLock(&RedirectsLock);
+	Redirects.Add({ Prefix, Replacement });
 }
 
-void Download::AddExpectedSize(FString URL, int32 ExpectedSize)
+void Download::RemoveRedirect(FString Prefix)
 {
-	if (!ExpectedSizeCache.Contains(URL))
-	{
-		ExpectedSizeCache.Add(URL, ExpectedSize);
-		SaveExpectedSizeCache();
-	}
+	FScopeLock ScopeLock(&RedirectsLock);
+	Redirects.RemoveAll([&Prefix](const TPair<FString, FString>& Redirect) { return Redirect.Key == Prefix; });
 }
 
-FString Download::ExpectedSizeCacheFile()
+void Download::ClearRedirects()
 {
-	IPlatformFile::GetPlatformPhysical().CreateDirectory(*FPaths::ProjectSavedDir());
-	return FPaths::Combine(FPaths::ProjectSavedDir(), "ExpectedSizeCache"); 
+	FScopeLock ScopeLock(&RedirectsLock);
+	Redirects.Empty();
 }
 
-void Download::LoadExpectedSizeCache()
+void Download::LoadRedirectsFromCommandLine()
 {
-	FString CacheFile = ExpectedSizeCacheFile();
-	//UE_LOG(LogFileDownloader, Log, TEXT("Loading expected size cache from '%s'"), *CacheFile);
-		
-	FArchive* FileReader = IFileManager::Get().CreateFileReader(*CacheFile);
-	if (FileReader)
+	FString Value;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("DownloadRedirect="), Value, false)) return;
+
+	TArray<FString> Pairs;
+	Value.ParseIntoArray(Pairs, TEXT(","));
+	for (auto& Pair : Pairs)
 	{
-		*FileReader << ExpectedSizeCache;
-		FileReader->Close();
+		FString Prefix, Replacement;
+		if (Pair.Split("|", &Prefix, &Replacement))
+		{
+			AddRedirect(Prefix, Replacement);
+		}
+		else
+		{
+			UE_LOG(LogFileDownloader, Error, TEXT("Invalid download redirect '%s', expected 'Prefix|Replacement'"), *Pair);
+		}
 	}
 }
 
-void Download::SaveExpectedSizeCache()
+FString Download::Redirect(FString URL)
 {
-	FString CacheFile = ExpectedSizeCacheFile();
-	//UE_LOG(LogFileDownloader, Log, TEXT("Saving expected size cache to '%s'"), *CacheFile);
-	FArchive* FileWriter = IFileManager::Get().CreateFileWriter(*CacheFile);
-	if (FileWriter)
+	FScopeLock ScopeLock(&RedirectsLock);
+
+	// the longest matching prefix wins
+	int32 Best = -1;
+	for (int32 i = 0; i < Redirects.Num(); i++)
 	{
-		*FileWriter << ExpectedSizeCache;
-		if (FileWriter->Close()) return;
+		if (URL.StartsWith(Redirects[i].Key) && (Best == -1 || Redirects[i].Key.Len() > Redirects[Best].Key.Len()))
+		{
+			Best = i;
+		}
 	}
 
-	UE_LOG(LogFileDownloader, Error, TEXT("Failed to save expected size cache to '%s'"), *CacheFile);
+	if (Best == -1) return URL;
+	return Redirects[Best].Value + URL.RightChop(Redirects[Best].Key.Len());
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,181 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "FileDownloader/DownloadCache.h"
+#include "FileDownloader/LogFileDownloader.h"
+#include "FileDownloader/StreamingSHA256.h"
+
+#include "ConcurrencyHelpers/AppendOnlyManifest.h"
+
+#include "HAL/PlatformFileManager.h"
+#include "Misc/ScopeLock.h"
+
+#define LOCTEXT_NAMESPACE "FFileDownloaderModule"
+
+bool FDownloadCacheEntry::IsExpired() const
+{
+	return TTLSeconds > 0 && FDateTime::UtcNow().ToUnixTimestamp() > FetchTime + TTLSeconds;
+}
+
+bool DownloadCache::IsValid(FString URL, FString File)
+{
+	FDownloadCacheEntry Entry;
+	{
+		FScopeLock ScopeLock(&Lock);
+		FDownloadCacheEntry *Found = Entries.Find(URL);
+		if (!Found) return false;
+		Entry = *Found;
+	}
+
+	if (Entry.IsExpired())
+	{
+		UE_LOG(LogFileDownloader, Log, TEXT("Cache entry for '%s' has expired"), *URL);
+		return false;
+	}
+
+	// the size check is only there to notice files that were deleted or replaced behind our back
+	int64 FileSize = FPlatformFileManager::Get().GetPlatformFile().FileSize(*File);
+	if (FileSize != Entry.Size)
+	{
+		if (FileSize >= 0)
+		{
+			UE_LOG(LogFileDownloader, Warning, TEXT("File '%s' has size %lld but %lld bytes were downloaded from '%s'"), *File, FileSize, Entry.Size, *URL);
+		}
+		return false;
+	}
+
+	if (Entry.bVerified && Entry.File == File) return true;
+
+	FString SHA256 = FStreamingSHA256::HashFile(File);
+	if (SHA256 != Entry.SHA256)
+	{
+		UE_LOG(LogFileDownloader, Warning, TEXT("File '%s' is corrupted (SHA-256 %s, expected %s)"), *File, *SHA256, *Entry.SHA256);
+		return false;
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	if (FDownloadCacheEntry *Found = Entries.Find(URL))
+	{
+		Found->File = File;
+		Found->bVerified = true;
+	}
+	return true;
+}
+
+bool DownloadCache::Find(FString URL, FDownloadCacheEntry& OutEntry)
+{
+	FScopeLock ScopeLock(&Lock);
+	FDownloadCacheEntry *Found = Entries.Find(URL);
+	if (!Found) return false;
+
+	OutEntry = *Found;
+	return true;
+}
+
+void DownloadCache::Record(FString URL, FString File, FString SHA256, int64 Size, FString ETag, FString LastModified, int64 TTLSeconds)
+{
+	FDownloadCacheEntry Entry;
+	Entry.URL = URL;
+	Entry.File = File;
+	Entry.Size = Size;
+	Entry.SHA256 = SHA256;
+	Entry.ETag = ETag;
+	Entry.LastModified = LastModified;
+	Entry.FetchTime = FDateTime::UtcNow().ToUnixTimestamp();
+	Entry.TTLSeconds = TTLSeconds > 0 ? TTLSeconds : DefaultTTLSeconds;
+	Entry.bVerified = true;
+
+	FScopeLock ScopeLock(&Lock);
+	Entries.Add(URL, Entry);
+	Manifest().Add(URL, ToFields(Entry));
+}
+
+void DownloadCache::Refresh(FString URL)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (FDownloadCacheEntry *Found = Entries.Find(URL))
+	{
+		Found->FetchTime = FDateTime::UtcNow().ToUnixTimestamp();
+		Manifest().Add(URL, ToFields(*Found));
+	}
+}
+
+void DownloadCache::Remove(FString URL)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (Entries.Remove(URL) > 0)
+	{
+		Manifest().Remove(URL);
+	}
+}
+
+FAppendOnlyManifest& DownloadCache::Manifest()
+{
+	static FAppendOnlyManifest Manifest(
+		"download cache", "DownloadCache.manifest",
+		[]() { return Entries.Num(); },
+		[]()
+		{
+			TArray<FString> Lines;
+			for (auto& [URL, Entry] : Entries)
+			{
+				Lines.Add(FAppendOnlyManifest::MakeLine(URL, ToFields(Entry)));
+			}
+			return Lines;
+		}
+	);
+	return Manifest;
+}
+
+FString DownloadCache::ManifestFile()
+{
+	return Manifest().GetFile();
+}
+
+void DownloadCache::Load()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	Entries.Empty();
+	Manifest().Load(
+		[](const FString& URL, const TArray<FString>& Fields)
+		{
+			FDownloadCacheEntry Entry;
+			if (!FromFields(URL, Fields, Entry)) return false;
+			Entries.Add(URL, Entry);
+			return true;
+		},
+		[](const FString& URL) { Entries.Remove(URL); }
+	);
+	Manifest().Compact();
+}
+
+TArray<FString> DownloadCache::ToFields(const FDownloadCacheEntry& Entry)
+{
+	return {
+		Entry.File,
+		FString::Printf(TEXT("%lld"), Entry.Size),
+		Entry.SHA256,
+		Entry.ETag,
+		Entry.LastModified,
+		FString::Printf(TEXT("%lld"), Entry.FetchTime),
+		FString::Printf(TEXT("%lld"), Entry.TTLSeconds)
+	};
+}
+
+bool DownloadCache::FromFields(const FString& URL, const TArray<FString>& Fields, FDownloadCacheEntry& OutEntry)
+{
+	if (Fields.Num() != 7 || Fields[2].Len() != 64) return false;
+
+	OutEntry.URL = URL;
+	OutEntry.File = Fields[0];
+	OutEntry.Size = FCString::Atoi64(*Fields[1]);
+	OutEntry.SHA256 = Fields[2];
+	OutEntry.ETag = Fields[3];
+	OutEntry.LastModified = Fields[4];
+	OutEntry.FetchTime = FCString::Atoi64(*Fields[5]);
+	OutEntry.TTLSeconds = FCString::Atoi64(*Fields[6]);
+	OutEntry.bVerified = false;
+	return true;
+}
+
+#undef LOCTEXT_NAMESPACE
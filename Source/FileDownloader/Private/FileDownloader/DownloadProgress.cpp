@@ -0,0 +1,152 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "FileDownloader/DownloadProgress.h"
+
+#include "Async/Async.h"
+#include "Misc/ScopeLock.h"
+
+FOnDownloadProgress DownloadProgress::OnProgress;
+
+float FDownloadProgressSnapshot::GetFraction() const
+{
+	if (FilesTotal == 0) return 0;
+
+	bool bAllSizesKnown = BytesExpected > 0 && BytesReceived <= BytesExpected;
+	if (bAllSizesKnown) return (float) BytesReceived / BytesExpected;
+
+	return (float) (FilesSucceeded + FilesFailed) / FilesTotal;
+}
+
+int32 DownloadProgress::Begin(FString URL, int64 ExpectedSize, TFunction<void()> Cancel)
+{
+	bool bNewSession;
+	int32 Id;
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		bNewSession = Active.IsEmpty();
+		if (bNewSession)
+		{
+			Session = FDownloadProgressSnapshot();
+			SessionStart = FPlatformTime::Seconds();
+		}
+
+		Id = NextId++;
+		FFileProgress &File = Active.Add(Id);
+		File.URL = URL;
+		File.Expected = FMath::Max<int64>(0, ExpectedSize);
+		File.Cancel = Cancel;
+
+		Session.FilesTotal++;
+		Session.BytesExpected += File.Expected;
+	}
+
+	if (bNewSession)
+	{
+		AsyncTask(ENamedThreads::GameThread, []()
+		{
+			FScopeLock ScopeLock(&Lock);
+			if (!TickerHandle.IsValid())
+			{
+				TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&DownloadProgress::Broadcast), BroadcastPeriodSeconds);
+			}
+		});
+	}
+
+	return Id;
+}
+
+void DownloadProgress::Update(int32 Id, int64 Received)
+{
+	FScopeLock ScopeLock(&Lock);
+	FFileProgress *File = Active.Find(Id);
+	if (!File) return;
+
+	Session.BytesReceived += Received - File->Received;
+	TotalBytesReceived += Received - File->Received;
+	File->Received = Received;
+}
+
+void DownloadProgress::End(int32 Id, bool bSuccess)
+{
+	FScopeLock ScopeLock(&Lock);
+	FFileProgress File;
+	if (!Active.RemoveAndCopyValue(Id, File)) return;
+
+	if (bSuccess)
+	{
+		Session.FilesSucceeded++;
+		// the server may have sent more or less than announced, or nothing at all for files that were up to date
+		Session.BytesExpected += File.Received - File.Expected;
+	}
+	else
+	{
+		Session.FilesFailed++;
+		Session.BytesExpected -= File.Expected;
+		Session.BytesReceived -= File.Received;
+	}
+}
+
+void DownloadProgress::CancelAll()
+{
+	TArray<TFunction<void()>> Cancels;
+	{
+		FScopeLock ScopeLock(&Lock);
+		for (auto& [Id, File] : Active)
+		{
+			if (File.Cancel) Cancels.Add(File.Cancel);
+		}
+	}
+
+	// outside of the lock, as cancelling a download ends it
+	for (auto& Cancel : Cancels)
+	{
+		Cancel();
+	}
+}
+
+FDownloadProgressSnapshot DownloadProgress::GetSnapshot()
+{
+	FScopeLock ScopeLock(&Lock);
+	return GetSnapshotLocked();
+}
+
+int64 DownloadProgress::GetTotalBytesReceived()
+{
+	FScopeLock ScopeLock(&Lock);
+	return TotalBytesReceived;
+}
+
+FDownloadProgressSnapshot DownloadProgress::GetSnapshotLocked()
+{
+	FDownloadProgressSnapshot Snapshot = Session;
+	Snapshot.ElapsedSeconds = SessionStart > 0 ? FPlatformTime::Seconds() - SessionStart : 0;
+
+	if (Snapshot.ElapsedSeconds > 0)
+	{
+		Snapshot.BytesPerSecond = Snapshot.BytesReceived / Snapshot.ElapsedSeconds;
+	}
+
+	if (Snapshot.BytesPerSecond > 0 && Snapshot.BytesExpected >= Snapshot.BytesReceived)
+	{
+		Snapshot.ETASeconds = (Snapshot.BytesExpected - Snapshot.BytesReceived) / Snapshot.BytesPerSecond;
+	}
+
+	return Snapshot;
+}
+
+bool DownloadProgress::Broadcast(float DeltaTime)
+{
+	FDownloadProgressSnapshot Snapshot;
+	bool bSessionOver;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Snapshot = GetSnapshotLocked();
+		bSessionOver = Active.IsEmpty();
+		if (bSessionOver) TickerHandle.Reset();
+	}
+
+	OnProgress.Broadcast(Snapshot);
+
+	return !bSessionOver;
+}
@@ -0,0 +1,116 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "FileDownloader/DownloadProgressWindow.h"
+#include "FileDownloader/FileDownloaderStyle.h"
+
+#include "Async/Async.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Widgets/Notifications/SProgressBar.h"
+
+#define LOCTEXT_NAMESPACE "FFileDownloaderModule"
+
+void FDownloadProgressWindow::Open()
+{
+	if (IsInGameThread())
+	{
+		OpenOnGameThread();
+	}
+	else
+	{
+		AsyncTask(ENamedThreads::GameThread, []() { OpenOnGameThread(); });
+	}
+}
+
+void FDownloadProgressWindow::OpenOnGameThread()
+{
+	if (Window.IsValid() || IsRunningCommandlet() || !FSlateApplication::IsInitialized()) return;
+
+	// the downloads may all have finished before we got to the game thread
+	if (DownloadProgress::GetSnapshot().FilesActive() == 0) return;
+
+	Window = SNew(SWindow)
+		.SizingRule(ESizingRule::Autosized)
+		.AutoCenter(EAutoCenter::PrimaryWorkArea)
+		.Title(LOCTEXT("DownloadProgress", "Download Progress"));
+
+	Window->SetContent(
+		SNew(SBox).Padding(FMargin(30, 30, 30, 30))
+		[
+			SNew(SVerticalBox)
+				+SVerticalBox::Slot().AutoHeight()
+				[
+					SNew(STextBlock).Text_Lambda([]() {
+						FDownloadProgressSnapshot Snapshot = DownloadProgress::GetSnapshot();
+						return FText::Format(
+							LOCTEXT("DownloadedFiles", "Downloaded {0} of {1} files ({2} failed)."),
+							FText::AsNumber(Snapshot.FilesSucceeded),
+							FText::AsNumber(Snapshot.FilesTotal),
+							FText::AsNumber(Snapshot.FilesFailed)
+						);
+					}).Font(FFileDownloaderStyle::RegularFont())
+				]
+				+SVerticalBox::Slot().AutoHeight().Padding(FMargin(0, 0, 0, 10))
+				[
+					SNew(STextBlock).Text_Lambda([]() {
+						FDownloadProgressSnapshot Snapshot = DownloadProgress::GetSnapshot();
+						FText ETA = Snapshot.ETASeconds >= 0 ? FText::AsTimespan(FTimespan::FromSeconds(FMath::CeilToInt(Snapshot.ETASeconds))) : LOCTEXT("UnknownETA", "unknown");
+						return FText::Format(
+							LOCTEXT("DownloadedBytes", "{0} at {1}/s, time left: {2}"),
+							FText::AsMemory(Snapshot.BytesReceived),
+							FText::AsMemory((uint64) Snapshot.BytesPerSecond),
+							ETA
+						);
+					}).Font(FFileDownloaderStyle::RegularFont())
+				]
+				+SVerticalBox::Slot().AutoHeight().Padding(FMargin(0, 0, 0, 20))
+				[
+					SNew(SProgressBar)
+						.Percent_Lambda([]() { return DownloadProgress::GetSnapshot().GetFraction(); })
+						.RefreshRate(0.1)
+				]
+				+SVerticalBox::Slot().AutoHeight().HAlign(EHorizontalAlignment::HAlign_Center)
+				[
+					SNew(SButton)
+						.OnClicked_Lambda([]()->FReply {
+							DownloadProgress::CancelAll();
+							Close();
+							return FReply::Handled();
+						})
+						[
+							SNew(STextBlock).Font(FFileDownloaderStyle::RegularFont()).Text(FText::FromString(" Cancel "))
+						]
+				]
+		]
+	);
+
+	Window->SetOnWindowClosed(FOnWindowClosed::CreateLambda([](const TSharedRef<SWindow>& ClosedWindow) {
+		DownloadProgress::CancelAll();
+		DownloadProgress::OnProgress.Remove(ProgressHandle);
+		ProgressHandle.Reset();
+		Window.Reset();
+	}));
+
+	ProgressHandle = DownloadProgress::OnProgress.AddStatic(&FDownloadProgressWindow::OnProgress);
+	FSlateApplication::Get().AddWindow(Window.ToSharedRef());
+}
+
+void FDownloadProgressWindow::OnProgress(const FDownloadProgressSnapshot& Snapshot)
+{
+	if (Snapshot.FilesActive() == 0) Close();
+}
+
+void FDownloadProgressWindow::Close()
+{
+	DownloadProgress::OnProgress.Remove(ProgressHandle);
+	ProgressHandle.Reset();
+
+	if (Window.IsValid())
+	{
+		// closing the window normally would cancel the downloads of the next session
+		Window->SetOnWindowClosed(FOnWindowClosed());
+		Window->RequestDestroyWindow();
+		Window.Reset();
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
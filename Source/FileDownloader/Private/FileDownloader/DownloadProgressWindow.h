@@ -0,0 +1,25 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FileDownloader/DownloadProgress.h"
+
+class SWindow;
+
+// Single window showing the aggregated progress of all downloads, subscribed to DownloadProgress.
+// It closes itself at the end of the download session. Nothing is shown when Slate is not available.
+class FDownloadProgressWindow
+{
+public:
+	// Can be called from any thread
+	static void Open();
+
+private:
+	static void OpenOnGameThread();
+	static void OnProgress(const FDownloadProgressSnapshot& Snapshot);
+	static void Close();
+
+	static inline TSharedPtr<SWindow> Window;
+	static inline FDelegateHandle ProgressHandle;
+};
@@ -0,0 +1,87 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "FileDownloader/HostLimiter.h"
+
+#include "ConcurrencyHelpers/TaskPool.h"
+
+#include "GenericPlatform/GenericPlatformHttp.h"
+#include "Misc/ScopeLock.h"
+
+FString HostLimiter::GetHost(const FString& URL)
+{
+	return FGenericPlatformHttp::GetUrlDomain(URL).ToLower();
+}
+
+void HostLimiter::Acquire(FString URL, TFunction<void()> Start)
+{
+	FString Host = GetHost(URL);
+	{
+		FScopeLock ScopeLock(&Lock);
+		Hosts.FindOrAdd(Host).Pending.Add(MoveTemp(Start));
+	}
+	Pump(Host);
+}
+
+void HostLimiter::Release(FString URL)
+{
+	FString Host = GetHost(URL);
+	{
+		FScopeLock ScopeLock(&Lock);
+		FHostState &State = Hosts.FindOrAdd(Host);
+		State.Active = FMath::Max(0, State.Active - 1);
+	}
+	Pump(Host);
+}
+
+void HostLimiter::Backoff(FString URL, float Seconds)
+{
+	FScopeLock ScopeLock(&Lock);
+	FHostState &State = Hosts.FindOrAdd(GetHost(URL));
+	State.NextStartTime = FMath::Max(State.NextStartTime, FPlatformTime::Seconds() + Seconds);
+}
+
+void HostLimiter::RunAfter(float Seconds, TFunction<void()> Action)
+{
+	FTaskPool::Get().SubmitAfter(Seconds, [Action]() { Action(); });
+}
+
+void HostLimiter::Pump(const FString& Host)
+{
+	TArray<TFunction<void()>> ToStart;
+	{
+		FScopeLock ScopeLock(&Lock);
+		FHostState &State = Hosts.FindOrAdd(Host);
+
+		while (!State.Pending.IsEmpty() && (MaxConcurrentPerHost <= 0 || State.Active < MaxConcurrentPerHost))
+		{
+			double Now = FPlatformTime::Seconds();
+			if (Now < State.NextStartTime)
+			{
+				if (!State.bWakeUpScheduled)
+				{
+					State.bWakeUpScheduled = true;
+					RunAfter(State.NextStartTime - Now, [Host]()
+					{
+						{
+							FScopeLock ScopeLock(&Lock);
+							Hosts.FindOrAdd(Host).bWakeUpScheduled = false;
+						}
+						Pump(Host);
+					});
+				}
+				break;
+			}
+
+			State.Active++;
+			if (MaxRequestsPerSecondPerHost > 0) State.NextStartTime = Now + 1 / MaxRequestsPerSecondPerHost;
+			ToStart.Add(MoveTemp(State.Pending[0]));
+			State.Pending.RemoveAt(0);
+		}
+	}
+
+	// outside of the lock, as starting a request may acquire or release another slot
+	for (auto& Start : ToStart)
+	{
+		Start();
+	}
+}
@@ -0,0 +1,215 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "FileDownloader/PartFileWriter.h"
+#include "FileDownloader/LogFileDownloader.h"
+
+#include "HAL/FileManager.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+
+// Parses "bytes 100-199/1000" into 100 and 1000 (-1 when unknown)
+static bool ParseContentRange(FString ContentRange, int64 &OutStart, int64 &OutTotal)
+{
+	FString Range, Start, End, Total;
+	if (!ContentRange.Split(" ", nullptr, &Range)) return false;
+	if (!Range.Split("/", &Range, &Total)) return false;
+	if (!Range.Split("-", &Start, &End)) return false;
+
+	OutStart = FCString::Atoi64(*Start);
+	OutTotal = Total == "*" ? -1 : FCString::Atoi64(*Total);
+	return true;
+}
+
+FPartFileWriter::FPartFileWriter(FString File0)
+{
+	File = File0;
+	PartFile = File + ".part";
+	ValidatorFile = File + ".part.validator";
+	SetIsSaving(true);
+	SetIsPersistent(true);
+}
+
+FPartFileWriter::~FPartFileWriter()
+{
+	Close();
+}
+
+void FPartFileWriter::Prepare(TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request0)
+{
+	Request = Request0;
+
+	// without a validator, we cannot make sure that the resource did not change since the part file was written
+	FString Validator;
+	int64 PartSize = IFileManager::Get().FileSize(*PartFile);
+	if (PartSize > 0 && FFileHelper::LoadFileToString(Validator, *ValidatorFile) && !Validator.IsEmpty())
+	{
+		// the part file is hashed here, on a pool thread, rather than when the response starts on the HTTP thread
+		if (!Hasher.UpdateFromFile(PartFile))
+		{
+			UE_LOG(LogFileDownloader, Warning, TEXT("Could not read '%s', downloading '%s' from the start"), *PartFile, *File);
+			Hasher.Reset();
+			return;
+		}
+
+		UE_LOG(LogFileDownloader, Log, TEXT("Resuming download of '%s' from byte %lld"), *File, PartSize);
+		ResumeOffset = PartSize;
+		Request0->SetHeader("Range", FString::Printf(TEXT("bytes=%lld-"), PartSize));
+		Request0->SetHeader("If-Range", Validator);
+	}
+}
+
+bool FPartFileWriter::Open(FHttpResponsePtr Response)
+{
+	bOpened = true;
+
+	int32 Code = Response.IsValid() ? Response->GetResponseCode() : 0;
+	bool bAppend = false;
+
+	if (Code == EHttpResponseCodes::PartialContent)
+	{
+		int64 RangeStart, RangeTotal;
+		if (!ParseContentRange(Response->GetHeader("Content-Range"), RangeStart, RangeTotal) || (RangeStart != 0 && RangeStart != ResumeOffset))
+		{
+			UE_LOG(LogFileDownloader, Warning, TEXT("Unexpected Content-Range '%s' while downloading '%s'"), *Response->GetHeader("Content-Range"), *File);
+			bDiscard = true;
+			return false;
+		}
+		bAppend = RangeStart > 0;
+	}
+	else if (!EHttpResponseCodes::IsOk(Code))
+	{
+		// error page or unknown response, it must not end up in the part file
+		bDiscard = true;
+		return false;
+	}
+
+	// the hasher already covers the part file, which is only kept if the server resumes from its end
+	if (bAppend)
+	{
+		StartOffset = ResumeOffset;
+	}
+	else
+	{
+		Hasher.Reset();
+	}
+
+	Writer.Reset(IFileManager::Get().CreateFileWriter(*PartFile, bAppend ? FILEWRITE_Append : FILEWRITE_None));
+	if (!Writer)
+	{
+		UE_LOG(LogFileDownloader, Error, TEXT("Could not open '%s' for writing"), *PartFile);
+		bDiscard = true;
+		return false;
+	}
+
+	FString Validator = Response->GetHeader("ETag");
+	if (Validator.IsEmpty() || Validator.StartsWith("W/")) Validator = Response->GetHeader("Last-Modified");
+	if (Validator.IsEmpty())
+	{
+		IFileManager::Get().Delete(*ValidatorFile, false, true, true);
+	}
+	else
+	{
+		FFileHelper::SaveStringToFile(Validator, *ValidatorFile);
+	}
+
+	return true;
+}
+
+void FPartFileWriter::Serialize(void* Data, int64 Length)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (!bOpened)
+	{
+		TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> PinnedRequest = Request.Pin();
+		Open(PinnedRequest.IsValid() ? PinnedRequest->GetResponse() : nullptr);
+	}
+
+	if (bDiscard || !Writer) return;
+
+	Writer->Serialize(Data, Length);
+	if (Writer->IsError())
+	{
+		UE_LOG(LogFileDownloader, Error, TEXT("Error while writing to '%s'"), *PartFile);
+		SetError();
+		bDiscard = true;
+		return;
+	}
+
+	Hasher.Update((const uint8*) Data, Length);
+	Written += Length;
+}
+
+bool FPartFileWriter::Close()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (Writer)
+	{
+		if (!Writer->Close()) SetError();
+		Writer.Reset();
+	}
+	return !IsError();
+}
+
+bool FPartFileWriter::Finish(FHttpResponsePtr Response)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	// empty bodies never reach Serialize
+	if (!bOpened) Open(Response);
+
+	if (!Close() || bDiscard)
+	{
+		DeletePartFile();
+		return false;
+	}
+
+	int64 FileSize = StartOffset + Written;
+
+	if (Response->GetResponseCode() == EHttpResponseCodes::PartialContent)
+	{
+		int64 RangeStart, RangeTotal;
+		if (ParseContentRange(Response->GetHeader("Content-Range"), RangeStart, RangeTotal) && RangeTotal >= 0 && RangeTotal != FileSize)
+		{
+			UE_LOG(LogFileDownloader, Error, TEXT("Download of '%s' is incomplete: got %lld bytes out of %lld"), *File, FileSize, RangeTotal);
+			return false;
+		}
+	}
+
+	FString ContentLength = Response->GetHeader("Content-Length");
+	if (!ContentLength.IsEmpty() && FCString::Atoi64(*ContentLength) != Written)
+	{
+		UE_LOG(LogFileDownloader, Error, TEXT("Download of '%s' was truncated: received %lld bytes out of %s"), *File, Written, *ContentLength);
+		return false;
+	}
+
+	SHA256 = Hasher.Finalize();
+
+	if (!IFileManager::Get().Move(*File, *PartFile, true, true))
+	{
+		UE_LOG(LogFileDownloader, Error, TEXT("Could not move '%s' to '%s'"), *PartFile, *File);
+		return false;
+	}
+	IFileManager::Get().Delete(*ValidatorFile, false, true, true);
+
+	return true;
+}
+
+void FPartFileWriter::Fail(FHttpResponsePtr Response)
+{
+	Close();
+
+	// 4xx and 5xx responses (e.g. 416 Range Not Satisfiable) mean that the part file is of no use
+	if (bDiscard || (Response.IsValid() && Response->GetResponseCode() >= 400))
+	{
+		DeletePartFile();
+	}
+}
+
+void FPartFileWriter::DeletePartFile()
+{
+	IFileManager::Get().Delete(*PartFile, false, true, true);
+	IFileManager::Get().Delete(*ValidatorFile, false, true, true);
+}
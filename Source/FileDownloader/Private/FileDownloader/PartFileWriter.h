@@ -0,0 +1,57 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FileDownloader/StreamingSHA256.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Serialization/Archive.h"
+
+// Receives the body of an HTTP response and writes it to `File`.part as it arrives.
+// If a previous download of the same file was interrupted, the request can ask for the missing bytes only,
+// and the part file is appended to if the server answers with 206 Partial Content.
+// The part file is renamed to `File` once the download is complete and consistent.
+class FPartFileWriter : public FArchive
+{
+public:
+	FPartFileWriter(FString File0);
+	~FPartFileWriter();
+
+	// Adds the Range and If-Range headers to resume a previous partial download.
+	// The caller must then set this writer as the response body stream of `Request`.
+	void Prepare(TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request0);
+
+	void Serialize(void* Data, int64 Length) override;
+	bool Close() override;
+	FString GetArchiveName() const override { return PartFile; }
+
+	// Checks the received bytes against the response headers, then moves the part file to `File`
+	bool Finish(FHttpResponsePtr Response);
+
+	// Keeps the part file to resume later, unless the server rejected the request
+	void Fail(FHttpResponsePtr Response);
+
+	int64 GetStartOffset() const { return StartOffset; }
+	int64 GetFileSize() const { return StartOffset + Written; }
+	FString GetSHA256() const { return SHA256; }
+
+private:
+	bool Open(FHttpResponsePtr Response);
+	void DeletePartFile();
+
+	FString File;
+	FString PartFile;
+	FString ValidatorFile;
+
+	TWeakPtr<IHttpRequest, ESPMode::ThreadSafe> Request;
+	int64 ResumeOffset = 0;
+
+	FCriticalSection Lock;
+	bool bOpened = false;
+	bool bDiscard = false;
+	TUniquePtr<FArchive> Writer;
+	FStreamingSHA256 Hasher;
+	int64 StartOffset = 0;
+	int64 Written = 0;
+	FString SHA256;
+};
@@ -0,0 +1,43 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "FileDownloader/RetryPolicy.h"
+
+bool FRetryPolicy::IsRetryable(bool bWasSuccessful, FHttpResponsePtr Response) const
+{
+	if (!Response.IsValid() || Response->GetResponseCode() == 0) return true;
+	if (RetryableCodes.Contains(Response->GetResponseCode())) return true;
+
+	// the connection was lost while receiving a successful response
+	return !bWasSuccessful && EHttpResponseCodes::IsOk(Response->GetResponseCode());
+}
+
+float FRetryPolicy::GetDelay(int32 Attempt, FHttpResponsePtr Response) const
+{
+	if (Attempt >= MaxAttempts) return -1;
+
+	float Backoff = FMath::Min(MaxBackoffSeconds, InitialBackoffSeconds * FMath::Pow(BackoffMultiplier, Attempt - 1));
+	Backoff *= 1 - JitterFraction * FMath::FRand();
+
+	float RetryAfter = GetRetryAfter(Response);
+	if (RetryAfter > MaxRetryAfterSeconds) return -1;
+
+	return FMath::Max(Backoff, RetryAfter);
+}
+
+float FRetryPolicy::GetRetryAfter(FHttpResponsePtr Response)
+{
+	if (!Response.IsValid()) return -1;
+
+	FString RetryAfter = Response->GetHeader("Retry-After").TrimStartAndEnd();
+	if (RetryAfter.IsEmpty()) return -1;
+
+	if (RetryAfter.IsNumeric()) return FMath::Max(0.0f, FCString::Atof(*RetryAfter));
+
+	FDateTime Date;
+	if (FDateTime::ParseHttpDate(RetryAfter, Date))
+	{
+		return FMath::Max(0.0, (Date - FDateTime::UtcNow()).GetTotalSeconds());
+	}
+
+	return -1;
+}
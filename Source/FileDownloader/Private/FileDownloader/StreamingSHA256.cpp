@@ -0,0 +1,171 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "FileDownloader/StreamingSHA256.h"
+#include "FileDownloader/LogFileDownloader.h"
+
+#include "HAL/FileManager.h"
+
+static const uint32 RoundConstants[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static FORCEINLINE uint32 RotateRight(uint32 X, uint32 N)
+{
+	return (X >> N) | (X << (32 - N));
+}
+
+void FStreamingSHA256::Reset()
+{
+	State[0] = 0x6a09e667;
+	State[1] = 0xbb67ae85;
+	State[2] = 0x3c6ef372;
+	State[3] = 0xa54ff53a;
+	State[4] = 0x510e527f;
+	State[5] = 0x9b05688c;
+	State[6] = 0x1f83d9ab;
+	State[7] = 0x5be0cd19;
+	BufferSize = 0;
+	TotalSize = 0;
+}
+
+void FStreamingSHA256::Transform(const uint8* Block)
+{
+	uint32 W[64];
+	for (int i = 0; i < 16; i++)
+	{
+		W[i] = (uint32(Block[4 * i]) << 24) | (uint32(Block[4 * i + 1]) << 16) | (uint32(Block[4 * i + 2]) << 8) | uint32(Block[4 * i + 3]);
+	}
+	for (int i = 16; i < 64; i++)
+	{
+		uint32 S0 = RotateRight(W[i - 15], 7) ^ RotateRight(W[i - 15], 18) ^ (W[i - 15] >> 3);
+		uint32 S1 = RotateRight(W[i - 2], 17) ^ RotateRight(W[i - 2], 19) ^ (W[i - 2] >> 10);
+		W[i] = W[i - 16] + S0 + W[i - 7] + S1;
+	}
+
+	uint32 A = State[0], B = State[1], C = State[2], D = State[3];
+	uint32 E = State[4], F = State[5], G = State[6], H = State[7];
+
+	for (int i = 0; i < 64; i++)
+	{
+		uint32 S1 = RotateRight(E, 6) ^ RotateRight(E, 11) ^ RotateRight(E, 25);
+		uint32 Ch = (E & F) ^ (~E & G);
+		uint32 Temp1 = H + S1 + Ch + RoundConstants[i] + W[i];
+		uint32 S0 = RotateRight(A, 2) ^ RotateRight(A, 13) ^ RotateRight(A, 22);
+		uint32 Maj = (A & B) ^ (A & C) ^ (B & C);
+		uint32 Temp2 = S0 + Maj;
+
+		H = G;
+		G = F;
+		F = E;
+		E = D + Temp1;
+		D = C;
+		C = B;
+		B = A;
+		A = Temp1 + Temp2;
+	}
+
+	State[0] += A; State[1] += B; State[2] += C; State[3] += D;
+	State[4] += E; State[5] += F; State[6] += G; State[7] += H;
+}
+
+void FStreamingSHA256::Update(const uint8* Data, int64 Size)
+{
+	TotalSize += Size;
+
+	if (BufferSize > 0)
+	{
+		int64 ToCopy = FMath::Min<int64>(64 - BufferSize, Size);
+		FMemory::Memcpy(Buffer + BufferSize, Data, ToCopy);
+		BufferSize += ToCopy;
+		Data += ToCopy;
+		Size -= ToCopy;
+
+		if (BufferSize < 64) return;
+
+		Transform(Buffer);
+		BufferSize = 0;
+	}
+
+	while (Size >= 64)
+	{
+		Transform(Data);
+		Data += 64;
+		Size -= 64;
+	}
+
+	if (Size > 0)
+	{
+		FMemory::Memcpy(Buffer, Data, Size);
+		BufferSize = Size;
+	}
+}
+
+FString FStreamingSHA256::Finalize()
+{
+	uint64 TotalBits = TotalSize * 8;
+
+	uint8 Padding[72] = { 0x80 };
+	int32 PaddingSize = (BufferSize < 56) ? 56 - BufferSize : 120 - BufferSize;
+	for (int i = 0; i < 8; i++)
+	{
+		Padding[PaddingSize + i] = uint8(TotalBits >> (56 - 8 * i));
+	}
+	Update(Padding, PaddingSize + 8);
+
+	FString Result;
+	for (int i = 0; i < 8; i++)
+	{
+		Result += FString::Printf(TEXT("%08x"), State[i]);
+	}
+	return Result;
+}
+
+FString FStreamingSHA256::HashBytes(const TArray<uint8>& Bytes)
+{
+	FStreamingSHA256 Hasher;
+	Hasher.Update(Bytes.GetData(), Bytes.Num());
+	return Hasher.Finalize();
+}
+
+bool FStreamingSHA256::UpdateFromFile(const FString& File)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*File));
+	if (!Reader)
+	{
+		UE_LOG(LogFileDownloader, Warning, TEXT("Could not open '%s' to compute its hash"), *File);
+		return false;
+	}
+
+	TArray<uint8> Chunk;
+	Chunk.SetNumUninitialized(1 << 20);
+
+	int64 Remaining = Reader->TotalSize();
+	while (Remaining > 0)
+	{
+		int64 ChunkSize = FMath::Min<int64>(Remaining, Chunk.Num());
+		Reader->Serialize(Chunk.GetData(), ChunkSize);
+		if (Reader->IsError())
+		{
+			UE_LOG(LogFileDownloader, Warning, TEXT("Error while reading '%s' to compute its hash"), *File);
+			return false;
+		}
+		Update(Chunk.GetData(), ChunkSize);
+		Remaining -= ChunkSize;
+	}
+
+	return true;
+}
+
+FString FStreamingSHA256::HashFile(const FString& File)
+{
+	FStreamingSHA256 Hasher;
+	if (!Hasher.UpdateFromFile(File)) return "";
+	return Hasher.Finalize();
+}
@@ -2,6 +2,7 @@
 
 #include "FileDownloaderModule.h"
 #include "FileDownloader/Download.h"
+#include "FileDownloader/DownloadCache.h"
 
 #define LOCTEXT_NAMESPACE "FFileDownloaderModule"
 
@@ -9,7 +10,8 @@ IMPLEMENT_MODULE(FFileDownloaderModule, FileDownloader)
 
 void FFileDownloaderModule::StartupModule()
 {
-	Download::LoadExpectedSizeCache();
+	DownloadCache::Load();
+	Download::LoadRedirectsFromCommandLine();
 }
 
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
@@ -3,10 +3,16 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "FileDownloader/RetryPolicy.h"
 
+#include <atomic>
+
+// Downloads run on HTTP and worker threads; the callbacks of the asynchronous functions are called on the game thread.
+// When `bProgress` is true, the downloads are shown in a single progress window (if Slate is available).
 class FILEDOWNLOADER_API Download {
 public:
 	
+	// Block the calling thread for at most SynchronousTimeoutSeconds; as they do not need the game thread, they can be called from it
 	static bool SynchronousFromURLExpecting(FString URL, FString File, int32 ExpectedSize);
 	static bool SynchronousFromURL(FString URL, FString File);
 
@@ -16,8 +22,30 @@ public:
 	static void DownloadMany(TArray<FString> URLs, TArray<FString> Files, TFunction<void(TArray<FString>)> OnComplete);
 	static void DownloadMany(TArray<FString> URLs, FString Directory, TFunction<void(TArray<FString>)> OnComplete);
 
-	static void AddExpectedSize(FString URL, int32 ExpectedSize);
-	static FString ExpectedSizeCacheFile();
-	static void LoadExpectedSizeCache();
-	static void SaveExpectedSizeCache();
+	// Used by all downloads; the per-host limits are in HostLimiter
+	static inline FRetryPolicy RetryPolicy;
+
+	// 0 means no timeout
+	static inline float SynchronousTimeoutSeconds = 10;
+
+	// Requests to URLs starting with `Prefix` are sent to `Replacement` + the rest of the URL instead, for instance to use
+	// a local mirror or a loopback server. The download cache and the host limits still use the original URLs.
+	// Redirects can also be given on the command line: -DownloadRedirect="Prefix1|Replacement1,Prefix2|Replacement2"
+	static void AddRedirect(FString Prefix, FString Replacement);
+	static void RemoveRedirect(FString Prefix);
+	static void ClearRedirects();
+	static void LoadRedirectsFromCommandLine();
+	static FString Redirect(FString URL);
+
+	// Downloads whose completion callback has not returned yet, including the ones waiting for their HEAD request
+	// or for a slot of HostLimiter, which DownloadProgress does not know about yet
+	static int32 NumInFlight() { return InFlight; }
+
+private:
+	// Counts a download in InFlight until the returned function has called `OnComplete`
+	static TFunction<void(bool)> TrackInFlight(TFunction<void(bool)> OnComplete);
+	static inline std::atomic<int32> InFlight { 0 };
+
+	static inline TArray<TPair<FString, FString>> Redirects;
+	static inline FCriticalSection RedirectsLock;
 };
@@ -0,0 +1,54 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FAppendOnlyManifest;
+
+struct FILEDOWNLOADER_API FDownloadCacheEntry
+{
+	FString URL;
+	FString File;
+	int64 Size = 0;
+	FString SHA256;
+	FString ETag;
+	FString LastModified;
+	int64 FetchTime = 0;  // Unix timestamp
+	int64 TTLSeconds = 0; // 0 means that the entry never expires
+
+	// Whether `File` was checked against `SHA256` during this session
+	bool bVerified = false;
+
+	bool IsExpired() const;
+};
+
+// Cache of downloaded files, keyed on URL, storing the size and SHA-256 of the downloaded content.
+// Entries are persisted in an append-only manifest (see FAppendOnlyManifest).
+class FILEDOWNLOADER_API DownloadCache
+{
+public:
+	// Returns true if `File` holds the content that was downloaded from `URL` and the entry has not expired.
+	// Files are hashed the first time they are checked during a session; after that, a hit costs a lookup and a size check.
+	static bool IsValid(FString URL, FString File);
+
+	// Returns false if there is no entry for `URL` (expired entries are still returned)
+	static bool Find(FString URL, FDownloadCacheEntry& OutEntry);
+
+	static void Record(FString URL, FString File, FString SHA256, int64 Size, FString ETag, FString LastModified, int64 TTLSeconds = 0);
+	static void Refresh(FString URL);
+	static void Remove(FString URL);
+
+	static FString ManifestFile();
+	static void Load();
+
+	static inline int64 DefaultTTLSeconds = 0;
+
+private:
+	static FAppendOnlyManifest& Manifest();
+	static TArray<FString> ToFields(const FDownloadCacheEntry& Entry);
+	static bool FromFields(const FString& URL, const TArray<FString>& Fields, FDownloadCacheEntry& OutEntry);
+
+	static inline TMap<FString, FDownloadCacheEntry> Entries;
+	static inline FCriticalSection Lock;
+};
@@ -0,0 +1,70 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+
+struct FILEDOWNLOADER_API FDownloadProgressSnapshot
+{
+	int32 FilesTotal = 0;
+	int32 FilesSucceeded = 0;
+	int32 FilesFailed = 0;
+
+	// Bytes of the files whose size is unknown are counted in BytesReceived, but not in BytesExpected
+	int64 BytesReceived = 0;
+	int64 BytesExpected = 0;
+
+	double ElapsedSeconds = 0;
+	double BytesPerSecond = 0;
+	double ETASeconds = -1; // -1 when unknown
+
+	int32 FilesActive() const { return FilesTotal - FilesSucceeded - FilesFailed; }
+
+	// Between 0 and 1, based on bytes when all sizes are known, on files otherwise
+	float GetFraction() const;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnDownloadProgress, const FDownloadProgressSnapshot&);
+
+// Thread-safe aggregation of the progress of all running downloads.
+// A session starts with the first download and ends when no download is active anymore.
+class FILEDOWNLOADER_API DownloadProgress
+{
+public:
+	// Returns an identifier for Update and End; `Cancel` is called by CancelAll
+	static int32 Begin(FString URL, int64 ExpectedSize, TFunction<void()> Cancel);
+	static void Update(int32 Id, int64 Received);
+	static void End(int32 Id, bool bSuccess);
+
+	static void CancelAll();
+	static FDownloadProgressSnapshot GetSnapshot();
+
+	// Bytes received by all downloads since the start, including the ones that failed
+	static int64 GetTotalBytesReceived();
+
+	// Broadcast on the game thread every BroadcastPeriodSeconds during a session, and once when it ends.
+	// Subscribe and unsubscribe from the game thread only.
+	static FOnDownloadProgress OnProgress;
+	static inline float BroadcastPeriodSeconds = 0.1;
+
+private:
+	struct FFileProgress
+	{
+		FString URL;
+		int64 Expected = 0;
+		int64 Received = 0;
+		TFunction<void()> Cancel;
+	};
+
+	static FDownloadProgressSnapshot GetSnapshotLocked();
+	static bool Broadcast(float DeltaTime);
+
+	static inline TMap<int32, FFileProgress> Active;
+	static inline int32 NextId = 0;
+	static inline FDownloadProgressSnapshot Session;
+	static inline double SessionStart = 0;
+	static inline int64 TotalBytesReceived = 0;
+	static inline FTSTicker::FDelegateHandle TickerHandle;
+	static inline FCriticalSection Lock;
+};
@@ -0,0 +1,41 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Limits the number of concurrent requests and the request rate for each host.
+// Requests that cannot start right away are queued and started in order when a slot frees up.
+class FILEDOWNLOADER_API HostLimiter
+{
+public:
+	// Calls `Start` (possibly from another thread) once a request to the host of `URL` is allowed;
+	// `Release` must be called once the request is complete
+	static void Acquire(FString URL, TFunction<void()> Start);
+	static void Release(FString URL);
+
+	// Delays all requests to the host of `URL` by at least `Seconds`, for instance after a 429 with Retry-After
+	static void Backoff(FString URL, float Seconds);
+
+	// Calls `Action` on a worker thread after `Seconds`
+	static void RunAfter(float Seconds, TFunction<void()> Action);
+
+	// 0 means no limit
+	static inline int32 MaxConcurrentPerHost = 6;
+	static inline float MaxRequestsPerSecondPerHost = 0;
+
+private:
+	struct FHostState
+	{
+		int32 Active = 0;
+		double NextStartTime = 0;
+		bool bWakeUpScheduled = false;
+		TArray<TFunction<void()>> Pending;
+	};
+
+	static FString GetHost(const FString& URL);
+	static void Pump(const FString& Host);
+
+	static inline TMap<FString, FHostState> Hosts;
+	static inline FCriticalSection Lock;
+};
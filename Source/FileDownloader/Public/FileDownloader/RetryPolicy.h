@@ -0,0 +1,34 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpResponse.h"
+
+// Decides whether a failed request is attempted again, and how long to wait before doing so
+struct FILEDOWNLOADER_API FRetryPolicy
+{
+	// Total number of attempts, including the first one
+	int32 MaxAttempts = 5;
+
+	// The delay before attempt n + 1 is InitialBackoffSeconds * BackoffMultiplier^(n - 1), capped at MaxBackoffSeconds,
+	// of which a random fraction (at most JitterFraction) is removed so that parallel downloads do not retry in lockstep
+	float InitialBackoffSeconds = 1;
+	float BackoffMultiplier = 2;
+	float MaxBackoffSeconds = 30;
+	float JitterFraction = 0.5;
+
+	// Retry-After headers asking for longer than this are not honored, and the request fails instead
+	float MaxRetryAfterSeconds = 120;
+
+	// Connection errors, timeouts and these status codes are retried
+	TArray<int32> RetryableCodes = { 408, 425, 429, 500, 502, 503, 504 };
+
+	bool IsRetryable(bool bWasSuccessful, FHttpResponsePtr Response) const;
+
+	// Returns a negative delay if no attempt should be made after `Attempt` (starting at 1)
+	float GetDelay(int32 Attempt, FHttpResponsePtr Response) const;
+
+	// Returns the number of seconds asked by a Retry-After header (in seconds or as an HTTP date), or -1 if there is none
+	static float GetRetryAfter(FHttpResponsePtr Response);
+};
@@ -0,0 +1,34 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// SHA-256 that can be fed incrementally, so that files can be hashed while they are written or read in chunks
+class FILEDOWNLOADER_API FStreamingSHA256
+{
+public:
+	FStreamingSHA256() { Reset(); }
+
+	void Reset();
+	void Update(const uint8* Data, int64 Size);
+
+	// Feeds the whole content of `File`, returns false if it cannot be read
+	bool UpdateFromFile(const FString& File);
+
+	// Returns the lowercase hexadecimal digest; the hasher must be reset before being used again
+	FString Finalize();
+
+	static FString HashBytes(const TArray<uint8>& Bytes);
+
+	// Returns an empty string if the file cannot be read
+	static FString HashFile(const FString& File);
+
+private:
+	void Transform(const uint8* Block);
+
+	uint32 State[8];
+	uint8 Buffer[64];
+	int32 BufferSize;
+	uint64 TotalSize;
+};
@@ -45,6 +45,9 @@ public class GDALInterface : ModuleRules
 				"InputCore",
 				"CoreUObject",
 				"Engine",
+
+				// Landscape Combinator Dependencies
+				"ConcurrencyHelpers",
 			}
 		);
 	}
@@ -0,0 +1,208 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "GDALInterface/DatasetPool.h"
+#include "GDALInterface/LogGDALInterface.h"
+#include "GDALInterface/RasterStatistics.h"
+
+#include "HAL/PlatformTLS.h"
+#include "Misc/Crc.h"
+
+#include "cpl_vsi.h"
+
+bool FRasterMetadata::GetCoordinates(FVector4d& OutCoordinates) const
+{
+	if (!bHasGeoTransform) return false;
+
+	OutCoordinates[0] = GeoTransform[0];
+	OutCoordinates[1] = GeoTransform[0] + Width * GeoTransform[1];
+	OutCoordinates[2] = GeoTransform[3] + Height * GeoTransform[5];
+	OutCoordinates[3] = GeoTransform[3];
+	return true;
+}
+
+int64 FRasterMetadata::GetUncompressedBytes() const
+{
+	return (int64) Width * Height * NumBands * GDALGetDataTypeSizeBytes(BandType);
+}
+
+bool FFileStamp::Get(const FString& File, FFileStamp& OutStamp, bool bHashContent)
+{
+	VSIStatBufL Stat;
+	if (VSIStatL(TCHAR_TO_UTF8(*File), &Stat) != 0) return false;
+
+	OutStamp.ModificationTime = Stat.st_mtime;
+	OutStamp.Size = Stat.st_size;
+	OutStamp.ContentHash = 0;
+	if (!bHashContent) return true;
+
+	VSILFILE* Handle = VSIFOpenL(TCHAR_TO_UTF8(*File), "rb");
+	if (!Handle) return false;
+
+	TArray<uint8> Buffer;
+	Buffer.SetNumUninitialized(1 << 20);
+	uint32 Crc = 0;
+	size_t Read;
+	while ((Read = VSIFReadL(Buffer.GetData(), 1, Buffer.Num(), Handle)) > 0)
+	{
+		Crc = FCrc::MemCrc32(Buffer.GetData(), (int32) Read, Crc);
+	}
+	VSIFCloseL(Handle);
+
+	OutStamp.ContentHash = Crc;
+	return true;
+}
+
+DatasetPool::FDatasetRef DatasetPool::Acquire(FString File)
+{
+	FPaths::NormalizeFilename(File);
+
+	FFileStamp Stamp;
+	bool bHasStamp = FFileStamp::Get(File, Stamp);
+	TPair<uint32, FString> Key(FPlatformTLS::GetCurrentThreadId(), File);
+
+	FDatasetRef Outdated;
+	if (bHasStamp)
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (FPooledDataset* Pooled = Datasets.Find(Key))
+		{
+			if (Pooled->Stamp == Stamp)
+			{
+				Pooled->LastUse = ++UseCounter;
+				Hits++;
+				return Pooled->Dataset;
+			}
+			Outdated = Pooled->Dataset;
+			Datasets.Remove(Key);
+		}
+	}
+
+	// opening can be slow (VRTs, GeoTIFFs with many IFDs), so it happens outside of the lock
+	Misses++;
+	FDatasetRef Dataset = MakeShared<FGDALDatasetHandle, ESPMode::ThreadSafe>(FGDALDatasetHandle::Open(File));
+	if (!*Dataset) return nullptr;
+
+	// files that cannot be stat'ed cannot be invalidated, so they are not pooled
+	if (!bHasStamp) return Dataset;
+
+	TArray<FDatasetRef> Evicted;
+	{
+		FScopeLock ScopeLock(&Lock);
+		while (Datasets.Num() >= FMath::Max(1, MaxOpenDatasets))
+		{
+			TPair<uint32, FString> OldestKey;
+			uint64 OldestUse = MAX_uint64;
+			for (auto& [PooledKey, Pooled] : Datasets)
+			{
+				if (Pooled.LastUse < OldestUse)
+				{
+					OldestUse = Pooled.LastUse;
+					OldestKey = PooledKey;
+				}
+			}
+			Evicted.Add(Datasets.FindAndRemoveChecked(OldestKey).Dataset);
+		}
+		Datasets.Add(Key, { Dataset, Stamp, ++UseCounter });
+	}
+
+	// the outdated and evicted datasets are closed here, outside of the lock, unless they are still in use
+	return Dataset;
+}
+
+bool DatasetPool::GetMetadata(FString File, FRasterMetadata& OutMetadata)
+{
+	FPaths::NormalizeFilename(File);
+
+	FFileStamp Stamp;
+	bool bHasStamp = FFileStamp::Get(File, Stamp);
+
+	if (bHasStamp)
+	{
+		FScopeLock ScopeLock(&Lock);
+		FCachedMetadata* Cached = Metadata.Find(File);
+		if (Cached && Cached->Stamp == Stamp)
+		{
+			OutMetadata = Cached->Metadata;
+			Hits++;
+			return true;
+		}
+	}
+
+	FDatasetRef Dataset = Acquire(File);
+	if (!Dataset || !ReadMetadata(Dataset->Get(), OutMetadata)) return false;
+
+	if (bHasStamp)
+	{
+		FScopeLock ScopeLock(&Lock);
+		Metadata.Add(File, { OutMetadata, Stamp });
+	}
+	return true;
+}
+
+bool DatasetPool::ReadMetadata(GDALDataset* Dataset, FRasterMetadata& OutMetadata)
+{
+	OutMetadata = FRasterMetadata();
+	OutMetadata.Width = Dataset->GetRasterXSize();
+	OutMetadata.Height = Dataset->GetRasterYSize();
+	OutMetadata.NumBands = Dataset->GetRasterCount();
+
+	if (OutMetadata.NumBands > 0)
+	{
+		GDALRasterBand* Band = Dataset->GetRasterBand(1);
+		OutMetadata.BandType = Band->GetRasterDataType();
+
+		int bHasNoData = 0;
+		double NoData = Band->GetNoDataValue(&bHasNoData);
+		if (bHasNoData) OutMetadata.NoData = NoData;
+	}
+
+	OutMetadata.bHasGeoTransform = Dataset->GetGeoTransform(OutMetadata.GeoTransform) == CE_None;
+	OutMetadata.ProjectionWKT = UTF8_TO_TCHAR(Dataset->GetProjectionRef());
+	return true;
+}
+
+bool DatasetPool::IsInPath(const FString& File, const FString& Path)
+{
+	FString Folder = Path;
+	if (!Folder.EndsWith("/")) Folder += "/";
+	return File == Path || File.StartsWith(Folder);
+}
+
+void DatasetPool::Invalidate(FString Path)
+{
+	// keys are normalized in Acquire and GetMetadata
+	FPaths::NormalizeFilename(Path);
+
+	TArray<FDatasetRef> Closed;
+	{
+		FScopeLock ScopeLock(&Lock);
+		for (auto It = Datasets.CreateIterator(); It; ++It)
+		{
+			if (IsInPath(It->Key.Value, Path))
+			{
+				Closed.Add(It->Value.Dataset);
+				It.RemoveCurrent();
+			}
+		}
+
+		for (auto It = Metadata.CreateIterator(); It; ++It)
+		{
+			if (IsInPath(It->Key, Path)) It.RemoveCurrent();
+		}
+	}
+
+	RasterStatistics::Invalidate(Path);
+}
+
+void DatasetPool::Clear()
+{
+	TMap<TPair<uint32, FString>, FPooledDataset> Closed;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Closed = MoveTemp(Datasets);
+		Datasets.Reset();
+		Metadata.Reset();
+	}
+
+	UE_LOG(LogGDALInterface, Log, TEXT("Closed %d pooled datasets"), Closed.Num());
+}
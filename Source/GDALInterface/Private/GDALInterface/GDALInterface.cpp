@@ -2,7 +2,14 @@
 
 #include "GDALInterface/GDALInterface.h"
 #include "GDALInterface/LogGDALInterface.h"
-
+#include "GDALInterface/DatasetPool.h"
+#include "GDALInterface/RasterStatistics.h"
+#include "GDALInterface/RasterBlocks.h"
+#include "GDALInterface/TransformRegistry.h"
+
+#include "Async/Async.h"
+#include "Misc/FileHelper.h"
+#include "Misc/MessageDialog.h"
 #include "Misc/Paths.h"
 #include "Misc/ScopedSlowTask.h"
 
@@ -14,7 +21,7 @@ bool GDALInterface::SetWellKnownGeogCRS(OGRSpatialReference& InRs, FString CRS)
 
 	if (Err != OGRERR_NONE)
 	{
-		FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
+		ShowError(FText::Format(
 			LOCTEXT("SetWellKnownGeogCRS", "Unable to get spatial reference from string: {0}.\nError: {1}"),
 			FText::FromString(CRS),
 			FText::AsNumber(Err, &FNumberFormattingOptions::DefaultNoGrouping())
@@ -28,23 +35,21 @@ bool GDALInterface::SetWellKnownGeogCRS(OGRSpatialReference& InRs, FString CRS)
 
 bool GDALInterface::HasCRS(FString File)
 {
-	GDALDataset* Dataset = (GDALDataset *) GDALOpen(TCHAR_TO_UTF8(*File), GA_ReadOnly);
-
-	if (!Dataset) return false;
+	FRasterMetadata Metadata;
+	if (!DatasetPool::GetMetadata(File, Metadata)) return false;
 
-	const char* ProjectionRef = Dataset->GetProjectionRef();
 	OGRSpatialReference UnusedRs;
-	return UnusedRs.importFromWkt(ProjectionRef) != OGRERR_NONE;
+	return UnusedRs.importFromWkt(TCHAR_TO_UTF8(*Metadata.ProjectionWKT)) != OGRERR_NONE;
 }
 
 bool GDALInterface::SetCRSFromFile(OGRSpatialReference &InRs, FString File, bool bDialog)
 {
-	GDALDataset* Dataset = (GDALDataset *) GDALOpen(TCHAR_TO_UTF8(*File), GA_ReadOnly);
+	DatasetPool::FDatasetRef Dataset = DatasetPool::Acquire(File);
 	if (!Dataset)
 	{
 		if (bDialog)
 		{
-			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
+			ShowError(FText::Format(
 				LOCTEXT("GetSpatialReferenceError", "Unable to open file {0} to read its spatial reference."),
 				FText::FromString(File)
 			));
@@ -52,7 +57,7 @@ bool GDALInterface::SetCRSFromFile(OGRSpatialReference &InRs, FString File, bool
 		return false;
 	}
 
-	return SetCRSFromDataset(InRs, Dataset, bDialog);
+	return SetCRSFromDataset(InRs, Dataset->Get(), bDialog);
 }
 
 bool GDALInterface::SetCRSFromDataset(OGRSpatialReference& InRs, GDALDataset* Dataset, bool bDialog)
@@ -61,7 +66,7 @@ bool GDALInterface::SetCRSFromDataset(OGRSpatialReference& InRs, GDALDataset* Da
 	{
 		if (bDialog)
 		{
-			FMessageDialog::Open(EAppMsgType::Ok,
+			ShowError(
 				LOCTEXT("GetSpatialReferenceError", "Unable to get spatial reference from dataset (null pointer).")
 			);
 		}
@@ -75,7 +80,7 @@ bool GDALInterface::SetCRSFromDataset(OGRSpatialReference& InRs, GDALDataset* Da
 	{
 		if (bDialog)
 		{
-			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
+			ShowError(FText::Format(
 				LOCTEXT("GetSpatialReferenceError2", "Unable to get spatial reference from dataset (Error {0})."),
 				FText::AsNumber(Err, &FNumberFormattingOptions::DefaultNoGrouping())
 			));
@@ -135,12 +140,155 @@ bool GDALInterface::AddGeoreference(FString InputFile, FString OutputFile, FStri
 	return bWarpSuccess;
 }
 
+bool GDALInterface::CreateMosaic(TArray<FString> SourceFiles, TArray<FVector4d> SourceExtents, FString CRS, FString TargetFile)
+{
+	check(SourceFiles.Num() == SourceExtents.Num());
+
+	if (SourceFiles.IsEmpty())
+	{
+		ShowError(LOCTEXT("CreateMosaicEmpty", "Cannot create a mosaic without source files."));
+		return false;
+	}
+
+	OGRSpatialReference SpatialReference;
+	if (!SetCRSFromUserInput(SpatialReference, CRS)) return false;
+
+	char* WKT = nullptr;
+	SpatialReference.exportToWkt(&WKT);
+	FString EscapedWKT = EscapeXML(UTF8_TO_TCHAR(WKT));
+	CPLFree(WKT);
+
+	TArray<FRasterMetadata> Metadatas;
+	Metadatas.SetNum(SourceFiles.Num());
+	FVector4d Extent = SourceExtents[0];
+
+	for (int i = 0; i < SourceFiles.Num(); i++)
+	{
+		if (!DatasetPool::GetMetadata(SourceFiles[i], Metadatas[i]))
+		{
+			ShowError(FText::Format(
+				LOCTEXT("CreateMosaicOpen", "Could not open file '{0}' to add it to mosaic '{1}'."),
+				FText::FromString(SourceFiles[i]),
+				FText::FromString(TargetFile)
+			));
+			return false;
+		}
+
+		Extent[0] = FMath::Min(Extent[0], SourceExtents[i][0]);
+		Extent[1] = FMath::Max(Extent[1], SourceExtents[i][1]);
+		Extent[2] = FMath::Min(Extent[2], SourceExtents[i][2]);
+		Extent[3] = FMath::Max(Extent[3], SourceExtents[i][3]);
+	}
+
+	// the mosaic has the resolution of the first source, and the bands of the source with most bands
+	const FRasterMetadata& First = Metadatas[0];
+	const double PixelWidth = (SourceExtents[0][1] - SourceExtents[0][0]) / First.Width;
+	const double PixelHeight = (SourceExtents[0][3] - SourceExtents[0][2]) / First.Height;
+	const int Width = FMath::RoundToInt((Extent[1] - Extent[0]) / PixelWidth);
+	const int Height = FMath::RoundToInt((Extent[3] - Extent[2]) / PixelHeight);
+
+	int ReferenceIndex = 0;
+	for (int i = 1; i < Metadatas.Num(); i++)
+	{
+		if (Metadatas[i].NumBands > Metadatas[ReferenceIndex].NumBands) ReferenceIndex = i;
+	}
+
+	DatasetPool::FDatasetRef Reference = DatasetPool::Acquire(SourceFiles[ReferenceIndex]);
+	if (!Reference)
+	{
+		ShowError(FText::Format(
+			LOCTEXT("CreateMosaicOpen", "Could not open file '{0}' to add it to mosaic '{1}'."),
+			FText::FromString(SourceFiles[ReferenceIndex]),
+			FText::FromString(TargetFile)
+		));
+		return false;
+	}
+
+	FString VRT = FString::Printf(TEXT("<VRTDataset rasterXSize=\"%d\" rasterYSize=\"%d\">\n"), Width, Height);
+	VRT += FString::Printf(TEXT("  <SRS dataAxisToSRSAxisMapping=\"1,2\">%s</SRS>\n"), *EscapedWKT);
+	VRT += FString::Printf(TEXT("  <GeoTransform>%.17g, %.17g, 0, %.17g, 0, %.17g</GeoTransform>\n"), Extent[0], PixelWidth, Extent[3], -PixelHeight);
+
+	for (int Band = 1; Band <= Metadatas[ReferenceIndex].NumBands; Band++)
+	{
+		GDALRasterBand* ReferenceBand = (*Reference)->GetRasterBand(Band);
+		if (ReferenceBand->GetColorTable())
+		{
+			ShowError(FText::Format(
+				LOCTEXT("CreateMosaicPalette", "Cannot add file '{0}' to mosaic '{1}' as it uses a color table."),
+				FText::FromString(SourceFiles[ReferenceIndex]),
+				FText::FromString(TargetFile)
+			));
+			return false;
+		}
+
+		VRT += FString::Printf(TEXT("  <VRTRasterBand dataType=\"%s\" band=\"%d\">\n"), UTF8_TO_TCHAR(GDALGetDataTypeName(ReferenceBand->GetRasterDataType())), Band);
+		VRT += FString::Printf(TEXT("    <ColorInterp>%s</ColorInterp>\n"), UTF8_TO_TCHAR(GDALGetColorInterpretationName(ReferenceBand->GetColorInterpretation())));
+		if (Metadatas[ReferenceIndex].NoData.IsSet())
+		{
+			VRT += FString::Printf(TEXT("    <NoDataValue>%.17g</NoDataValue>\n"), Metadatas[ReferenceIndex].NoData.GetValue());
+		}
+
+		// sources without alpha band, such as RGB tiles mixed with expanded paletted tiles, are opaque
+		const bool bAlphaBand = ReferenceBand->GetColorInterpretation() == GCI_AlphaBand;
+		const double Opaque = ReferenceBand->GetRasterDataType() == GDT_UInt16 ? 65535 : 255;
+
+		for (int i = 0; i < SourceFiles.Num(); i++)
+		{
+			const bool bMissingAlpha = Band > Metadatas[i].NumBands;
+			if (bMissingAlpha && !bAlphaBand) continue;
+
+			const FVector4d& SourceExtent = SourceExtents[i];
+			VRT += bMissingAlpha ? TEXT("    <ComplexSource>\n") : TEXT("    <SimpleSource>\n");
+			VRT += FString::Printf(TEXT("      <SourceFilename relativeToVRT=\"0\">%s</SourceFilename>\n"), *EscapeXML(SourceFiles[i]));
+			VRT += FString::Printf(TEXT("      <SourceBand>%d</SourceBand>\n"), bMissingAlpha ? 1 : Band);
+			VRT += FString::Printf(TEXT("      <SrcRect xOff=\"0\" yOff=\"0\" xSize=\"%d\" ySize=\"%d\"/>\n"), Metadatas[i].Width, Metadatas[i].Height);
+			VRT += FString::Printf(TEXT("      <DstRect xOff=\"%d\" yOff=\"%d\" xSize=\"%d\" ySize=\"%d\"/>\n"),
+				FMath::RoundToInt((SourceExtent[0] - Extent[0]) / PixelWidth),
+				FMath::RoundToInt((Extent[3] - SourceExtent[3]) / PixelHeight),
+				FMath::RoundToInt((SourceExtent[1] - SourceExtent[0]) / PixelWidth),
+				FMath::RoundToInt((SourceExtent[3] - SourceExtent[2]) / PixelHeight)
+			);
+			if (bMissingAlpha)
+			{
+				VRT += FString::Printf(TEXT("      <ScaleOffset>%.17g</ScaleOffset>\n"), Opaque);
+				VRT += TEXT("      <ScaleRatio>0</ScaleRatio>\n");
+			}
+			VRT += bMissingAlpha ? TEXT("    </ComplexSource>\n") : TEXT("    </SimpleSource>\n");
+		}
+
+		VRT += TEXT("  </VRTRasterBand>\n");
+	}
+	VRT += TEXT("</VRTDataset>\n");
+
+	DatasetPool::Invalidate(TargetFile);
+
+	if (!FFileHelper::SaveStringToFile(VRT, *TargetFile, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		ShowError(FText::Format(
+			LOCTEXT("CreateMosaicWrite", "Could not write mosaic '{0}'."),
+			FText::FromString(TargetFile)
+		));
+		return false;
+	}
+
+	UE_LOG(LogGDALInterface, Log, TEXT("Created mosaic %s (%dx%d) from %d files"), *TargetFile, Width, Height, SourceFiles.Num());
+	return true;
+}
+
+FString GDALInterface::EscapeXML(const FString& Text)
+{
+	char* Escaped = CPLEscapeString(TCHAR_TO_UTF8(*Text), -1, CPLES_XML);
+	FString Result = UTF8_TO_TCHAR(Escaped);
+	CPLFree(Escaped);
+	return Result;
+}
+
 bool GDALInterface::SetCRSFromEPSG(OGRSpatialReference& InRs, int EPSG)
 {
 	OGRErr Err = InRs.importFromEPSG(EPSG);
 	if (Err != OGRERR_NONE)
 	{
-		FMessageDialog::Open(EAppMsgType::Ok,
+		ShowError(
 			FText::Format(
 				LOCTEXT("StartupModuleError1", "Could not create spatial reference from EPSG {0} (Error {1})."),
 				FText::AsNumber(EPSG, &FNumberFormattingOptions::DefaultNoGrouping()),
@@ -158,7 +306,7 @@ bool GDALInterface::SetCRSFromUserInput(OGRSpatialReference& InRs, FString CRS)
 	OGRErr Err = InRs.SetFromUserInput(TCHAR_TO_ANSI(*CRS));
 	if (Err != OGRERR_NONE)
 	{
-		FMessageDialog::Open(EAppMsgType::Ok,
+		ShowError(
 			FText::Format(
 				LOCTEXT("StartupModuleError1", "Could not create spatial reference from user input '{0}' (Error {1})."),
 				FText::FromString(CRS),
@@ -200,7 +348,7 @@ bool GDALInterface::GetCoordinates(FVector4d& Coordinates, TArray<FString> Files
 
 	if (Files.IsEmpty())
 	{
-		FMessageDialog::Open(EAppMsgType::Ok,
+		ShowError(
 			LOCTEXT("GetCoordinatesError", "GetCoordinates requires a non-empty array of files.")
 		);
 		return false;
@@ -208,10 +356,10 @@ bool GDALInterface::GetCoordinates(FVector4d& Coordinates, TArray<FString> Files
 
 	for (auto& File : Files)
 	{
-		GDALDataset *Dataset = (GDALDataset *)GDALOpen(TCHAR_TO_UTF8(*File), GA_ReadOnly);
-		if (!Dataset)
+		FRasterMetadata Metadata;
+		if (!DatasetPool::GetMetadata(File, Metadata))
 		{
-			FMessageDialog::Open(EAppMsgType::Ok,
+			ShowError(
 				FText::Format(
 					LOCTEXT("GetCoordinatesError", "Could not open heightmap file '{0}' to read the coordinates."),
 					FText::FromString(File)
@@ -221,10 +369,9 @@ bool GDALInterface::GetCoordinates(FVector4d& Coordinates, TArray<FString> Files
 		}
 
 		FVector4d FileCoordinates;
-		if (!GDALInterface::GetCoordinates(FileCoordinates, Dataset))
+		if (!Metadata.GetCoordinates(FileCoordinates))
 		{
-			GDALClose(Dataset);
-			FMessageDialog::Open(EAppMsgType::Ok,
+			ShowError(
 				FText::Format(
 					LOCTEXT("GetCoordinatesError", "Could not read coordinates from heightmap file '{0}'."),
 					FText::FromString(File)
@@ -232,7 +379,6 @@ bool GDALInterface::GetCoordinates(FVector4d& Coordinates, TArray<FString> Files
 			);
 			return false;
 		}
-		GDALClose(Dataset);
 		MinCoordWidth  = FMath::Min(MinCoordWidth, FileCoordinates[0]);
 		MaxCoordWidth  = FMath::Max(MaxCoordWidth, FileCoordinates[1]);
 		MinCoordHeight = FMath::Min(MinCoordHeight, FileCoordinates[2]);
@@ -256,9 +402,8 @@ bool GDALInterface::ConvertCoordinates(FVector4d& OriginalCoordinates, FVector4d
 	double xs[2] = { MinCoordWidth,  MaxCoordWidth  };
 	double ys[2] = { MaxCoordHeight, MinCoordHeight };
 
-	OGRSpatialReference InRs, OutRs;
-	if (!SetCRSFromUserInput(InRs, InCRS) || !SetCRSFromUserInput(OutRs, OutCRS) || !OGRCreateCoordinateTransformation(&InRs, &OutRs)->Transform(2, xs, ys)) {
-		FMessageDialog::Open(EAppMsgType::Ok,
+	if (!TransformRegistry::Transform(InCRS, OutCRS, 2, xs, ys)) {
+		ShowError(
 			LOCTEXT("GDALInterface::ConvertCoordinates", "Internal error while transforming coordinates.")
 		);
 		return false;
@@ -281,10 +426,9 @@ bool GDALInterface::ConvertCoordinates(FVector4d& OriginalCoordinates, bool bCro
 	double xs[4] = { MinCoordWidth,  MinCoordWidth,  MaxCoordWidth,  MaxCoordWidth };
 	double ys[4] = { MinCoordHeight, MaxCoordHeight, MaxCoordHeight, MinCoordHeight };
 	
-	OGRSpatialReference InRs, OutRs;
-	if (!SetCRSFromUserInput(InRs, InCRS) || !SetCRSFromUserInput(OutRs, OutCRS) || !OGRCreateCoordinateTransformation(&InRs, &OutRs)->Transform(4, xs, ys))
+	if (!TransformRegistry::Transform(InCRS, OutCRS, 4, xs, ys))
 	{
-		FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
+		ShowError(FText::Format(
 			LOCTEXT("GDALInterface::ConvertCoordinates", "Internal error while transforming coordinates between {0} and {1}."),
 			FText::FromString(InCRS),
 			FText::FromString(OutCRS)
@@ -312,10 +456,9 @@ bool GDALInterface::ConvertCoordinates(FVector4d& OriginalCoordinates, bool bCro
 
 bool GDALInterface::GetPixels(FIntPoint& Pixels, FString File)
 {
-	GDALDataset *Dataset = (GDALDataset *)GDALOpen(TCHAR_TO_UTF8(*File), GA_ReadOnly);
-
-	if (!Dataset) {
-		FMessageDialog::Open(EAppMsgType::Ok,
+	FRasterMetadata Metadata;
+	if (!DatasetPool::GetMetadata(File, Metadata)) {
+		ShowError(
 			FText::Format(LOCTEXT("GetInsidePixelsError", "Could not open heightmap file '{0}' to read its size."),
 				FText::FromString(File)
 			)
@@ -323,9 +466,8 @@ bool GDALInterface::GetPixels(FIntPoint& Pixels, FString File)
 		return false;
 	}
 
-	Pixels[0] = Dataset->GetRasterXSize();
-	Pixels[1] = Dataset->GetRasterYSize();
-	GDALClose(Dataset);
+	Pixels[0] = Metadata.Width;
+	Pixels[1] = Metadata.Height;
 	return true;
 }
 
@@ -334,38 +476,22 @@ bool GDALInterface::GetMinMax(FVector2D &MinMax, TArray<FString> Files)
 	MinMax[0] = DBL_MAX;
 	MinMax[1] = -DBL_MAX;
 
-	for (auto& File : Files) {
-
-		GDALDataset *Dataset = (GDALDataset *)GDALOpen(TCHAR_TO_UTF8(*File), GA_ReadOnly);
-
-		if (!Dataset)
-		{
-			FMessageDialog::Open(EAppMsgType::Ok,
-				FText::Format(LOCTEXT("GetMinMaxError", "Could not open heightmap file '{0}' to compute min/max altitudes.\n{1}"),
-					FText::FromString(File),
-					FText::FromString(FString(CPLGetLastErrorMsg()))
-				)
-			);
-			return false;
-		}
-		
-		double AdfMinMax[2];
-
-		if (GDALComputeRasterMinMax(Dataset->GetRasterBand(1), false, AdfMinMax) != CE_None)
-		{
-			FMessageDialog::Open(EAppMsgType::Ok,
-				FText::Format(LOCTEXT("GetMinMaxError2", "Could not compute min/max altitudes of file '{0}'.\n{1}"),
-					FText::FromString(File),
-					FText::FromString(FString(CPLGetLastErrorMsg()))
-				)
-			);
-			GDALClose(Dataset);
-			return false;
-		}
-		GDALClose(Dataset);
+	TArray<FRasterStatistics> Statistics;
+	FString FailedFile;
+	if (!RasterStatistics::Get(Files, Statistics, false, FailedFile))
+	{
+		ShowError(
+			FText::Format(LOCTEXT("GetMinMaxError2", "Could not compute min/max altitudes of file '{0}'.\nPlease check the output log for more details."),
+				FText::FromString(FailedFile)
+			)
+		);
+		return false;
+	}
 
-		MinMax[0] = FMath::Min(MinMax[0], AdfMinMax[0]);
-		MinMax[1] = FMath::Max(MinMax[1], AdfMinMax[1]);
+	for (auto& FileStatistics : Statistics)
+	{
+		MinMax[0] = FMath::Min(MinMax[0], FileStatistics.Min);
+		MinMax[1] = FMath::Max(MinMax[1], FileStatistics.Max);
 	}
 
 	return true;
@@ -416,7 +542,7 @@ bool GDALInterface::Translate(FString SourceFile, FString TargetFile, TArray<FSt
 
 	if (!SourceDataset)
 	{
-		FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
+		ShowError(FText::Format(
 			LOCTEXT("ConvertGDALOpenError", "Could not open file {0}."),
 			FText::FromString(SourceFile)
 		));
@@ -435,7 +561,7 @@ bool GDALInterface::Translate(FString SourceFile, FString TargetFile, TArray<FSt
 
 	if (!Options)
 	{
-		FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
+		ShowError(FText::Format(
 			LOCTEXT("ConvertParseOptionsError", "Internal GDAL error while parsing GDALTranslate options for file {0}."),
 			FText::FromString(SourceFile)
 		));
@@ -449,6 +575,7 @@ bool GDALInterface::Translate(FString SourceFile, FString TargetFile, TArray<FSt
 		*TargetFile
 	);
 
+	DatasetPool::Invalidate(TargetFile);
 	GDALDataset* DstDataset = (GDALDataset *) GDALTranslate(TCHAR_TO_UTF8(*TargetFile), SourceDataset, Options, nullptr);
 	GDALClose(SourceDataset);
 	GDALTranslateOptionsFree(Options);
@@ -457,7 +584,7 @@ bool GDALInterface::Translate(FString SourceFile, FString TargetFile, TArray<FSt
 	{
 		FString Error = FString(CPLGetLastErrorMsg());
 		UE_LOG(LogGDALInterface, Error, TEXT("Error while translating: %s to %s:\n"), *SourceFile, *TargetFile, *Error);
-		FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
+		ShowError(FText::Format(
 			LOCTEXT("ConvertGDALTranslateError",
 				"Internal GDALTranslate error while converting dataset from file {0} to PNG.\nIt is possible that the source image is not a heightmap.\n{1}"),
 			FText::FromString(SourceFile),
@@ -483,6 +610,8 @@ bool GDALInterface::Merge(TArray<FString> SourceFiles, FString TargetFile)
 		papszSrcDSNames = CSLAddString(papszSrcDSNames, TCHAR_TO_UTF8(*SourceFiles[i]));
 	}
 
+	DatasetPool::Invalidate(TargetFile);
+
 	int pbUsageError;
 	GDALDatasetH DatasetVRT = GDALBuildVRT(
 		TCHAR_TO_UTF8(*TargetFile),
@@ -495,7 +624,7 @@ bool GDALInterface::Merge(TArray<FString> SourceFiles, FString TargetFile)
 	
 	if (!DatasetVRT)
 	{
-		FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
+		ShowError(FText::Format(
 			LOCTEXT("GDALInterfaceMergeError", "Could not merge the files {0}. Error {1}."),
 			FText::FromString(FString::Join(SourceFiles, TEXT(", "))),
 			FText::AsNumber(pbUsageError, &FNumberFormattingOptions::DefaultNoGrouping())
@@ -510,11 +639,11 @@ bool GDALInterface::Merge(TArray<FString> SourceFiles, FString TargetFile)
 
 bool GDALInterface::ReadHeightmapFromFile(FString File, int& OutWidth, int& OutHeight, TArray<float>& OutHeightmap)
 {
-	GDALDataset* Dataset = (GDALDataset*)GDALOpen(TCHAR_TO_UTF8(*File), GA_ReadOnly);
+	DatasetPool::FDatasetRef Dataset = DatasetPool::Acquire(File);
 
 	if (!Dataset)
 	{
-		FMessageDialog::Open(EAppMsgType::Ok,
+		ShowError(
 			FText::Format(LOCTEXT("GDALInterface::ReadHeightsFromFile", "Could not open file '{0}' to read heightmap."),
 				FText::FromString(File)
 			)
@@ -522,9 +651,9 @@ bool GDALInterface::ReadHeightmapFromFile(FString File, int& OutWidth, int& OutH
 		return false;
 	}
 
-	OutWidth = Dataset->GetRasterXSize();
-	OutHeight = Dataset->GetRasterYSize();
-	int NumBands = Dataset->GetRasterCount();
+	OutWidth = (*Dataset)->GetRasterXSize();
+	OutHeight = (*Dataset)->GetRasterYSize();
+	int NumBands = (*Dataset)->GetRasterCount();
 
 	if (NumBands != 1)
 	{
@@ -534,19 +663,24 @@ bool GDALInterface::ReadHeightmapFromFile(FString File, int& OutWidth, int& OutH
 
 	UE_LOG(LogGDALInterface, Log, TEXT("Reading heightmap from image %s of size %d x %d"), *File, OutWidth, OutHeight);
 
-	float* Buffer = new float[OutWidth * OutHeight];
-	Dataset->GetRasterBand(1)->RasterIO(GF_Read, 0, 0, OutWidth, OutHeight, Buffer, OutWidth, OutHeight, GDT_Float32, 0, 0);
-
 	OutHeightmap.Reset();
-	OutHeightmap.SetNum(OutWidth * OutHeight);
+	OutHeightmap.SetNumUninitialized(OutWidth * OutHeight);
 
-	for (int i = 0; i < OutWidth; i++)
+	// windows are aligned on the blocks of the file, and only one of them is held besides the output
+	bool bSuccess = RasterBlocks::ForEachWindow<float>((*Dataset)->GetRasterBand(1), 0, false, false, [&](const FRasterWindow& Window, TRasterView<float>& View)
 	{
-		for (int j = 0; j < OutHeight; j++)
+		const int32 Width = Window.Core.Width();
+		for (int32 Y = Window.Core.Min.Y; Y < Window.Core.Max.Y; Y++)
 		{
-			const int k = i + j * OutWidth;
-			OutHeightmap[k] = Buffer[k];
+			FMemory::Memcpy(&OutHeightmap[Window.Core.Min.X + Y * OutWidth], &View(Window.Core.Min.X, Y), Width * sizeof(float));
 		}
+		return true;
+	});
+
+	if (!bSuccess)
+	{
+		UE_LOG(LogGDALInterface, Error, TEXT("Could not read heightmap from %s: %s"), *File, UTF8_TO_TCHAR(CPLGetLastErrorMsg()));
+		return false;
 	}
 
 	return true;
@@ -554,11 +688,11 @@ bool GDALInterface::ReadHeightmapFromFile(FString File, int& OutWidth, int& OutH
 
 bool GDALInterface::ReadColorsFromFile(FString File, int &OutWidth, int &OutHeight, TArray<FColor> &OutColors)
 {
-	GDALDataset *Dataset = (GDALDataset *)GDALOpen(TCHAR_TO_UTF8(*File), GA_ReadOnly);
+	DatasetPool::FDatasetRef Dataset = DatasetPool::Acquire(File);
 
 	if (!Dataset)
 	{
-		FMessageDialog::Open(EAppMsgType::Ok,
+		ShowError(
 			FText::Format(LOCTEXT("GDALInterface::ReadTextureFromFile", "Could not open file '{0}' to create a texture."),
 				FText::FromString(File)
 			)
@@ -566,55 +700,38 @@ bool GDALInterface::ReadColorsFromFile(FString File, int &OutWidth, int &OutHeig
 		return false;
 	}
 	
-	OutWidth = Dataset->GetRasterXSize();
-	OutHeight = Dataset->GetRasterYSize();
-	int NumBands = Dataset->GetRasterCount();
+	OutWidth = (*Dataset)->GetRasterXSize();
+	OutHeight = (*Dataset)->GetRasterYSize();
+	int NumBands = (*Dataset)->GetRasterCount();
 	
 	UE_LOG(LogGDALInterface, Log, TEXT("Reading colors from image %s of size %d x %d with %d band(s)"), *File, OutWidth, OutHeight, NumBands);
 
-	uint8_t* RedBuffer = nullptr;
-	uint8_t* GreenBuffer = nullptr;
-	uint8_t* BlueBuffer = nullptr;
-	uint8_t* AlphaBuffer = nullptr;
-
-	if (NumBands >= 1)
-	{
-		RedBuffer = new uint8_t[OutWidth * OutHeight];
-		Dataset->GetRasterBand(1)->RasterIO(GF_Read, 0, 0, OutWidth, OutHeight, RedBuffer, OutWidth, OutHeight, GDT_Byte, 0, 0);
-	}
-
-	if (NumBands >= 2)
-	{
-		GreenBuffer = new uint8_t[OutWidth * OutHeight];
-		Dataset->GetRasterBand(2)->RasterIO(GF_Read, 0, 0, OutWidth, OutHeight, GreenBuffer, OutWidth, OutHeight, GDT_Byte, 0, 0);
-	}
+	OutColors.Reset();
+	OutColors.Init(FColor::Black, OutWidth * OutHeight);
+	if (OutColors.IsEmpty()) return true;
 
-	if (NumBands >= 3)
-	{
-		BlueBuffer = new uint8_t[OutWidth * OutHeight];
-		Dataset->GetRasterBand(3)->RasterIO(GF_Read, 0, 0, OutWidth, OutHeight, BlueBuffer, OutWidth, OutHeight, GDT_Byte, 0, 0);
-	}
+	// each band is read window by window into its channel of the output
+	uint8 FColor::* Channels[] = { &FColor::R, &FColor::G, &FColor::B, &FColor::A };
 
-	if (NumBands >= 4)
+	for (int Band = 1; Band <= FMath::Min(NumBands, 4); Band++)
 	{
-		AlphaBuffer = new uint8_t[OutWidth * OutHeight];
-		Dataset->GetRasterBand(4)->RasterIO(GF_Read, 0, 0, OutWidth, OutHeight, AlphaBuffer, OutWidth, OutHeight, GDT_Byte, 0, 0);
-	}
-
-	OutColors.Reset();
-	OutColors.SetNum(OutWidth * OutHeight);
+		uint8 FColor::* Channel = Channels[Band - 1];
+		bool bSuccess = RasterBlocks::ForEachWindow<uint8>((*Dataset)->GetRasterBand(Band), 0, false, false, [&](const FRasterWindow& Window, TRasterView<uint8>& View)
+		{
+			for (int32 Y = Window.Core.Min.Y; Y < Window.Core.Max.Y; Y++)
+			{
+				for (int32 X = Window.Core.Min.X; X < Window.Core.Max.X; X++)
+				{
+					OutColors[X + Y * OutWidth].*Channel = View(X, Y);
+				}
+			}
+			return true;
+		});
 
-	for (int i = 0; i < OutWidth; i++)
-	{
-		for (int j = 0; j < OutHeight; j++)
+		if (!bSuccess)
 		{
-			FColor Color;
-			int k = i + j * OutWidth;
-			if (NumBands >= 1) Color.R = RedBuffer[k];
-			if (NumBands >= 2) Color.G = GreenBuffer[k];
-			if (NumBands >= 3) Color.B = BlueBuffer[k];
-			if (NumBands >= 4) Color.A = AlphaBuffer[k];
-			OutColors[k] = Color;
+			UE_LOG(LogGDALInterface, Error, TEXT("Could not read band %d from %s: %s"), Band, *File, UTF8_TO_TCHAR(CPLGetLastErrorMsg()));
+			return false;
 		}
 	}
 
@@ -645,7 +762,7 @@ bool GDALInterface::Warp(FString SourceFile, FString TargetFile, TArray<FString>
 
 	if (!SrcDataset)
 	{
-		FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
+		ShowError(FText::Format(
 			LOCTEXT("GDALWarpOpenError", "Could not open file {0}.\n{1}"),
 			FText::FromString(SourceFile),
 			FText::FromString(FString(CPLGetLastErrorMsg()))
@@ -667,7 +784,7 @@ bool GDALInterface::Warp(FString SourceFile, FString TargetFile, TArray<FString>
 
 	if (!Options)
 	{
-		FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
+		ShowError(FText::Format(
 			LOCTEXT("GDALWarpError", "Could not parse gdalwarp options for file {0}.\nError: {1}"),
 			FText::FromString(SourceFile),
 			FText::FromString(FString(CPLGetLastErrorMsg()))
@@ -677,13 +794,15 @@ bool GDALInterface::Warp(FString SourceFile, FString TargetFile, TArray<FString>
 		return false;
 	}
 
+	DatasetPool::Invalidate(TargetFile);
+
 	int WarpError = 0;
 	GDALDataset* WarpedDataset = (GDALDataset*) GDALWarp(TCHAR_TO_UTF8(*TargetFile), nullptr, 1, &SrcDataset, Options, &WarpError);
 	GDALClose(SrcDataset);
 
 	if (!WarpedDataset)
 	{
-		FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
+		ShowError(FText::Format(
 			LOCTEXT("GDALWarpError", "Internal GDALWarp error ({0}):\n{1}"),
 			FText::AsNumber(WarpError, &FNumberFormattingOptions::DefaultNoGrouping()),
 			FText::FromString(FString(CPLGetLastErrorMsg()))
@@ -851,4 +970,31 @@ TArray<FPointList> GDALInterface::GetPointLists(GDALDataset *Dataset)
 }
 
 
+void GDALInterface::SetCacheMax(int32 CacheMaxMB)
+{
+	if (CacheMaxMB <= 0) return;
+
+	GIntBig CacheMax = (GIntBig) CacheMaxMB * 1024 * 1024;
+	if (GDALGetCacheMax64() != CacheMax)
+	{
+		UE_LOG(LogGDALInterface, Log, TEXT("Setting GDAL cache size to %d MB"), CacheMaxMB);
+		GDALSetCacheMax64(CacheMax);
+	}
+}
+
+void GDALInterface::ShowError(const FText& Message)
+{
+	if (IsInGameThread())
+	{
+		FMessageDialog::Open(EAppMsgType::Ok, Message);
+		return;
+	}
+
+	UE_LOG(LogGDALInterface, Error, TEXT("%s"), *Message.ToString());
+	AsyncTask(ENamedThreads::GameThread, [Message]()
+	{
+		FMessageDialog::Open(EAppMsgType::Ok, Message);
+	});
+}
+
 #undef LOCTEXT_NAMESPACE
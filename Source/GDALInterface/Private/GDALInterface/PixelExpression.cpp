@@ -0,0 +1,517 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "GDALInterface/PixelExpression.h"
+
+#include <limits>
+
+// Recursive descent parser that emits one instruction per operation, folding the operations on constants.
+// Comparisons produce masks (all bits set when true), which are converted to 1 or 0 when used as numbers.
+class FPixelExpressionParser
+{
+public:
+	FPixelExpressionParser(const FString& Text0, FPixelExpression& Expression0) : Text(Text0), Expression(Expression0) {}
+
+	bool Parse(FString& OutError)
+	{
+		Expression.Text = Text;
+		Expression.NumRegisters = 1;
+		Expression.Constants.Empty();
+		Expression.Instructions.Empty();
+
+		FValue Result;
+		if (!ParseConditional(Result)) return Fail(OutError);
+
+		SkipSpaces();
+		if (Position < Text.Len())
+		{
+			Error = FString::Printf(TEXT("unexpected '%c'"), Text[Position]);
+			return Fail(OutError);
+		}
+
+		Result = ToNumber(Result);
+		if (Result.bConstant) Result = Materialize(Result);
+		Expression.ResultRegister = Result.Register;
+		return true;
+	}
+
+private:
+	using EOp = FPixelExpression::EOp;
+
+	struct FValue
+	{
+		int32 Register = -1;
+		bool bMask = false;
+		bool bConstant = false;
+		float Constant = 0;
+	};
+
+	const FString& Text;
+	FPixelExpression& Expression;
+	int32 Position = 0;
+	FString Error;
+
+	bool Fail(FString& OutError)
+	{
+		OutError = FString::Printf(TEXT("Invalid expression '%s' at character %d: %s"), *Text, Position + 1, *Error);
+		Expression.ResultRegister = -1;
+		return false;
+	}
+
+	void SkipSpaces()
+	{
+		while (Position < Text.Len() && FChar::IsWhitespace(Text[Position])) Position++;
+	}
+
+	bool Match(const TCHAR* Token)
+	{
+		SkipSpaces();
+		int32 Length = FCString::Strlen(Token);
+		if (FCString::Strncmp(*Text + Position, Token, Length) != 0) return false;
+		Position += Length;
+		return true;
+	}
+
+	bool Expect(const TCHAR* Token)
+	{
+		if (Match(Token)) return true;
+		Error = FString::Printf(TEXT("expected '%s'"), Token);
+		return false;
+	}
+
+	static FValue Constant(float Value, bool bMask = false)
+	{
+		FValue Result;
+		Result.bConstant = true;
+		Result.bMask = bMask;
+		Result.Constant = Value;
+		return Result;
+	}
+
+	FValue Materialize(FValue Value)
+	{
+		if (!Value.bConstant) return Value;
+
+		// masks are stored with all bits set when true, like the results of vector comparisons
+		if (Value.bMask)
+		{
+			uint32 Bits = Value.Constant != 0 ? 0xFFFFFFFF : 0;
+			FMemory::Memcpy(&Value.Constant, &Bits, sizeof(float));
+		}
+
+		for (auto& [Register, Constant] : Expression.Constants)
+		{
+			if (FMemory::Memcmp(&Constant, &Value.Constant, sizeof(float)) == 0)
+			{
+				Value.Register = Register;
+				Value.bConstant = false;
+				return Value;
+			}
+		}
+
+		Value.Register = Expression.NumRegisters++;
+		Value.bConstant = false;
+		Expression.Constants.Add({ Value.Register, Value.Constant });
+		return Value;
+	}
+
+	FValue Emit(EOp Op, bool bMask, FValue A, FValue B = FValue(), FValue C = FValue())
+	{
+		bool bUsesB = B.Register >= 0 || B.bConstant;
+		bool bUsesC = C.Register >= 0 || C.bConstant;
+		if (A.bConstant && (!bUsesB || B.bConstant) && (!bUsesC || C.bConstant))
+		{
+			return Constant(FPixelExpression::EvaluateScalar(Op, A.Constant, B.Constant, C.Constant), bMask);
+		}
+
+		FPixelExpression::FInstruction Instruction { Op, Expression.NumRegisters++ };
+		Instruction.A = Materialize(A).Register;
+		if (bUsesB) Instruction.B = Materialize(B).Register;
+		if (bUsesC) Instruction.C = Materialize(C).Register;
+		Expression.Instructions.Add(Instruction);
+
+		FValue Result;
+		Result.Register = Instruction.Result;
+		Result.bMask = bMask;
+		return Result;
+	}
+
+	FValue ToNumber(FValue Value)
+	{
+		if (!Value.bMask) return Value;
+		return Emit(EOp::MaskToNumber, false, Value);
+	}
+
+	FValue ToMask(FValue Value)
+	{
+		if (Value.bMask) return Value;
+		return Emit(EOp::NotEqual, true, Value, Constant(0));
+	}
+
+	bool ParseConditional(FValue& Out)
+	{
+		if (!ParseOr(Out)) return false;
+		if (!Match(TEXT("?"))) return true;
+
+		FValue Then, Else;
+		if (!ParseConditional(Then) || !Expect(TEXT(":")) || !ParseConditional(Else)) return false;
+
+		FValue Condition = ToMask(Out);
+		if (Condition.bConstant)
+		{
+			Out = Condition.Constant != 0 ? Then : Else;
+		}
+		else if (Then.bMask && Else.bMask)
+		{
+			Out = Emit(EOp::Select, true, Condition, Then, Else);
+		}
+		else
+		{
+			Out = Emit(EOp::Select, false, Condition, ToNumber(Then), ToNumber(Else));
+		}
+		return true;
+	}
+
+	bool ParseOr(FValue& Out)
+	{
+		if (!ParseAnd(Out)) return false;
+		while (Match(TEXT("||")))
+		{
+			FValue Right;
+			if (!ParseAnd(Right)) return false;
+			Out = Logical(EOp::Or, ToMask(Out), ToMask(Right));
+		}
+		return true;
+	}
+
+	bool ParseAnd(FValue& Out)
+	{
+		if (!ParseComparison(Out)) return false;
+		while (Match(TEXT("&&")))
+		{
+			FValue Right;
+			if (!ParseComparison(Right)) return false;
+			Out = Logical(EOp::And, ToMask(Out), ToMask(Right));
+		}
+		return true;
+	}
+
+	// `true && m` is `m`, `false && m` is `false`, and so on, so that constant masks never need a register
+	FValue Logical(EOp Op, FValue A, FValue B)
+	{
+		if (B.bConstant) Swap(A, B);
+		if (A.bConstant && !B.bConstant)
+		{
+			bool bAbsorbing = Op == EOp::And ? A.Constant == 0 : A.Constant != 0;
+			return bAbsorbing ? A : B;
+		}
+		return Emit(Op, true, A, B);
+	}
+
+	bool ParseComparison(FValue& Out)
+	{
+		if (!ParseAdditive(Out)) return false;
+
+		static const TPair<const TCHAR*, EOp> Operators[] = {
+			{ TEXT("=="), EOp::Equal }, { TEXT("!="), EOp::NotEqual },
+			{ TEXT("<="), EOp::LessEqual }, { TEXT(">="), EOp::GreaterEqual },
+			{ TEXT("<"), EOp::Less }, { TEXT(">"), EOp::Greater }
+		};
+
+		for (auto& [Token, Op] : Operators)
+		{
+			if (Match(Token))
+			{
+				FValue Right;
+				if (!ParseAdditive(Right)) return false;
+				Out = Emit(Op, true, ToNumber(Out), ToNumber(Right));
+				return true;
+			}
+		}
+		return true;
+	}
+
+	bool ParseAdditive(FValue& Out)
+	{
+		if (!ParseMultiplicative(Out)) return false;
+		while (true)
+		{
+			EOp Op;
+			if (Match(TEXT("+"))) Op = EOp::Add;
+			else if (Match(TEXT("-"))) Op = EOp::Subtract;
+			else return true;
+
+			FValue Right;
+			if (!ParseMultiplicative(Right)) return false;
+			Out = Emit(Op, false, ToNumber(Out), ToNumber(Right));
+		}
+	}
+
+	bool ParseMultiplicative(FValue& Out)
+	{
+		if (!ParseUnary(Out)) return false;
+		while (true)
+		{
+			EOp Op;
+			if (Match(TEXT("*"))) Op = EOp::Multiply;
+			else if (Match(TEXT("/"))) Op = EOp::Divide;
+			else return true;
+
+			FValue Right;
+			if (!ParseUnary(Right)) return false;
+			Out = Emit(Op, false, ToNumber(Out), ToNumber(Right));
+		}
+	}
+
+	bool ParseUnary(FValue& Out)
+	{
+		if (Match(TEXT("-")))
+		{
+			if (!ParseUnary(Out)) return false;
+			Out = Emit(EOp::Negate, false, ToNumber(Out));
+			return true;
+		}
+
+		// `!` but not `!=`, which cannot start an operand anyway
+		if (Match(TEXT("!")))
+		{
+			if (!ParseUnary(Out)) return false;
+			FValue Mask = ToMask(Out);
+			Out = Mask.bConstant ? Constant(Mask.Constant == 0, true) : Emit(EOp::Not, true, Mask);
+			return true;
+		}
+
+		return ParsePrimary(Out);
+	}
+
+	bool ParsePrimary(FValue& Out)
+	{
+		SkipSpaces();
+		if (Position >= Text.Len())
+		{
+			Error = "unexpected end of expression";
+			return false;
+		}
+
+		if (Match(TEXT("(")))
+		{
+			return ParseConditional(Out) && Expect(TEXT(")"));
+		}
+
+		const TCHAR* Start = *Text + Position;
+		if (FChar::IsDigit(*Start) || *Start == '.')
+		{
+			TCHAR* End = nullptr;
+			double Value = FCString::Strtod(Start, &End);
+			if (End == Start)
+			{
+				Error = "invalid number";
+				return false;
+			}
+			Position += End - Start;
+			Out = Constant((float) Value);
+			return true;
+		}
+
+		int32 NameLength = 0;
+		while (Position + NameLength < Text.Len() && (FChar::IsAlpha(Text[Position + NameLength]) || Text[Position + NameLength] == '_'))
+		{
+			NameLength++;
+		}
+
+		if (NameLength == 0)
+		{
+			Error = FString::Printf(TEXT("unexpected '%c'"), Text[Position]);
+			return false;
+		}
+
+		FString Name = Text.Mid(Position, NameLength).ToLower();
+		Position += NameLength;
+
+		if (Name == "x")
+		{
+			Out = FValue();
+			Out.Register = 0;
+			return true;
+		}
+		if (Name == "nan")
+		{
+			Out = Constant(std::numeric_limits<float>::quiet_NaN());
+			return true;
+		}
+		if (Name == "inf")
+		{
+			Out = Constant(std::numeric_limits<float>::infinity());
+			return true;
+		}
+
+		static const TMap<FString, TPair<EOp, int32>> Functions = {
+			{ "min", { EOp::Min, 2 } },
+			{ "max", { EOp::Max, 2 } },
+			{ "abs", { EOp::Abs, 1 } },
+			{ "isnan", { EOp::IsNaN, 1 } },
+			{ "clamp", { EOp::Min, 3 } }
+		};
+
+		const TPair<EOp, int32>* Function = Functions.Find(Name);
+		if (!Function)
+		{
+			Error = FString::Printf(TEXT("unknown name '%s'"), *Name);
+			return false;
+		}
+
+		TArray<FValue> Arguments;
+		if (!Expect(TEXT("("))) return false;
+		for (int32 i = 0; i < Function->Value; i++)
+		{
+			FValue Argument;
+			if ((i > 0 && !Expect(TEXT(","))) || !ParseConditional(Argument)) return false;
+			Arguments.Add(ToNumber(Argument));
+		}
+		if (!Expect(TEXT(")"))) return false;
+
+		if (Name == "clamp")
+		{
+			Out = Emit(EOp::Min, false, Emit(EOp::Max, false, Arguments[0], Arguments[1]), Arguments[2]);
+		}
+		else if (Function->Value == 2)
+		{
+			Out = Emit(Function->Key, false, Arguments[0], Arguments[1]);
+		}
+		else
+		{
+			Out = Emit(Function->Key, Function->Key == EOp::IsNaN, Arguments[0]);
+		}
+		return true;
+	}
+};
+
+bool FPixelExpression::Compile(const FString& Text, FPixelExpression& OutExpression, FString& OutError)
+{
+	return FPixelExpressionParser(Text, OutExpression).Parse(OutError);
+}
+
+float FPixelExpression::EvaluateScalar(EOp Op, float A, float B, float C)
+{
+	switch (Op)
+	{
+	case EOp::Add:          return A + B;
+	case EOp::Subtract:     return A - B;
+	case EOp::Multiply:     return A * B;
+	case EOp::Divide:       return A / B;
+	case EOp::Negate:       return -A;
+	case EOp::Min:          return FMath::Min(A, B);
+	case EOp::Max:          return FMath::Max(A, B);
+	case EOp::Abs:          return FMath::Abs(A);
+	case EOp::Equal:        return A == B;
+	case EOp::NotEqual:     return A != B;
+	case EOp::Less:         return A < B;
+	case EOp::LessEqual:    return A <= B;
+	case EOp::Greater:      return A > B;
+	case EOp::GreaterEqual: return A >= B;
+	case EOp::IsNaN:        return FMath::IsNaN(A);
+	case EOp::And:          return A != 0 && B != 0;
+	case EOp::Or:           return A != 0 || B != 0;
+	case EOp::Not:          return A == 0;
+	case EOp::Select:       return A != 0 ? B : C;
+	case EOp::MaskToNumber: return A;
+	}
+	return 0;
+}
+
+template<typename FOp>
+static FORCEINLINE void ForEachVector(int32 NumVectors, FOp Op)
+{
+	for (int32 v = 0; v < NumVectors; v++) Op(v);
+}
+
+void FPixelExpression::Run(VectorRegister4Float* Registers, int32 NumVectors) const
+{
+	constexpr int32 VectorsPerRegister = ChunkSize / 4;
+	const VectorRegister4Float AllBits = VectorCompareEQ(VectorZero(), VectorZero());
+
+	for (const FInstruction& Instruction : Instructions)
+	{
+		VectorRegister4Float* R = Registers + Instruction.Result * VectorsPerRegister;
+		const VectorRegister4Float* A = Registers + Instruction.A * VectorsPerRegister;
+		const VectorRegister4Float* B = Registers + FMath::Max(0, Instruction.B) * VectorsPerRegister;
+		const VectorRegister4Float* C = Registers + FMath::Max(0, Instruction.C) * VectorsPerRegister;
+
+		// comparisons are ordered: they are false when an operand is NaN, except NotEqual
+		switch (Instruction.Op)
+		{
+		case EOp::Add:          ForEachVector(NumVectors, [&](int32 v) { R[v] = VectorAdd(A[v], B[v]); }); break;
+		case EOp::Subtract:     ForEachVector(NumVectors, [&](int32 v) { R[v] = VectorSubtract(A[v], B[v]); }); break;
+		case EOp::Multiply:     ForEachVector(NumVectors, [&](int32 v) { R[v] = VectorMultiply(A[v], B[v]); }); break;
+		case EOp::Divide:       ForEachVector(NumVectors, [&](int32 v) { R[v] = VectorDivide(A[v], B[v]); }); break;
+		case EOp::Negate:       ForEachVector(NumVectors, [&](int32 v) { R[v] = VectorNegate(A[v]); }); break;
+		case EOp::Min:          ForEachVector(NumVectors, [&](int32 v) { R[v] = VectorMin(A[v], B[v]); }); break;
+		case EOp::Max:          ForEachVector(NumVectors, [&](int32 v) { R[v] = VectorMax(A[v], B[v]); }); break;
+		case EOp::Abs:          ForEachVector(NumVectors, [&](int32 v) { R[v] = VectorAbs(A[v]); }); break;
+		case EOp::Equal:        ForEachVector(NumVectors, [&](int32 v) { R[v] = VectorCompareEQ(A[v], B[v]); }); break;
+		case EOp::NotEqual:     ForEachVector(NumVectors, [&](int32 v) { R[v] = VectorCompareNE(A[v], B[v]); }); break;
+		case EOp::Less:         ForEachVector(NumVectors, [&](int32 v) { R[v] = VectorCompareGT(B[v], A[v]); }); break;
+		case EOp::LessEqual:    ForEachVector(NumVectors, [&](int32 v) { R[v] = VectorCompareGE(B[v], A[v]); }); break;
+		case EOp::Greater:      ForEachVector(NumVectors, [&](int32 v) { R[v] = VectorCompareGT(A[v], B[v]); }); break;
+		case EOp::GreaterEqual: ForEachVector(NumVectors, [&](int32 v) { R[v] = VectorCompareGE(A[v], B[v]); }); break;
+		case EOp::IsNaN:        ForEachVector(NumVectors, [&](int32 v) { R[v] = VectorCompareNE(A[v], A[v]); }); break;
+		case EOp::And:          ForEachVector(NumVectors, [&](int32 v) { R[v] = VectorBitwiseAnd(A[v], B[v]); }); break;
+		case EOp::Or:           ForEachVector(NumVectors, [&](int32 v) { R[v] = VectorBitwiseOr(A[v], B[v]); }); break;
+		case EOp::Not:          ForEachVector(NumVectors, [&](int32 v) { R[v] = VectorBitwiseXor(A[v], AllBits); }); break;
+		case EOp::Select:       ForEachVector(NumVectors, [&](int32 v) { R[v] = VectorSelect(A[v], B[v], C[v]); }); break;
+		case EOp::MaskToNumber: ForEachVector(NumVectors, [&](int32 v) { R[v] = VectorBitwiseAnd(A[v], VectorOne()); }); break;
+		}
+	}
+}
+
+void FPixelExpression::Evaluate(float* Values, int64 Count) const
+{
+	if (!IsValid() || Count <= 0) return;
+
+	constexpr int32 VectorsPerRegister = ChunkSize / 4;
+
+	TArray<VectorRegister4Float> Registers;
+	Registers.SetNumUninitialized(NumRegisters * VectorsPerRegister);
+
+	for (auto& [Register, Value] : Constants)
+	{
+		VectorRegister4Float Constant = VectorSetFloat1(Value);
+		for (int32 v = 0; v < VectorsPerRegister; v++) Registers[Register * VectorsPerRegister + v] = Constant;
+	}
+
+	VectorRegister4Float* X = Registers.GetData();
+	const VectorRegister4Float* Result = Registers.GetData() + ResultRegister * VectorsPerRegister;
+
+	for (int64 Start = 0; Start < Count; Start += ChunkSize)
+	{
+		float* Chunk = Values + Start;
+		const int32 Num = (int32) FMath::Min<int64>(ChunkSize, Count - Start);
+		const int32 NumFull = Num / 4;
+		const int32 Remainder = Num % 4;
+
+		for (int32 v = 0; v < NumFull; v++) X[v] = VectorLoad(Chunk + 4 * v);
+
+		// the last vector is padded with zeros, and only its first values are stored back
+		alignas(16) float Tail[4] = { 0, 0, 0, 0 };
+		if (Remainder)
+		{
+			FMemory::Memcpy(Tail, Chunk + 4 * NumFull, Remainder * sizeof(float));
+			X[NumFull] = VectorLoadAligned(Tail);
+		}
+
+		Run(Registers.GetData(), NumFull + (Remainder ? 1 : 0));
+
+		for (int32 v = 0; v < NumFull; v++) VectorStore(Result[v], Chunk + 4 * v);
+
+		if (Remainder)
+		{
+			VectorStoreAligned(Result[NumFull], Tail);
+			FMemory::Memcpy(Chunk + 4 * NumFull, Tail, Remainder * sizeof(float));
+		}
+	}
+}
+
+float FPixelExpression::Evaluate(float X) const
+{
+	Evaluate(&X, 1);
+	return X;
+}
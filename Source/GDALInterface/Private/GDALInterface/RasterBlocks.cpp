@@ -0,0 +1,60 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "GDALInterface/RasterBlocks.h"
+#include "GDALInterface/DatasetPool.h"
+#include "GDALInterface/LogGDALInterface.h"
+
+FGDALDatasetHandle FGDALDatasetHandle::Open(FString File, bool bUpdate)
+{
+	// pooled read-only datasets would not see the changes
+	if (bUpdate) DatasetPool::Invalidate(File);
+
+	return FGDALDatasetHandle((GDALDataset*) GDALOpen(TCHAR_TO_UTF8(*File), bUpdate ? GA_Update : GA_ReadOnly));
+}
+
+TArray<FRasterWindow> RasterBlocks::GetWindows(GDALRasterBand* Band, int32 Halo, int64 MinPixels)
+{
+	const int32 SizeX = Band->GetXSize();
+	const int32 SizeY = Band->GetYSize();
+
+	int BlockX, BlockY;
+	Band->GetBlockSize(&BlockX, &BlockY);
+	BlockX = FMath::Clamp(BlockX, 1, FMath::Max(1, SizeX));
+	BlockY = FMath::Clamp(BlockY, 1, FMath::Max(1, SizeY));
+
+	const int64 BlockPixels = (int64) BlockX * BlockY;
+	if (BlockPixels < MinPixels)
+	{
+		if (BlockX >= SizeX)
+		{
+			// scanlines: take several rows at once
+			BlockY = (int) FMath::Min<int64>(SizeY, BlockY * FMath::DivideAndRoundUp<int64>(MinPixels, BlockPixels));
+		}
+		else
+		{
+			const int32 Factor = FMath::CeilToInt(FMath::Sqrt((double) MinPixels / BlockPixels));
+			BlockX = FMath::Min(SizeX, BlockX * Factor);
+			BlockY = FMath::Min(SizeY, BlockY * Factor);
+		}
+	}
+
+	TArray<FRasterWindow> Windows;
+	for (int32 Y = 0; Y < SizeY; Y += BlockY)
+	{
+		for (int32 X = 0; X < SizeX; X += BlockX)
+		{
+			FRasterWindow Window;
+			Window.Core = FIntRect(X, Y, FMath::Min(X + BlockX, SizeX), FMath::Min(Y + BlockY, SizeY));
+			Window.Read = FIntRect(
+				FMath::Max(0, Window.Core.Min.X - Halo),
+				FMath::Max(0, Window.Core.Min.Y - Halo),
+				FMath::Min(SizeX, Window.Core.Max.X + Halo),
+				FMath::Min(SizeY, Window.Core.Max.Y + Halo)
+			);
+			Windows.Add(Window);
+		}
+	}
+
+	UE_LOG(LogGDALInterface, Verbose, TEXT("Split raster of size %d x %d into %d windows of %d x %d"), SizeX, SizeY, Windows.Num(), BlockX, BlockY);
+	return Windows;
+}
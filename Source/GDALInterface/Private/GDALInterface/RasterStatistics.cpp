@@ -0,0 +1,299 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "GDALInterface/RasterStatistics.h"
+#include "GDALInterface/LogGDALInterface.h"
+#include "GDALInterface/RasterBlocks.h"
+
+#include "ConcurrencyHelpers/AppendOnlyManifest.h"
+
+#include "Async/ParallelFor.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+static bool IsPersistent(const FString& File)
+{
+	return !File.StartsWith("/vsimem/");
+}
+
+bool RasterStatistics::Get(const TArray<FString>& Files, TArray<FRasterStatistics>& OutStatistics, bool bWithHistogram, FString& OutFailedFile)
+{
+	OutStatistics.Reset();
+	OutStatistics.SetNum(Files.Num());
+
+	TArray<FString> NormalizedFiles;
+	TArray<FFileStamp> Stamps;
+	TArray<int32> Missing;
+
+	for (int32 i = 0; i < Files.Num(); i++)
+	{
+		FString File = Files[i];
+		FPaths::NormalizeFilename(File);
+		NormalizedFiles.Add(File);
+
+		// the stamp is taken before computing, so that a file modified in the meantime is computed again next time
+		FFileStamp Stamp;
+		bool bHasStamp = FFileStamp::Get(File, Stamp);
+		Stamps.Add(Stamp);
+
+		FScopeLock ScopeLock(&Lock);
+		FCachedStatistics* Cached = Cache.Find(File);
+		if (bHasStamp && Cached && Cached->Stamp == Stamp && (!bWithHistogram || !Cached->Statistics.Histogram.IsEmpty()))
+		{
+			OutStatistics[i] = Cached->Statistics;
+		}
+		else
+		{
+			Missing.Add(i);
+		}
+	}
+
+	if (Missing.IsEmpty()) return true;
+
+	UE_LOG(LogGDALInterface, Log, TEXT("Computing statistics of %d files (%d were cached)"), Missing.Num(), Files.Num() - Missing.Num());
+
+	// files are processed in parallel, or the windows of the file when there is only one
+	TArray<bool> Successes;
+	Successes.Init(false, Missing.Num());
+	ParallelFor(Missing.Num(), [&](int32 j)
+	{
+		int32 i = Missing[j];
+		Successes[j] = Compute(NormalizedFiles[i], bWithHistogram, Missing.Num() == 1, OutStatistics[i]);
+	});
+
+	bool bAllSuccessful = true;
+	FScopeLock ScopeLock(&Lock);
+	for (int32 j = 0; j < Missing.Num(); j++)
+	{
+		int32 i = Missing[j];
+		if (!Successes[j])
+		{
+			if (bAllSuccessful) OutFailedFile = Files[i];
+			bAllSuccessful = false;
+			continue;
+		}
+
+		FCachedStatistics Cached { OutStatistics[i], Stamps[i] };
+		Cache.Add(NormalizedFiles[i], Cached);
+		if (IsPersistent(NormalizedFiles[i])) Manifest().Add(NormalizedFiles[i], ToFields(Cached));
+	}
+
+	return bAllSuccessful;
+}
+
+bool RasterStatistics::Compute(const FString& File, bool bWithHistogram, bool bParallel, FRasterStatistics& OutStatistics)
+{
+	DatasetPool::FDatasetRef Dataset = DatasetPool::Acquire(File);
+	if (!Dataset)
+	{
+		UE_LOG(LogGDALInterface, Error, TEXT("Could not open '%s' to compute its statistics: %s"), *File, UTF8_TO_TCHAR(CPLGetLastErrorMsg()));
+		return false;
+	}
+
+	GDALRasterBand* Band = (*Dataset)->GetRasterBand(1);
+	if (!Band)
+	{
+		UE_LOG(LogGDALInterface, Error, TEXT("Could not compute statistics of '%s' as it has no raster band"), *File);
+		return false;
+	}
+
+	int bHasNoData = 0;
+	const double NoData = Band->GetNoDataValue(&bHasNoData);
+	auto IsValid = [bHasNoData, NoData](double Value)
+	{
+		return !FMath::IsNaN(Value) && !(bHasNoData && Value == NoData);
+	};
+
+	double Min = DBL_MAX;
+	double Max = -DBL_MAX;
+	double Sum = 0;
+	double SumSquares = 0;
+	int64 Count = 0;
+	FCriticalSection MergeLock;
+
+	bool bSuccess = RasterBlocks::ForEachWindow<double>(Band, 0, false, bParallel, [&](const FRasterWindow& Window, TRasterView<double>& View)
+	{
+		double WindowMin = DBL_MAX;
+		double WindowMax = -DBL_MAX;
+		double WindowSum = 0;
+		double WindowSumSquares = 0;
+		int64 WindowCount = 0;
+
+		for (double Value : View.Data)
+		{
+			if (!IsValid(Value)) continue;
+			WindowMin = FMath::Min(WindowMin, Value);
+			WindowMax = FMath::Max(WindowMax, Value);
+			WindowSum += Value;
+			WindowSumSquares += Value * Value;
+			WindowCount++;
+		}
+
+		FScopeLock ScopeLock(&MergeLock);
+		Min = FMath::Min(Min, WindowMin);
+		Max = FMath::Max(Max, WindowMax);
+		Sum += WindowSum;
+		SumSquares += WindowSumSquares;
+		Count += WindowCount;
+		return true;
+	});
+
+	if (!bSuccess)
+	{
+		UE_LOG(LogGDALInterface, Error, TEXT("Could not read '%s' to compute its statistics: %s"), *File, UTF8_TO_TCHAR(CPLGetLastErrorMsg()));
+		return false;
+	}
+
+	if (Count == 0)
+	{
+		UE_LOG(LogGDALInterface, Error, TEXT("Could not compute statistics of '%s' as it only contains nodata values"), *File);
+		return false;
+	}
+
+	OutStatistics = FRasterStatistics();
+	OutStatistics.Min = Min;
+	OutStatistics.Max = Max;
+	OutStatistics.Mean = Sum / Count;
+	OutStatistics.StdDev = FMath::Sqrt(FMath::Max(0.0, SumSquares / Count - OutStatistics.Mean * OutStatistics.Mean));
+	OutStatistics.ValidCount = Count;
+
+	if (!bWithHistogram || HistogramBuckets <= 0) return true;
+
+	// the range is only known after the first pass
+	TArray<int64> Histogram;
+	Histogram.Init(0, HistogramBuckets);
+	const double Scale = Max > Min ? HistogramBuckets / (Max - Min) : 0;
+
+	bSuccess = RasterBlocks::ForEachWindow<double>(Band, 0, false, bParallel, [&](const FRasterWindow& Window, TRasterView<double>& View)
+	{
+		TArray<int64> WindowHistogram;
+		WindowHistogram.Init(0, HistogramBuckets);
+
+		for (double Value : View.Data)
+		{
+			if (!IsValid(Value)) continue;
+			WindowHistogram[FMath::Clamp((int32) ((Value - Min) * Scale), 0, HistogramBuckets - 1)]++;
+		}
+
+		FScopeLock ScopeLock(&MergeLock);
+		for (int32 k = 0; k < HistogramBuckets; k++)
+		{
+			Histogram[k] += WindowHistogram[k];
+		}
+		return true;
+	});
+
+	if (!bSuccess)
+	{
+		UE_LOG(LogGDALInterface, Error, TEXT("Could not read '%s' to compute its histogram: %s"), *File, UTF8_TO_TCHAR(CPLGetLastErrorMsg()));
+		return false;
+	}
+
+	OutStatistics.Histogram = MoveTemp(Histogram);
+	return true;
+}
+
+void RasterStatistics::Invalidate(FString Path)
+{
+	FPaths::NormalizeFilename(Path);
+
+	FScopeLock ScopeLock(&Lock);
+	for (auto It = Cache.CreateIterator(); It; ++It)
+	{
+		if (!DatasetPool::IsInPath(It->Key, Path)) continue;
+
+		if (IsPersistent(It->Key)) Manifest().Remove(It->Key);
+		It.RemoveCurrent();
+	}
+}
+
+FAppendOnlyManifest& RasterStatistics::Manifest()
+{
+	static FAppendOnlyManifest Manifest(
+		"raster statistics", "RasterStatistics.manifest",
+		[]() { return Cache.Num(); },
+		[]()
+		{
+			TArray<FString> Lines;
+			for (auto& [File, Cached] : Cache)
+			{
+				if (IsPersistent(File)) Lines.Add(FAppendOnlyManifest::MakeLine(File, ToFields(Cached)));
+			}
+			return Lines;
+		}
+	);
+	return Manifest;
+}
+
+FString RasterStatistics::ManifestFile()
+{
+	return Manifest().GetFile();
+}
+
+void RasterStatistics::Load()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	Cache.Empty();
+	Manifest().Load(
+		[](const FString& File, const TArray<FString>& Fields)
+		{
+			FCachedStatistics Cached;
+			if (!FromFields(Fields, Cached)) return false;
+			Cache.Add(File, Cached);
+			return true;
+		},
+		[](const FString& File) { Cache.Remove(File); }
+	);
+
+	// forget the files that were modified or deleted since the last session
+	for (auto It = Cache.CreateIterator(); It; ++It)
+	{
+		FFileStamp Stamp;
+		if (!FFileStamp::Get(It->Key, Stamp) || !(Stamp == It->Value.Stamp)) It.RemoveCurrent();
+	}
+
+	Manifest().Compact();
+}
+
+TArray<FString> RasterStatistics::ToFields(const FCachedStatistics& Cached)
+{
+	const FRasterStatistics& Statistics = Cached.Statistics;
+
+	TArray<FString> Buckets;
+	for (int64 Bucket : Statistics.Histogram)
+	{
+		Buckets.Add(FString::Printf(TEXT("%lld"), Bucket));
+	}
+
+	return {
+		FString::Printf(TEXT("%lld"), Cached.Stamp.ModificationTime),
+		FString::Printf(TEXT("%lld"), Cached.Stamp.Size),
+		FString::Printf(TEXT("%.17g"), Statistics.Min),
+		FString::Printf(TEXT("%.17g"), Statistics.Max),
+		FString::Printf(TEXT("%.17g"), Statistics.Mean),
+		FString::Printf(TEXT("%.17g"), Statistics.StdDev),
+		FString::Printf(TEXT("%lld"), Statistics.ValidCount),
+		FString::Join(Buckets, TEXT(","))
+	};
+}
+
+bool RasterStatistics::FromFields(const TArray<FString>& Fields, FCachedStatistics& OutCached)
+{
+	if (Fields.Num() != 8) return false;
+
+	OutCached.Stamp.ModificationTime = FCString::Atoi64(*Fields[0]);
+	OutCached.Stamp.Size = FCString::Atoi64(*Fields[1]);
+	OutCached.Statistics.Min = FCString::Atod(*Fields[2]);
+	OutCached.Statistics.Max = FCString::Atod(*Fields[3]);
+	OutCached.Statistics.Mean = FCString::Atod(*Fields[4]);
+	OutCached.Statistics.StdDev = FCString::Atod(*Fields[5]);
+	OutCached.Statistics.ValidCount = FCString::Atoi64(*Fields[6]);
+
+	TArray<FString> Buckets;
+	Fields[7].ParseIntoArray(Buckets, TEXT(","));
+	for (auto& Bucket : Buckets)
+	{
+		OutCached.Statistics.Histogram.Add(FCString::Atoi64(*Bucket));
+	}
+	return true;
+}
@@ -0,0 +1,119 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "GDALInterface/TransformRegistry.h"
+#include "GDALInterface/LogGDALInterface.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformTLS.h"
+
+#include <atomic>
+
+TransformRegistry::FTransformRef TransformRegistry::Get(const FString& InCRS, const FString& OutCRS, OSRAxisMappingStrategy AxisStrategy)
+{
+	FKey Key(FPlatformTLS::GetCurrentThreadId(), InCRS, OutCRS, (int32) AxisStrategy);
+
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (FCachedTransform* Cached = Transforms.Find(Key))
+		{
+			Cached->LastUse = ++UseCounter;
+			Hits++;
+			return Cached->Transform;
+		}
+	}
+
+	// creating a transformation can take a while (PROJ database queries), so it happens outside of the lock
+	Misses++;
+	OGRSpatialReference InRs, OutRs;
+	if (!GDALInterface::SetCRSFromUserInput(InRs, InCRS) || !GDALInterface::SetCRSFromUserInput(OutRs, OutCRS)) return nullptr;
+	InRs.SetAxisMappingStrategy(AxisStrategy);
+	OutRs.SetAxisMappingStrategy(AxisStrategy);
+
+	OGRCoordinateTransformation* NewTransform = OGRCreateCoordinateTransformation(&InRs, &OutRs);
+	if (!NewTransform)
+	{
+		UE_LOG(LogGDALInterface, Error, TEXT("Could not create a coordinate transformation from %s to %s: %s"), *InCRS, *OutCRS, UTF8_TO_TCHAR(CPLGetLastErrorMsg()));
+		return nullptr;
+	}
+
+	FTransformRef Result(NewTransform, [](OGRCoordinateTransformation* Destroyed) { OGRCoordinateTransformation::DestroyCT(Destroyed); });
+
+	TArray<FTransformRef> Evicted;
+	{
+		FScopeLock ScopeLock(&Lock);
+		while (Transforms.Num() >= FMath::Max(1, MaxTransforms))
+		{
+			FKey OldestKey;
+			uint64 OldestUse = MAX_uint64;
+			for (auto& [CachedKey, Cached] : Transforms)
+			{
+				if (Cached.LastUse < OldestUse)
+				{
+					OldestUse = Cached.LastUse;
+					OldestKey = CachedKey;
+				}
+			}
+			Evicted.Add(Transforms.FindAndRemoveChecked(OldestKey).Transform);
+		}
+		Transforms.Add(Key, { Result, ++UseCounter });
+	}
+
+	// the evicted transformations are destroyed here, outside of the lock, unless they are still in use
+	return Result;
+}
+
+bool TransformRegistry::Transform(const FString& InCRS, const FString& OutCRS, int Count, double* Xs, double* Ys)
+{
+	FTransformRef CachedTransform = Get(InCRS, OutCRS);
+	return CachedTransform && CachedTransform->Transform(Count, Xs, Ys);
+}
+
+bool TransformRegistry::Transform(const FString& InCRS, const FString& OutCRS, TArrayView<FVector2D> Points)
+{
+	// an invalid coordinate system shows one error from the calling thread, rather than one per worker
+	if (!Get(InCRS, OutCRS)) return false;
+	if (Points.IsEmpty()) return true;
+
+	const int32 ChunkSize = FMath::Max(1, ParallelBatchSize);
+	const int32 NumChunks = FMath::DivideAndRoundUp(Points.Num(), ChunkSize);
+	std::atomic<bool> bSuccess = true;
+
+	ParallelFor(NumChunks, [&](int32 Chunk)
+	{
+		TArrayView<FVector2D> ChunkPoints = Points.Slice(Chunk * ChunkSize, FMath::Min(ChunkSize, Points.Num() - Chunk * ChunkSize));
+
+		TArray<double> Xs, Ys;
+		Xs.SetNumUninitialized(ChunkPoints.Num());
+		Ys.SetNumUninitialized(ChunkPoints.Num());
+		for (int32 i = 0; i < ChunkPoints.Num(); i++)
+		{
+			Xs[i] = ChunkPoints[i].X;
+			Ys[i] = ChunkPoints[i].Y;
+		}
+
+		if (!Transform(InCRS, OutCRS, ChunkPoints.Num(), Xs.GetData(), Ys.GetData()))
+		{
+			bSuccess = false;
+			return;
+		}
+
+		for (int32 i = 0; i < ChunkPoints.Num(); i++)
+		{
+			ChunkPoints[i] = FVector2D(Xs[i], Ys[i]);
+		}
+	}, NumChunks == 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+	return bSuccess;
+}
+
+void TransformRegistry::Clear()
+{
+	TMap<FKey, FCachedTransform> Destroyed;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Destroyed = MoveTemp(Transforms);
+		Transforms.Reset();
+	}
+
+	UE_LOG(LogGDALInterface, Log, TEXT("Destroyed %d coordinate transformations"), Destroyed.Num());
+}
@@ -1,7 +1,10 @@
 // Copyright 2023 LandscapeCombinator. All Rights Reserved.
 
 #include "GDALInterfaceModule.h"
+#include "GDALInterface/DatasetPool.h"
 #include "GDALInterface/LogGDALInterface.h"
+#include "GDALInterface/RasterStatistics.h"
+#include "GDALInterface/TransformRegistry.h"
 
 #include "WorldPartition/LoaderAdapter/LoaderAdapterShape.h"
 #include "WorldPartition/LoaderAdapter/LoaderAdapterActor.h"
@@ -45,6 +48,15 @@ void FGDALInterfaceModule::StartupModule()
 	CPLSetConfigOption("OSM_CONFIG_FILE", TCHAR_TO_UTF8(*OSMConf));
 	const char* const ProjPaths[] = { TCHAR_TO_UTF8(*PROJData), nullptr };
 	OSRSetPROJSearchPaths(ProjPaths);
+
+	RasterStatistics::Load();
+}
+
+void FGDALInterfaceModule::ShutdownModule()
+{
+	// datasets and transformations must be destroyed before GDAL is unloaded
+	DatasetPool::Clear();
+	TransformRegistry::Clear();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,94 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GDALInterface/RasterBlocks.h"
+
+#include <atomic>
+
+struct GDALINTERFACE_API FRasterMetadata
+{
+	int32 Width = 0;
+	int32 Height = 0;
+	int32 NumBands = 0;
+	GDALDataType BandType = GDT_Unknown;
+	TOptional<double> NoData;
+
+	bool bHasGeoTransform = false;
+	double GeoTransform[6] = { 0, 1, 0, 0, 0, 1 };
+	FString ProjectionWKT;
+
+	// West, East, South, North, like GDALInterface::GetCoordinates
+	bool GetCoordinates(FVector4d& OutCoordinates) const;
+
+	int64 GetUncompressedBytes() const;
+};
+
+// Version of a file, used to notice that cached information about it is outdated
+struct GDALINTERFACE_API FFileStamp
+{
+	int64 ModificationTime = 0;
+	int64 Size = -1;
+
+	// CRC32 of the content, 0 unless requested, as modification times have a resolution of one second on some file systems
+	uint32 ContentHash = 0;
+
+	bool operator==(const FFileStamp& Other) const { return ModificationTime == Other.ModificationTime && Size == Other.Size && ContentHash == Other.ContentHash; }
+
+	// Works for /vsimem/ files too; returns false if the file does not exist, or cannot be read when `bHashContent` is true.
+	// Hashing reads the whole file, so it is only meant for stamps that are compared rarely, such as the ones of StageCache.
+	static bool Get(const FString& File, FFileStamp& OutStamp, bool bHashContent = false);
+};
+
+// Read-only datasets reused by the queries of each thread, and metadata of rasters shared by all threads.
+// Entries are keyed on the path, modification time and size of files. GDALInterface invalidates them when writing files,
+// and other code must call Invalidate before writing or deleting files that may have been read through the pool.
+class GDALINTERFACE_API DatasetPool
+{
+public:
+	using FDatasetRef = TSharedPtr<FGDALDatasetHandle, ESPMode::ThreadSafe>;
+
+	// A read-only dataset for `File`, to be used from the calling thread only, or nullptr if the file cannot be opened
+	static FDatasetRef Acquire(FString File);
+
+	static bool GetMetadata(FString File, FRasterMetadata& OutMetadata);
+
+	// Closes the pooled datasets and forgets the metadata and statistics of the file `Path`, or of the files in the folder `Path`
+	static void Invalidate(FString Path);
+	static void Clear();
+
+	// Whether `File` is `Path` or is in the folder `Path`, both being normalized
+	static bool IsInPath(const FString& File, const FString& Path);
+
+	// Datasets and metadata served from the pool, and files that had to be opened, since the start
+	static int64 NumHits() { return Hits; }
+	static int64 NumMisses() { return Misses; }
+
+	// Least recently used datasets are closed above this number
+	static inline int32 MaxOpenDatasets = 64;
+
+private:
+	struct FPooledDataset
+	{
+		FDatasetRef Dataset;
+		FFileStamp Stamp;
+		uint64 LastUse = 0;
+	};
+
+	struct FCachedMetadata
+	{
+		FRasterMetadata Metadata;
+		FFileStamp Stamp;
+	};
+
+	static bool ReadMetadata(GDALDataset* Dataset, FRasterMetadata& OutMetadata);
+
+	// keyed on thread id and path
+	static inline TMap<TPair<uint32, FString>, FPooledDataset> Datasets;
+	static inline TMap<FString, FCachedMetadata> Metadata;
+	static inline uint64 UseCounter = 0;
+	static inline std::atomic<int64> Hits { 0 };
+	static inline std::atomic<int64> Misses { 0 };
+	static inline FCriticalSection Lock;
+};
@@ -43,6 +43,11 @@ public:
 	static bool Merge(TArray<FString> SourceFiles, FString TargetFile);
 	static bool AddGeoreference(FString InputFile, FString OutputFile, FString CRS, double MinLong, double MaxLong, double MinLat, double MaxLat);
 
+	// Writes a VRT placing each source at its extent (MinLong, MaxLong, MinLat, MaxLat in `CRS`), without reading or warping the sources.
+	// The sources must be axis-aligned in `CRS`, such as XYZ tiles in EPSG:3857, and must not use color tables.
+	// The mosaic has the bands of the source with most bands, and sources without its alpha band are opaque.
+	static bool CreateMosaic(TArray<FString> SourceFiles, TArray<FVector4d> SourceExtents, FString CRS, FString TargetFile);
+
 	static bool ReadColorsFromFile(FString File, int &OutWidth, int &OutHeight, TArray<FColor> &OutColors);
 	static bool ReadHeightmapFromFile(FString File, int& OutWidth, int& OutHeight, TArray<float>& OutHeightmap);
 
@@ -53,4 +58,13 @@ public:
 	
 	static void XYZTileToEPSG3857(double X, double Y, int Zoom, double &OutLong, double &OutLat);
 	static void EPSG3857ToXYZTile(double Long, double Lat, int Zoom, int &OutX, int &OutY);
+
+	// Sets the size of the GDAL block cache, which is shared by all threads (0 keeps the current size)
+	static void SetCacheMax(int32 CacheMaxMB);
+
+private:
+	// Opens an error dialog, or logs the error and defers the dialog to the game thread when called from a worker thread
+	static void ShowError(const FText& Message);
+
+	static FString EscapeXML(const FString& Text);
 };
\ No newline at end of file
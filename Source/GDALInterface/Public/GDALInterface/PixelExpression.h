@@ -0,0 +1,70 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// An expression of the pixel value `x`, compiled to instructions that each run on many pixels at a time, four by four
+// with SSE or NEON when available, instead of one indirect call per pixel.
+//
+// Supported syntax, with the precedence of C:
+//  - numbers (`-9999`, `1.5e3`), `x`, `nan`, `inf`
+//  - arithmetic: `+ - * /`
+//  - comparisons: `== != < <= > >=`, and `&& || !` on their results
+//  - conditionals: `condition ? a : b`
+//  - functions: `min(a, b)`, `max(a, b)`, `clamp(a, low, high)`, `abs(a)`, `isnan(a)`
+//
+// Comparisons are 1 when true and 0 when false when used as numbers, e.g. `x > 100` is a threshold mask.
+// For instance: `x == -99999 ? 0 : x` replaces a nodata value, and `clamp(x * 0.1 + 5, 0, 8848)` scales, offsets and clamps.
+class GDALINTERFACE_API FPixelExpression
+{
+public:
+	// Returns false, and sets `OutError`, if `Text` is not a valid expression
+	static bool Compile(const FString& Text, FPixelExpression& OutExpression, FString& OutError);
+
+	// Replaces each of the `Count` values by the value of the expression; can be called from several threads at once
+	void Evaluate(float* Values, int64 Count) const;
+	float Evaluate(float X) const;
+
+	const FString& GetText() const { return Text; }
+	bool IsValid() const { return ResultRegister >= 0; }
+
+private:
+	friend class FPixelExpressionParser;
+
+	enum class EOp : uint8
+	{
+		Add, Subtract, Multiply, Divide, Negate,
+		Min, Max, Abs,
+		Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual, IsNaN,
+		And, Or, Not,
+		Select,
+		MaskToNumber
+	};
+
+	struct FInstruction
+	{
+		EOp Op;
+		int32 Result;
+		int32 A = -1;
+		int32 B = -1;
+		int32 C = -1;
+	};
+
+	// Pixels processed by each instruction at once, a multiple of 4
+	static constexpr int32 ChunkSize = 256;
+
+	// Runs the instructions on the first `NumVectors` vectors of each register, registers being ChunkSize / 4 vectors apart
+	void Run(VectorRegister4Float* Registers, int32 NumVectors) const;
+
+	// Same as `Op` on one value, with masks being 1 or 0, used for constant folding
+	static float EvaluateScalar(EOp Op, float A, float B, float C);
+
+	FString Text;
+
+	// Register 0 holds `x`, and constants are loaded into their registers once per call to Evaluate
+	int32 NumRegisters = 0;
+	int32 ResultRegister = -1;
+	TArray<TPair<int32, float>> Constants;
+	TArray<FInstruction> Instructions;
+};
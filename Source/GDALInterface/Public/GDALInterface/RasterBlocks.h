@@ -0,0 +1,149 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/ParallelFor.h"
+#include "Misc/ScopeLock.h"
+
+#include <atomic>
+
+#pragma warning(disable: 4668)
+#include "gdal_priv.h"
+#pragma warning(default: 4668)
+
+// Owns a GDAL dataset and closes it when going out of scope
+class GDALINTERFACE_API FGDALDatasetHandle
+{
+public:
+	FGDALDatasetHandle() {}
+	explicit FGDALDatasetHandle(GDALDataset* Dataset0) : Dataset(Dataset0) {}
+	FGDALDatasetHandle(FGDALDatasetHandle&& Other) : Dataset(Other.Release()) {}
+	FGDALDatasetHandle(const FGDALDatasetHandle&) = delete;
+	~FGDALDatasetHandle() { Reset(); }
+
+	FGDALDatasetHandle& operator=(FGDALDatasetHandle&& Other)
+	{
+		if (this != &Other) Reset(Other.Release());
+		return *this;
+	}
+	FGDALDatasetHandle& operator=(const FGDALDatasetHandle&) = delete;
+
+	static FGDALDatasetHandle Open(FString File, bool bUpdate = false);
+
+	GDALDataset* Get() const { return Dataset; }
+	GDALDataset* operator->() const { return Dataset; }
+	explicit operator bool() const { return Dataset != nullptr; }
+
+	GDALDataset* Release()
+	{
+		GDALDataset* Result = Dataset;
+		Dataset = nullptr;
+		return Result;
+	}
+
+	void Reset(GDALDataset* NewDataset = nullptr)
+	{
+		if (Dataset) GDALClose(Dataset);
+		Dataset = NewDataset;
+	}
+
+private:
+	GDALDataset* Dataset = nullptr;
+};
+
+template<typename T> struct TGDALDataType;
+template<> struct TGDALDataType<uint8>  { static constexpr GDALDataType Value = GDT_Byte; };
+template<> struct TGDALDataType<uint16> { static constexpr GDALDataType Value = GDT_UInt16; };
+template<> struct TGDALDataType<int16>  { static constexpr GDALDataType Value = GDT_Int16; };
+template<> struct TGDALDataType<uint32> { static constexpr GDALDataType Value = GDT_UInt32; };
+template<> struct TGDALDataType<int32>  { static constexpr GDALDataType Value = GDT_Int32; };
+template<> struct TGDALDataType<float>  { static constexpr GDALDataType Value = GDT_Float32; };
+template<> struct TGDALDataType<double> { static constexpr GDALDataType Value = GDT_Float64; };
+
+// A part of a raster, in pixel coordinates of the raster
+struct FRasterWindow
+{
+	// Pixels that the window is responsible for; the cores of the windows of a raster do not overlap
+	FIntRect Core;
+
+	// Pixels that are read: the core extended by the halo, clamped to the raster
+	FIntRect Read;
+};
+
+// Pixels of a window, stored row by row, and accessed with raster coordinates
+template<typename T>
+struct TRasterView
+{
+	FIntRect Rect;
+	TArrayView<T> Data;
+
+	bool Contains(int32 X, int32 Y) const { return X >= Rect.Min.X && X < Rect.Max.X && Y >= Rect.Min.Y && Y < Rect.Max.Y; }
+
+	T& operator()(int32 X, int32 Y) { return Data[(X - Rect.Min.X) + (Y - Rect.Min.Y) * Rect.Width()]; }
+	const T& operator()(int32 X, int32 Y) const { return Data[(X - Rect.Min.X) + (Y - Rect.Min.Y) * Rect.Width()]; }
+};
+
+// Block-by-block access to rasters that may not fit in memory
+class GDALINTERFACE_API RasterBlocks
+{
+public:
+	// Windows aligned on the natural blocks of `Band`. Blocks are grouped so that windows have at least `MinPixels` pixels,
+	// as files organized in scanlines have blocks of one row.
+	static TArray<FRasterWindow> GetWindows(GDALRasterBand* Band, int32 Halo = 0, int64 MinPixels = 256 * 256);
+
+	// Reads each window of `Band` as `T` and calls `Action` on it, only keeping a few windows in memory at a time.
+	// When `bWrite` is true, the core of the window is written back to the band after `Action`.
+	// When `bParallel` is true, `Action` runs on several threads, and reads and writes are serialized, as GDAL datasets are not thread-safe.
+	template<typename T>
+	static bool ForEachWindow(GDALRasterBand* Band, int32 Halo, bool bWrite, bool bParallel, TFunctionRef<bool(const FRasterWindow& Window, TRasterView<T>& View)> Action)
+	{
+		TArray<FRasterWindow> Windows = GetWindows(Band, Halo);
+		FCriticalSection IOLock;
+		std::atomic<bool> bSuccess { true };
+
+		ParallelFor(Windows.Num(), [&](int32 i)
+		{
+			if (!bSuccess) return;
+
+			const FRasterWindow& Window = Windows[i];
+			const int32 Width = Window.Read.Width();
+			const int32 Height = Window.Read.Height();
+
+			TArray<T> Buffer;
+			Buffer.SetNumUninitialized(Width * Height);
+			TRasterView<T> View { Window.Read, Buffer };
+
+			{
+				FScopeLock ScopeLock(&IOLock);
+				if (Band->RasterIO(GF_Read, Window.Read.Min.X, Window.Read.Min.Y, Width, Height, Buffer.GetData(), Width, Height, TGDALDataType<T>::Value, 0, 0) != CE_None)
+				{
+					bSuccess = false;
+					return;
+				}
+			}
+
+			if (!Action(Window, View))
+			{
+				bSuccess = false;
+				return;
+			}
+
+			if (bWrite)
+			{
+				const int32 CoreWidth = Window.Core.Width();
+				const int32 CoreHeight = Window.Core.Height();
+				T* Core = &View(Window.Core.Min.X, Window.Core.Min.Y);
+
+				FScopeLock ScopeLock(&IOLock);
+				if (Band->RasterIO(GF_Write, Window.Core.Min.X, Window.Core.Min.Y, CoreWidth, CoreHeight, Core, CoreWidth, CoreHeight, TGDALDataType<T>::Value, sizeof(T), (GSpacing) sizeof(T) * Width) != CE_None)
+				{
+					bSuccess = false;
+					return;
+				}
+			}
+		}, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+		return bSuccess;
+	}
+};
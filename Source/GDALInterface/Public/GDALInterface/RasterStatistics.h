@@ -0,0 +1,56 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GDALInterface/DatasetPool.h"
+
+class FAppendOnlyManifest;
+
+// Statistics of the first band of a raster, ignoring nodata and NaN values
+struct GDALINTERFACE_API FRasterStatistics
+{
+	double Min = 0;
+	double Max = 0;
+	double Mean = 0;
+	double StdDev = 0;
+	int64 ValidCount = 0;
+
+	// Number of values in each of HistogramBuckets equal buckets between Min and Max, or empty when it was not computed
+	TArray<int64> Histogram;
+};
+
+// Statistics of rasters, computed once per version of a file (see FFileStamp) and shared by all callers.
+// Statistics of files on disk are persisted in an append-only manifest (see FAppendOnlyManifest),
+// so that they survive editor restarts.
+class GDALINTERFACE_API RasterStatistics
+{
+public:
+	// Computes the missing statistics of `Files` in parallel, one pass per file (two with the histogram).
+	// Returns false and sets `OutFailedFile` if the statistics of a file could not be computed.
+	static bool Get(const TArray<FString>& Files, TArray<FRasterStatistics>& OutStatistics, bool bWithHistogram, FString& OutFailedFile);
+
+	// Forgets the statistics of the file `Path`, or of the files in the folder `Path`
+	static void Invalidate(FString Path);
+
+	static FString ManifestFile();
+	static void Load();
+
+	static inline int32 HistogramBuckets = 256;
+
+private:
+	struct FCachedStatistics
+	{
+		FRasterStatistics Statistics;
+		FFileStamp Stamp;
+	};
+
+	static bool Compute(const FString& File, bool bWithHistogram, bool bParallel, FRasterStatistics& OutStatistics);
+
+	static FAppendOnlyManifest& Manifest();
+	static TArray<FString> ToFields(const FCachedStatistics& Cached);
+	static bool FromFields(const TArray<FString>& Fields, FCachedStatistics& OutCached);
+
+	static inline TMap<FString, FCachedStatistics> Cache;
+	static inline FCriticalSection Lock;
+};
@@ -0,0 +1,56 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GDALInterface/GDALInterface.h"
+
+#include <atomic>
+
+// Coordinate transformations reused by all coordinate conversions.
+// Creating one parses both coordinate systems and lets PROJ search for an operation, which takes milliseconds, whereas transforming
+// a point then takes microseconds. OGRCoordinateTransformation is not thread-safe, so each thread gets its own transformations.
+class GDALINTERFACE_API TransformRegistry
+{
+public:
+	using FTransformRef = TSharedPtr<OGRCoordinateTransformation, ESPMode::ThreadSafe>;
+
+	// A transformation between two coordinate systems given as accepted by GDALInterface::SetCRSFromUserInput, to be used
+	// from the calling thread only, or nullptr (after showing an error) if one of the coordinate systems is invalid
+	static FTransformRef Get(const FString& InCRS, const FString& OutCRS, OSRAxisMappingStrategy AxisStrategy = OAMS_TRADITIONAL_GIS_ORDER);
+
+	// Transforms `Count` points in place, with the traditional GIS axis order (longitude or easting first)
+	static bool Transform(const FString& InCRS, const FString& OutCRS, int Count, double* Xs, double* Ys);
+
+	// Same on an array of points, split in chunks of ParallelBatchSize points transformed in parallel.
+	// Each point gets exactly the same result as when transformed alone.
+	static bool Transform(const FString& InCRS, const FString& OutCRS, TArrayView<FVector2D> Points);
+
+	// Destroys the transformations, which stay alive while still referenced
+	static void Clear();
+
+	// Transformations served from the registry, and transformations that had to be created, since the start
+	static int64 NumHits() { return Hits; }
+	static int64 NumMisses() { return Misses; }
+
+	// Least recently used transformations are destroyed above this number
+	static inline int32 MaxTransforms = 128;
+
+	static inline int32 ParallelBatchSize = 4096;
+
+private:
+	// thread id, input CRS, output CRS, axis mapping strategy
+	using FKey = TTuple<uint32, FString, FString, int32>;
+
+	struct FCachedTransform
+	{
+		FTransformRef Transform;
+		uint64 LastUse = 0;
+	};
+
+	static inline TMap<FKey, FCachedTransform> Transforms;
+	static inline uint64 UseCounter = 0;
+	static inline std::atomic<int64> Hits { 0 };
+	static inline std::atomic<int64> Misses { 0 };
+	static inline FCriticalSection Lock;
+};
@@ -11,6 +11,7 @@ class GDALINTERFACE_API FGDALInterfaceModule : public IModuleInterface
 {
 public:
 	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
 
 	static inline FString PluginDir = "";
 };
@@ -27,6 +27,7 @@ public class ImageDownloader : ModuleRules
 				"Slate",
 				"SlateCore",
 				"HTTP",
+				"Json",
 				"Projects",
 				"PropertyEditor",
 				"Landscape",
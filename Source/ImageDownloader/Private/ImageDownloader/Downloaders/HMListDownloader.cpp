@@ -81,7 +81,8 @@ void HMListDownloader::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunc
 		{
 			Download::FromURL(Lines[i], OutputFiles[i], true, OnCompleteElement);
 		},
-		OnComplete
+		OnComplete,
+		Concurrency::MaxIOParallelism
 	);
 }
 
@@ -56,16 +56,18 @@ void HMViewfinderDownloader::Fetch(FString InputCRS, TArray<FString> InputFiles,
 		return;
 	}
 
-	FString Dir = Directories::DownloadDir();
-	Concurrency::RunMany<FString>(
-		MegaTiles,
-		[this, DownloadDir, ImageDownloaderDir](FString MegaTile, TFunction<void(bool)> OnCompleteElement)
+	ParallelOutputs.Reset(MegaTiles.Num());
+
+	Concurrency::RunMany(
+		MegaTiles.Num(),
+		[this, DownloadDir, ImageDownloaderDir](int i, TFunction<void(bool)> OnCompleteElement)
 		{
+			FString MegaTile = MegaTiles[i];
 			FString ZipFile = FPaths::Combine(DownloadDir, FString::Format(TEXT("{0}.zip"), { MegaTile }));
 			FString ExtractionDir = FPaths::Combine(ImageDownloaderDir, MegaTile);
 			FString URL = FString::Format(TEXT("{0}{1}.zip"), { BaseURL, MegaTile });
 
-			Download::FromURL(URL, ZipFile, true, [this, ExtractionDir, ZipFile, MegaTile, OnCompleteElement](bool bWasSuccessful)
+			Download::FromURL(URL, ZipFile, true, [this, i, ExtractionDir, ZipFile, MegaTile, OnCompleteElement](bool bWasSuccessful)
 			{
 				if (bWasSuccessful)
 				{
@@ -76,13 +78,13 @@ void HMViewfinderDownloader::Fetch(FString InputCRS, TArray<FString> InputFiles,
 						if (bIs15)
 						{
 							FString TifFile = FPaths::Combine(ExtractionDir, FString::Format(TEXT("{0}.tif"), { MegaTile }));
-							OutputFiles.Add(TifFile);
+							ParallelOutputs.Add(i, TifFile);
 						}
 						else
 						{
 							TArray<FString> HGTFiles;
 							FFileManagerGeneric::Get().FindFilesRecursive(HGTFiles, *ExtractionDir, TEXT("*.hgt"), true, false);
-							OutputFiles.Append(HGTFiles);
+							ParallelOutputs.Append(i, HGTFiles);
 						}
 						OnCompleteElement(true);
 					}
@@ -97,7 +99,12 @@ void HMViewfinderDownloader::Fetch(FString InputCRS, TArray<FString> InputFiles,
 				}
 			});
 		},
-		OnComplete
+		[this, OnComplete](bool bSuccess)
+		{
+			OutputFiles.Append(ParallelOutputs.Merge());
+			if (OnComplete) OnComplete(bSuccess);
+		},
+		Concurrency::MaxIOParallelism
 	);
 }
 
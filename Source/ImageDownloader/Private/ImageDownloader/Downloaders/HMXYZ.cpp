@@ -8,6 +8,7 @@
 #include "ConcurrencyHelpers/Concurrency.h"
 #include "FileDownloader/Download.h"
 #include "GDALInterface/GDALInterface.h"
+#include "GDALInterface/DatasetPool.h"
 #include "MapboxHelpers/MapboxHelpers.h"
 
 #include "Misc/FileHelper.h"
@@ -62,7 +63,8 @@ void HMXYZ::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(b
 
 	int NumTiles = (MaxX - MinX + 1) * (MaxY - MinY + 1);
 
-	if (NumTiles > 16)
+	// commandlets run unattended, so they always proceed
+	if (NumTiles > 16 && !IsRunningCommandlet())
 	{
 		EAppReturnType::Type UserResponse = FMessageDialog::Open(EAppMsgType::OkCancel,
 			FText::Format(
@@ -106,6 +108,8 @@ void HMXYZ::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(b
 	);
 	Task->MakeDialog();
 
+	ParallelOutputs.Reset(NumTiles);
+
 	Concurrency::RunMany(
 		NumTiles,
 
@@ -125,16 +129,19 @@ void HMXYZ::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(b
 			FString FileName = FString::Format(TEXT("{0}_x{1}_y{2}"), { Name, XOffset, YOffset });
 
 			Download::FromURL(ReplacedURL, DownloadFile, false,
-				[this, Task, bShowedDialog, OnCompleteElement, ReplacedURL, DownloadFile, FileName, XYZFolder, X, Y](bool bOneSuccess)
+				[this, i, Task, bShowedDialog, OnCompleteElement, ReplacedURL, DownloadFile, FileName, XYZFolder, X, Y](bool bOneSuccess)
 				{
 					if (bOneSuccess)
 					{
 						FString DecodedFile = DownloadFile;
 
-						if (bDecodeMapbox)
+						if (bDecodeTerrainRGB)
 						{
-							DecodedFile = FPaths::Combine(Directories::DownloadDir(), FString::Format(TEXT("MapboxTerrainDEMV1-{0}-{1}-{2}-decoded.tif"), { Zoom, X, Y }));
-							if (!MapboxHelpers::DecodeMapboxThreeBands(DownloadFile, DecodedFile, bShowedDialog))
+							FString DecodedName = Encoding == ETerrainEncoding::Mapbox
+								? FString::Format(TEXT("MapboxTerrainDEMV1-{0}-{1}-{2}-decoded.tif"), { Zoom, X, Y })
+								: FString::Format(TEXT("{0}-{1}-{2}-{3}-terrarium.tif"), { Layer, Zoom, X, Y });
+							DecodedFile = FPaths::Combine(Directories::DownloadDir(), DecodedName);
+							if (!MapboxHelpers::DecodeTerrainRGB(DownloadFile, DecodedFile, Encoding, bShowedDialog))
 							{
 								if (!(*bShowedDialog))
 								{
@@ -186,19 +193,21 @@ void HMXYZ::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(b
 						
 						if (bGeoreferenceSlippyTiles)
 						{
-							double MinLong, MaxLong, MinLat, MaxLat;
-
-							GDALInterface::XYZTileToEPSG3857(X, Y, Zoom, MinLong, MaxLat);
-							GDALInterface::XYZTileToEPSG3857(X+1, Y+1, Zoom, MaxLong, MinLat);
+							// tiles are placed in the mosaic once they are all downloaded, only paletted tiles need to be rewritten;
+							// their transparency is kept, and the mosaic makes the RGB tiles opaque
+							FString TileFile = DecodedFile;
 
-							FString OutputFile = FPaths::Combine(XYZFolder, FileName + ".tif");
-							if (!GDALInterface::AddGeoreference(DecodedFile, OutputFile, "EPSG:3857", MinLong, MaxLong, MinLat, MaxLat))
+							if (HasColorTable(DecodedFile))
 							{
-								if (OnCompleteElement) OnCompleteElement(false);
-								return;
+								TileFile = FPaths::Combine(XYZFolder, FileName + ".tif");
+								if (!GDALInterface::Translate(DecodedFile, TileFile, { "-of", "GTiff", "-expand", "rgba" }))
+								{
+									if (OnCompleteElement) OnCompleteElement(false);
+									return;
+								}
 							}
 
-							OutputFiles.Add(OutputFile);
+							ParallelOutputs.Add(i, TileFile);
 						}
 						else
 						{
@@ -209,7 +218,7 @@ void HMXYZ::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(b
 								return;
 							}
 
-							OutputFiles.Add(OutputFile);
+							ParallelOutputs.Add(i, OutputFile);
 						}
 					}
 
@@ -220,13 +229,59 @@ void HMXYZ::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(b
 			);
 		},
 
-		[OnComplete, Task, bShowedDialog](bool bSuccess)
+		[this, OnComplete, Task, bShowedDialog, XYZFolder](bool bSuccess)
 		{
+			if (bSuccess && bGeoreferenceSlippyTiles)
+			{
+				bSuccess = CreateMosaic(ParallelOutputs.Merge(), XYZFolder);
+			}
+			else
+			{
+				OutputFiles.Append(ParallelOutputs.Merge());
+			}
+
 			AsyncTask(ENamedThreads::GameThread, [Task]() { Task->Destroy(); });
 			if (bShowedDialog) delete(bShowedDialog);
 			if (OnComplete) OnComplete(bSuccess);
-		}
+		},
+		Concurrency::MaxIOParallelism
+	);
+}
+
+bool HMXYZ::HasColorTable(FString File)
+{
+	DatasetPool::FDatasetRef Dataset = DatasetPool::Acquire(File);
+	return Dataset && (*Dataset)->GetRasterCount() >= 1 && (*Dataset)->GetRasterBand(1)->GetColorTable();
+}
+
+bool HMXYZ::CreateMosaic(TArray<FString> TileFiles, FString XYZFolder)
+{
+	// all tiles succeeded, so there is one file per tile, in the order of the tiles
+	TArray<FVector4d> Extents;
+	for (int i = 0; i < TileFiles.Num(); i++)
+	{
+		int X = i % (MaxX - MinX + 1) + MinX;
+		int Y = i / (MaxX - MinX + 1) + MinY;
+
+		double MinLong, MaxLong, MinLat, MaxLat;
+		GDALInterface::XYZTileToEPSG3857(X, Y, Zoom, MinLong, MaxLat);
+		GDALInterface::XYZTileToEPSG3857(X+1, Y+1, Zoom, MaxLong, MinLat);
+		Extents.Add(FVector4d(MinLong, MaxLong, MinLat, MaxLat));
+	}
+
+	FString MosaicFile = FPaths::Combine(XYZFolder, Name + ".vrt");
+	if (!GDALInterface::CreateMosaic(TileFiles, Extents, "EPSG:3857", MosaicFile)) return false;
+
+	OutputFiles.Add(MosaicFile);
+	return true;
+}
+
+bool HMXYZ::GetFingerprint(FString& OutFingerprint) const
+{
+	OutFingerprint = FString::Printf(TEXT("%s|%s|%s|%s|%d|%d|%d|%d|%d|%d|%d|%d|%s|%d"),
+		*Name, *Layer, *Format, *URL, Zoom, MinX, MaxX, MinY, MaxY, bMaxY_IsNorth, bGeoreferenceSlippyTiles, bDecodeTerrainRGB, *CRS, (int) Encoding
 	);
+	return true;
 }
 
 #undef LOCTEXT_NAMESPACE
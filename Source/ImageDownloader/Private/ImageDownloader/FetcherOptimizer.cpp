@@ -0,0 +1,155 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "ImageDownloader/FetcherOptimizer.h"
+#include "ImageDownloader/HMCachedFetcher.h"
+#include "ImageDownloader/HMDebugFetcher.h"
+#include "ImageDownloader/LogImageDownloader.h"
+#include "ImageDownloader/Transformers/HMFusedWarp.h"
+
+HMFetcher* FetcherOptimizer::FuseWarps(FString Name, HMFetcher* Fetcher)
+{
+	if (!Fetcher) return nullptr;
+
+	if (!Fetcher->IsSequence())
+	{
+		for (HMFetcher** Inner : Fetcher->GetInnerFetchers())
+		{
+			*Inner = FuseWarps(Name, *Inner);
+		}
+		return Fetcher;
+	}
+
+	TArray<HMFetcher*> Phases;
+	Flatten(Fetcher, Phases);
+
+	TArray<HMFetcher*> NewPhases;
+	TArray<HMFetcher*> Group;
+	FWarpOptions GroupOptions;
+
+	for (HMFetcher* Phase : Phases)
+	{
+		Phase = FuseWarps(Name, Phase);
+
+		FWarpOptions Options;
+		bool bIsWarp = Phase->GetWarpOptions(Options);
+
+		if (!Group.IsEmpty() && !(bIsWarp && GroupOptions.CanBeFollowedBy(Options)))
+		{
+			NewPhases.Add(FuseGroup(Name, Group));
+			GroupOptions = FWarpOptions();
+		}
+
+		if (bIsWarp)
+		{
+			GroupOptions = GroupOptions.Then(Options);
+			Group.Add(Phase);
+		}
+		else
+		{
+			NewPhases.Add(Phase);
+		}
+	}
+	if (!Group.IsEmpty()) NewPhases.Add(FuseGroup(Name, Group));
+
+	HMFetcher* Result = NewPhases[0];
+	for (int32 i = 1; i < NewPhases.Num(); i++)
+	{
+		Result = Result->AndThen(NewPhases[i]);
+	}
+	return Result;
+}
+
+HMFetcher* FetcherOptimizer::Memoize(HMFetcher* Fetcher)
+{
+	if (!Fetcher) return nullptr;
+
+	TArray<HMFetcher**> Inners = Fetcher->GetInnerFetchers();
+	if (!Inners.IsEmpty())
+	{
+		for (HMFetcher** Inner : Inners)
+		{
+			*Inner = Memoize(*Inner);
+		}
+		return Fetcher;
+	}
+
+	FString Fingerprint;
+	if (!Fetcher->GetFingerprint(Fingerprint)) return Fetcher;
+
+	return new HMCachedFetcher(Fetcher);
+}
+
+void FetcherOptimizer::Flatten(HMFetcher* Fetcher, TArray<HMFetcher*>& OutPhases)
+{
+	if (!Fetcher->IsSequence())
+	{
+		OutPhases.Add(Fetcher);
+		return;
+	}
+
+	for (HMFetcher** Inner : Fetcher->GetInnerFetchers())
+	{
+		Flatten(*Inner, OutPhases);
+		// detach the phase so that deleting the sequence does not delete it
+		*Inner = nullptr;
+	}
+	delete Fetcher;
+}
+
+HMFetcher* FetcherOptimizer::FuseGroup(FString Name, TArray<HMFetcher*>& Group)
+{
+	check(!Group.IsEmpty());
+
+	HMFetcher* Result;
+	if (Group.Num() == 1)
+	{
+		Result = Group[0];
+	}
+	else
+	{
+		TArray<FString> StepNames;
+		TArray<FWarpOptions> Steps;
+		for (HMFetcher* Phase : Group)
+		{
+			FWarpOptions Options;
+			Phase->GetWarpOptions(Options);
+			StepNames.Add(Phase->GetPlanName());
+			Steps.Add(Options);
+			delete Phase;
+		}
+
+		UE_LOG(LogImageDownloader, Log, TEXT("Fusing phases %s into a single warp"), *FString::Join(StepNames, TEXT(", ")));
+		Result = new HMDebugFetcher(FString::Join(StepNames, TEXT("+")), new HMFusedWarp(Name, StepNames, Steps));
+	}
+
+	Group.Empty();
+	return Result;
+}
+
+FString FetcherOptimizer::DumpPlan(HMFetcher* Fetcher)
+{
+	TArray<FString> Lines;
+	DumpPlan(Fetcher, 0, Lines);
+	return FString::Join(Lines, TEXT("\n"));
+}
+
+void FetcherOptimizer::DumpPlan(HMFetcher* Fetcher, int32 Depth, TArray<FString>& OutLines)
+{
+	if (!Fetcher) return;
+
+	// sequences are shown flat, as they are run
+	if (Fetcher->IsSequence())
+	{
+		for (HMFetcher** Inner : Fetcher->GetInnerFetchers())
+		{
+			DumpPlan(*Inner, Depth, OutLines);
+		}
+		return;
+	}
+
+	OutLines.Add(FString::ChrN(2 * Depth, ' ') + Fetcher->GetPlanName());
+	for (HMFetcher** Inner : Fetcher->GetInnerFetchers())
+	{
+		DumpPlan(*Inner, Depth + 1, OutLines);
+	}
+}
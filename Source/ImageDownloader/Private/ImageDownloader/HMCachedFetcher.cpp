@@ -0,0 +1,93 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "ImageDownloader/HMCachedFetcher.h"
+#include "ImageDownloader/LogImageDownloader.h"
+#include "ImageDownloader/PipelineMemory.h"
+#include "ImageDownloader/StageCache.h"
+
+#include "ConcurrencyHelpers/Concurrency.h"
+#include "ConcurrencyHelpers/TaskPool.h"
+
+#include "Async/Async.h"
+
+#include "Misc/SecureHash.h"
+
+#define LOCTEXT_NAMESPACE "FImageDownloaderModule"
+
+void HMCachedFetcher::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete)
+{
+	FString Key;
+	if (!GetKey(InputCRS, InputFiles, Key))
+	{
+		Fetcher->Fetch(InputCRS, InputFiles, [this, OnComplete](bool bSuccess)
+		{
+			OutputFiles = Fetcher->OutputFiles;
+			OutputCRS = Fetcher->OutputCRS;
+			if (OnComplete) OnComplete(bSuccess);
+		});
+		return;
+	}
+
+	// comparing the content of the files with the record reads them, which does not belong on the game thread
+	TSharedRef<FStageRecord, ESPMode::ThreadSafe> Record = MakeShared<FStageRecord, ESPMode::ThreadSafe>();
+	Concurrency::RunOne(
+		[Key, InputFiles, Record]() { return StageCache::Find(Key, InputFiles, *Record); },
+		[this, Key, InputCRS, InputFiles, Record, OnComplete](bool bFound)
+		{
+			// phases expect to be started from the game thread
+			AsyncTask(ENamedThreads::GameThread, [this, Key, InputCRS, InputFiles, Record, OnComplete, bFound]()
+			{
+				if (bFound)
+				{
+					UE_LOG(LogImageDownloader, Log, TEXT("Reusing the %d output files of phase %s from a previous run"), Record->OutputFiles.Num(), *Fetcher->GetPlanName());
+					Fetcher->OutputFiles = Record->OutputFiles;
+					Fetcher->OutputCRS = Record->OutputCRS;
+					OutputFiles = Record->OutputFiles;
+					OutputCRS = Record->OutputCRS;
+					if (OnComplete) OnComplete(true);
+					return;
+				}
+
+				Fetcher->Fetch(InputCRS, InputFiles, [this, Key, InputFiles, OnComplete](bool bSuccess)
+				{
+					OutputFiles = Fetcher->OutputFiles;
+					OutputCRS = Fetcher->OutputCRS;
+
+					// the next phases only read these files, so they can be hashed in the background
+					if (bSuccess)
+					{
+						FTaskPool::Get().Submit([Key, InputFiles, OutputCRS = OutputCRS, OutputFiles = OutputFiles]()
+						{
+							StageCache::Record(Key, InputFiles, OutputCRS, OutputFiles);
+						});
+					}
+					if (OnComplete) OnComplete(bSuccess);
+				});
+			});
+		}
+	);
+}
+
+bool HMCachedFetcher::GetKey(const FString& InputCRS, const TArray<FString>& InputFiles, FString& OutKey) const
+{
+	FString Fingerprint;
+	if (!Fetcher->GetFingerprint(Fingerprint)) return false;
+
+	TArray<FString> Lines({ Fetcher->GetPlanName(), Fingerprint, InputCRS });
+	for (auto& InputFile : InputFiles)
+	{
+		// in-memory inputs are written again by the previous phase on each run, so records using them would never be reused
+		FFileStamp Stamp;
+		if (PipelineMemory::IsInMemory(InputFile) || !FFileStamp::Get(InputFile, Stamp)) return false;
+		Lines.Add(FString::Printf(TEXT("%s\t%lld\t%lld"), *InputFile, Stamp.ModificationTime, Stamp.Size));
+	}
+
+	// fingerprints may contain secrets, such as tokens in URLs, so only their hash is stored
+	FTCHARToUTF8 Description(*FString::Join(Lines, TEXT("\n")));
+	uint8 Hash[FSHA1::DigestSize];
+	FSHA1::HashBuffer(Description.Get(), Description.Length(), Hash);
+	OutKey = BytesToHex(Hash, FSHA1::DigestSize);
+	return true;
+}
+
+#undef LOCTEXT_NAMESPACE
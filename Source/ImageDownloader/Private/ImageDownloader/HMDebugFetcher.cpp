@@ -29,9 +29,12 @@ void HMDebugFetcher::Fetch(FString InputCRS, TArray<FString> InputFiles, TFuncti
 	// Always reenter game thread to display progress to the user
 	AsyncTask(ENamedThreads::GameThread, [this, InputCRS, InputFiles, OnComplete]()
 	{
-		SCOPE_LOG_TIME_IN_SECONDS(*Name, nullptr);
+		Recorder.Begin(Name, InputFiles);
 		Fetcher->Fetch(InputCRS, InputFiles, [this, OnComplete](bool bSuccess)
 		{
+			FStageTelemetry Stage = Recorder.End(bSuccess, Fetcher->OutputFiles);
+			if (Telemetry) Telemetry->Add(Stage);
+
 			if (bSuccess)
 			{
 				OutputFiles = Fetcher->OutputFiles;
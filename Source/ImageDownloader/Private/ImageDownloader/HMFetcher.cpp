@@ -2,12 +2,16 @@
 
 #include "ImageDownloader/HMFetcher.h"
 #include "ImageDownloader/LogImageDownloader.h"
+#include "ImageDownloader/PipelineMemory.h"
+#include "ImageDownloader/ImageDownloaderSettings.h"
 #include "ConcurrencyHelpers/Concurrency.h"
+#include "GDALInterface/GDALInterface.h"
 
 #include "Interfaces/IPluginManager.h"
 #include "Kismet/GameplayStatics.h"
 #include "Async/Async.h"
 #include "Misc/MessageDialog.h"
+#include "Misc/ScopedSlowTask.h"
 
 #define LOCTEXT_NAMESPACE "FImageDownloaderModule"
 
@@ -21,6 +25,84 @@ HMFetcher* HMFetcher::AndRun(TFunction<bool(HMFetcher*)> Lambda)
 	return new HMAndRunFetcher(this, Lambda);
 }
 
+bool HMFetcher::RunPerFile(const TArray<FString>& InputFiles, FText Message, TFunction<bool(int32 i)> Action)
+{
+	const UImageDownloaderSettings* Settings = GetDefault<UImageDownloaderSettings>();
+	GDALInterface::SetCacheMax(Settings->GDALCacheMaxMB);
+
+	int32 MaxParallelism = Concurrency::MaxCPUParallelism > 0 ? Concurrency::MaxCPUParallelism : FTaskPool::Get().NumWorkers();
+
+	int64 BytesPerFile = 0;
+	for (auto& InputFile : InputFiles)
+	{
+		BytesPerFile = FMath::Max(BytesPerFile, PipelineMemory::EstimateBytes({ InputFile }));
+	}
+
+	int64 BudgetBytes = (int64) Settings->ParallelMemoryBudgetMB * 1024 * 1024;
+	if (BudgetBytes > 0 && BytesPerFile > 0)
+	{
+		MaxParallelism = FMath::Clamp<int64>(BudgetBytes / BytesPerFile, 1, MaxParallelism);
+	}
+
+	UE_LOG(LogImageDownloader, Log, TEXT("Processing %d files, at most %d at a time (%lld MB each)"), InputFiles.Num(), MaxParallelism, BytesPerFile >> 20);
+
+	struct FRunState
+	{
+		std::atomic<int32> FinishedFiles { 0 };
+		std::atomic<bool> bComplete { false };
+		std::atomic<bool> bSuccess { false };
+	};
+	TSharedRef<FRunState, ESPMode::ThreadSafe> State = MakeShared<FRunState, ESPMode::ThreadSafe>();
+	FCancellationToken CancellationToken;
+
+	ParallelOutputs.Reset(InputFiles.Num());
+
+	Concurrency::RunMany(
+		InputFiles.Num(),
+		[Action, State, CancellationToken](int i, TFunction<void(bool)> OnCompleteElement)
+		{
+			// files are already processed in parallel, so GDAL must not start threads of its own
+			CPLConfigOptionSetter NumThreads("GDAL_NUM_THREADS", "1", false);
+
+			bool bSuccess = Action(i);
+			if (!bSuccess) CancellationToken.Cancel();
+
+			State->FinishedFiles++;
+			OnCompleteElement(bSuccess);
+		},
+		[State](bool bSuccess)
+		{
+			State->bSuccess = bSuccess;
+			State->bComplete = true;
+		},
+		MaxParallelism,
+		CancellationToken
+	);
+
+	FScopedSlowTask Task(InputFiles.Num(), Message);
+	if (IsInGameThread()) Task.MakeDialog(true);
+
+	int32 ReportedFiles = 0;
+	while (!State->bComplete)
+	{
+		if (Task.ShouldCancel()) CancellationToken.Cancel();
+
+		int32 FinishedFiles = State->FinishedFiles;
+		if (FinishedFiles > ReportedFiles)
+		{
+			Task.EnterProgressFrame(FinishedFiles - ReportedFiles);
+			ReportedFiles = FinishedFiles;
+		}
+
+		FPlatformProcess::Sleep(0.05);
+	}
+
+	if (!State->bSuccess) return false;
+
+	OutputFiles.Append(ParallelOutputs.Merge());
+	return true;
+}
+
 void HMAndThenFetcher::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete)
 {
 	Fetcher1->Fetch(InputCRS, InputFiles, [this, OnComplete](bool bSuccess1)
@@ -29,6 +111,9 @@ void HMAndThenFetcher::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunc
 		{
 			Fetcher2->Fetch(Fetcher1->OutputCRS, Fetcher1->OutputFiles, [this, OnComplete](bool bSuccess2)
 			{
+				// the in-memory outputs of Fetcher1 are not needed anymore, unless Fetcher2 passed them through
+				PipelineMemory::Release(Fetcher1->OutputFiles, Fetcher2->OutputFiles);
+
 				if (bSuccess2)
 				{
 					OutputFiles = Fetcher2->OutputFiles;
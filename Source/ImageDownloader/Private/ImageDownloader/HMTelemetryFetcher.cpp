@@ -0,0 +1,23 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "ImageDownloader/HMTelemetryFetcher.h"
+#include "ImageDownloader/PipelineTelemetry.h"
+
+#define LOCTEXT_NAMESPACE "FImageDownloaderModule"
+
+void HMTelemetryFetcher::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete)
+{
+	TSharedPtr<FPipelineTelemetry, ESPMode::ThreadSafe> Telemetry = MakeShared<FPipelineTelemetry, ESPMode::ThreadSafe>(Name);
+	Fetcher->SetTelemetry(Telemetry);
+
+	Fetcher->Fetch(InputCRS, InputFiles, [this, Telemetry, OnComplete](bool bSuccess)
+	{
+		OutputFiles = Fetcher->OutputFiles;
+		OutputCRS = Fetcher->OutputCRS;
+		Fetcher->SetTelemetry(nullptr);
+		Telemetry->Finish(bSuccess);
+		if (OnComplete) OnComplete(bSuccess);
+	});
+}
+
+#undef LOCTEXT_NAMESPACE
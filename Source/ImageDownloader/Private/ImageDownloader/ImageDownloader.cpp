@@ -5,6 +5,11 @@
 #include "ImageDownloader/Directories.h"
 #include "ImageDownloader/HMDebugFetcher.h"
 #include "ImageDownloader/ImageDownloaderSettings.h"
+#include "ImageDownloader/PipelineMemory.h"
+#include "ImageDownloader/StageCache.h"
+#include "ImageDownloader/FetcherOptimizer.h"
+#include "ImageDownloader/HMTelemetryFetcher.h"
+#include "GDALInterface/DatasetPool.h"
 
 #include "ImageDownloader/Downloaders/HMLocalFile.h"
 #include "ImageDownloader/Downloaders/HMLocalFolder.h"
@@ -29,6 +34,7 @@
 #include "ImageDownloader/Transformers/HMReproject.h"
 #include "ImageDownloader/Transformers/HMEnsureOneBand.h"
 #include "ImageDownloader/Transformers/HMCrop.h"
+#include "ImageDownloader/Transformers/HMToCOG.h"
 #include "ImageDownloader/Transformers/HMToPNG.h"
 #include "ImageDownloader/Transformers/HMMerge.h"
 #include "ImageDownloader/Transformers/HMReadCRS.h"
@@ -271,8 +277,8 @@ HMFetcher* UImageDownloader::CreateInitialFetcher(FString Name)
 					"XYZ_Download",
 					new HMXYZ(
 						Name, Layer, Format, URL2, XYZ_Zoom, XYZ_MinX, XYZ_MaxX, XYZ_MinY, XYZ_MaxY,
-						bMaxY_IsNorth2, bGeoreferenceSlippyTiles2, ImageSourceKind == EImageSourceKind::Mapbox_Heightmaps,
-						XYZ_CRS
+						bMaxY_IsNorth2, bGeoreferenceSlippyTiles2, ImageSourceKind == EImageSourceKind::Mapbox_Heightmaps || (!IsMapbox() && bXYZ_DecodeTerrarium),
+						XYZ_CRS, IsMapbox() ? ETerrainEncoding::Mapbox : ETerrainEncoding::Terrarium
 					),
 					true
 				);
@@ -301,7 +307,9 @@ HMFetcher* UImageDownloader::CreateFetcher(FString Name, bool bEnsureOneBand, bo
 	if (bRemap)
 	{
 		Result = Result->AndThen(new HMDebugFetcher("Convert", new HMConvert(Name, "tif")));
-		Result = Result->AndThen(new HMDebugFetcher("FixNoData", new HMFunction([this](float x) { return x == OriginalValue ? TransformedValue : x; })));
+		// %.9g prints floats exactly
+		FString FixNoData = FString::Printf(TEXT("x == %.9g ? %.9g : x"), OriginalValue, TransformedValue);
+		Result = Result->AndThen(new HMDebugFetcher("FixNoData", new HMFunction(Name, FixNoData)));
 	}
 	
 	if (bPreprocess)
@@ -378,6 +386,41 @@ HMFetcher* UImageDownloader::CreateFetcher(FString Name, bool bEnsureOneBand, bo
 		Result = Result->AndThen(new HMDebugFetcher("Resolution", new HMResolution(Name, PrecisionPercent)));
 	}
 
+	if (bOutputCOG && !bConvertToPNG)
+	{
+		FString Resampling = StaticEnum<EOverviewResampling>()->GetNameStringByValue((int64) COG_OverviewResampling).ToUpper();
+		FString Predictor =
+			COG_Predictor == ECOGPredictor::None ? "NO" :
+			COG_Predictor == ECOGPredictor::Horizontal ? "STANDARD" :
+			COG_Predictor == ECOGPredictor::FloatingPoint ? "FLOATING_POINT" :
+			"YES";
+		Result = Result->AndThen(new HMDebugFetcher("ToCOG", new HMToCOG(Name, Resampling, COG_BlockSize, Predictor)));
+	}
+
+	const UImageDownloaderSettings* Settings = GetDefault<UImageDownloaderSettings>();
+	if (Settings->bFuseWarpPhases)
+	{
+		Result = FetcherOptimizer::FuseWarps(Name, Result);
+	}
+
+	if (Settings->bReuseStageOutputs)
+	{
+		Result = FetcherOptimizer::Memoize(Result);
+	}
+
+	if (Settings->bRecordTelemetry)
+	{
+		Result = new HMTelemetryFetcher(Name, Result);
+	}
+
+	if (Settings->bLogFetcherPlan)
+	{
+		UE_LOG(LogImageDownloader, Log, TEXT("Phases of %s:\n%s"), *Name, *FetcherOptimizer::DumpPlan(Result));
+	}
+
+	// only the output of the last phase needs to be on disk
+	Result->SetIntermediate(false);
+
 	return Result;
 }
 
@@ -401,6 +444,10 @@ FString UImageDownloader::GetMapboxToken()
 
 void UImageDownloader::DeleteAllImages()
 {
+	PipelineMemory::Clear();
+	DatasetPool::Clear();
+	StageCache::Clear();
+
 	FString ImageDownloaderDir = Directories::ImageDownloaderDir();
 	if (!ImageDownloaderDir.IsEmpty())
 	{
@@ -421,6 +468,10 @@ void UImageDownloader::DeleteAllImages()
 
 void UImageDownloader::DeleteAllProcessedImages()
 {
+	PipelineMemory::Clear();
+	DatasetPool::Clear();
+	StageCache::Clear();
+
 	TArray<FString> Files;
 	TArray<FString> Folders;
 	IPlatformFile &PlatformFile = IPlatformFile::GetPlatformPhysical();
@@ -0,0 +1,140 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "ImageDownloader/PipelineMemory.h"
+#include "ImageDownloader/Directories.h"
+#include "ImageDownloader/ImageDownloaderSettings.h"
+#include "ImageDownloader/LogImageDownloader.h"
+
+#include "GDALInterface/GDALInterface.h"
+#include "GDALInterface/DatasetPool.h"
+
+#include "cpl_vsi.h"
+
+#define LOCTEXT_NAMESPACE "FImageDownloaderModule"
+
+static const char* MemoryRoot = "/vsimem/ImageDownloader";
+
+FString PipelineMemory::InitializeStageDir(FString FolderName, bool bIntermediate, const TArray<FString>& InputFiles)
+{
+	const UImageDownloaderSettings* Settings = GetDefault<UImageDownloaderSettings>();
+
+	if (bIntermediate && Settings->bInMemoryPipeline)
+	{
+		FString MemoryFolder = FPaths::Combine(FString(MemoryRoot), FolderName);
+		DatasetPool::Invalidate(MemoryFolder);
+		VSIRmdirRecursive(TCHAR_TO_UTF8(*MemoryFolder));
+
+		int64 Budget = (int64) Settings->InMemoryPipelineBudgetMB << 20;
+		int64 Used = GetUsedBytes();
+		int64 Estimate = EstimateBytes(InputFiles);
+
+		if (Used + Estimate <= Budget)
+		{
+			VSIMkdirRecursive(TCHAR_TO_UTF8(*MemoryFolder), 0755);
+			return MemoryFolder;
+		}
+
+		UE_LOG(LogImageDownloader, Log, TEXT("Writing %s to disk as %lld MB are used out of the %d MB of the in-memory pipeline, and it needs about %lld MB"),
+			*FolderName, Used >> 20, Settings->InMemoryPipelineBudgetMB, Estimate >> 20
+		);
+	}
+
+	FString Folder = FPaths::Combine(Directories::ImageDownloaderDir(), FolderName);
+	DatasetPool::Invalidate(Folder);
+	if (!IPlatformFile::GetPlatformPhysical().DeleteDirectoryRecursively(*Folder) || !IPlatformFile::GetPlatformPhysical().CreateDirectory(*Folder))
+	{
+		Directories::CouldNotInitializeDirectory(Folder);
+		return "";
+	}
+	return Folder;
+}
+
+bool PipelineMemory::Materialize(TArray<FString>& Files, FString Folder)
+{
+	for (auto& File : Files)
+	{
+		if (!IsInMemory(File)) continue;
+
+		if (!IPlatformFile::GetPlatformPhysical().CreateDirectoryTree(*Folder))
+		{
+			Directories::CouldNotInitializeDirectory(Folder);
+			return false;
+		}
+
+		FString DiskFile = FPaths::Combine(Folder, FPaths::GetCleanFilename(File));
+		if (CPLCopyFile(TCHAR_TO_UTF8(*DiskFile), TCHAR_TO_UTF8(*File)) != 0)
+		{
+			UE_LOG(LogImageDownloader, Error, TEXT("Could not copy in-memory file %s to %s"), *File, *DiskFile);
+			return false;
+		}
+
+		VSIUnlink(TCHAR_TO_UTF8(*File));
+		File = DiskFile;
+	}
+
+	return true;
+}
+
+void PipelineMemory::Release(const TArray<FString>& Consumed, const TArray<FString>& Kept)
+{
+	for (auto& File : Consumed)
+	{
+		if (IsInMemory(File) && !Kept.Contains(File))
+		{
+			// pooled datasets would keep the memory of the file
+			DatasetPool::Invalidate(File);
+			VSIUnlink(TCHAR_TO_UTF8(*File));
+		}
+	}
+}
+
+bool PipelineMemory::IsInMemory(const FString& File)
+{
+	return File.StartsWith("/vsimem/");
+}
+
+int64 PipelineMemory::GetUsedBytes()
+{
+	int64 Used = 0;
+
+	char** Folders = VSIReadDir(MemoryRoot);
+	for (int i = 0; Folders && Folders[i]; i++)
+	{
+		CPLString Folder = CPLFormFilename(MemoryRoot, Folders[i], nullptr);
+		char** Files = VSIReadDir(Folder);
+		for (int j = 0; Files && Files[j]; j++)
+		{
+			VSIStatBufL Stat;
+			if (VSIStatL(CPLFormFilename(Folder, Files[j], nullptr), &Stat) == 0 && VSI_ISREG(Stat.st_mode))
+			{
+				Used += Stat.st_size;
+			}
+		}
+		CSLDestroy(Files);
+	}
+	CSLDestroy(Folders);
+
+	return Used;
+}
+
+void PipelineMemory::Clear()
+{
+	DatasetPool::Invalidate(MemoryRoot);
+	VSIRmdirRecursive(MemoryRoot);
+}
+
+int64 PipelineMemory::EstimateBytes(const TArray<FString>& Files)
+{
+	int64 Estimate = 0;
+	for (auto& File : Files)
+	{
+		FRasterMetadata Metadata;
+		if (DatasetPool::GetMetadata(File, Metadata))
+		{
+			Estimate += Metadata.GetUncompressedBytes();
+		}
+	}
+	return Estimate;
+}
+
+#undef LOCTEXT_NAMESPACE
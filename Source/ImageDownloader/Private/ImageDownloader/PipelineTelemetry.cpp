@@ -0,0 +1,264 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "ImageDownloader/PipelineTelemetry.h"
+#include "ImageDownloader/LogImageDownloader.h"
+#include "ImageDownloader/PipelineMemory.h"
+
+#include "FileDownloader/DownloadProgress.h"
+#include "GDALInterface/DatasetPool.h"
+
+#include "Dom/JsonObject.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/MiscTrace.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/WindowsHWrapper.h"
+#else
+#include <sys/resource.h>
+#endif
+
+#include "gdal.h"
+
+#define LOCTEXT_NAMESPACE "FImageDownloaderModule"
+
+TRACE_DECLARE_FLOAT_COUNTER(ImageDownloaderPhaseSeconds, TEXT("ImageDownloader/PhaseSeconds"));
+TRACE_DECLARE_INT_COUNTER(ImageDownloaderOutputBytes, TEXT("ImageDownloader/OutputBytes"));
+TRACE_DECLARE_INT_COUNTER(ImageDownloaderDownloadedBytes, TEXT("ImageDownloader/DownloadedBytes"));
+
+static double ToMB(int64 Bytes)
+{
+	return Bytes / (1024.0 * 1024.0);
+}
+
+double FStageTelemetry::GetThreadUtilization() const
+{
+	if (WallSeconds <= 0) return 0;
+	return FMath::Clamp(CPUSeconds / (WallSeconds * FPlatformMisc::NumberOfCoresIncludingHyperthreads()), 0.0, 1.0);
+}
+
+double FStageTelemetry::GetDownloadBytesPerSecond() const
+{
+	if (WallSeconds <= 0) return 0;
+	return DownloadedBytes / WallSeconds;
+}
+
+void FStageRecorder::Begin(FString Name, const TArray<FString>& InputFiles)
+{
+	Stage = FStageTelemetry();
+	Stage.Name = Name;
+	Stage.InputFiles = InputFiles.Num();
+	Stage.InputBytes = FPipelineTelemetry::GetFilesBytes(InputFiles);
+
+	StartSeconds = FPlatformTime::Seconds();
+	StartCPUSeconds = FPipelineTelemetry::GetProcessCPUSeconds();
+	StartDownloadedBytes = DownloadProgress::GetTotalBytesReceived();
+	StartPoolHits = DatasetPool::NumHits();
+	StartPoolMisses = DatasetPool::NumMisses();
+
+	TRACE_BOOKMARK(TEXT("ImageDownloader: Phase %s started"), *Name);
+}
+
+FStageTelemetry FStageRecorder::End(bool bSuccess, const TArray<FString>& OutputFiles)
+{
+	Stage.bSuccess = bSuccess;
+	Stage.WallSeconds = FPlatformTime::Seconds() - StartSeconds;
+	Stage.CPUSeconds = FPipelineTelemetry::GetProcessCPUSeconds() - StartCPUSeconds;
+	Stage.OutputFiles = OutputFiles.Num();
+	Stage.OutputBytes = FPipelineTelemetry::GetFilesBytes(OutputFiles);
+	Stage.DownloadedBytes = DownloadProgress::GetTotalBytesReceived() - StartDownloadedBytes;
+	Stage.PoolHits = DatasetPool::NumHits() - StartPoolHits;
+	Stage.PoolMisses = DatasetPool::NumMisses() - StartPoolMisses;
+
+	FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	Stage.UsedMemoryBytes = MemoryStats.UsedPhysical;
+	Stage.PeakMemoryBytes = MemoryStats.PeakUsedPhysical;
+	Stage.InMemoryPipelineBytes = PipelineMemory::GetUsedBytes();
+	Stage.GDALCacheBytes = GDALGetCacheUsed64();
+
+	TRACE_BOOKMARK(TEXT("ImageDownloader: Phase %s finished"), *Stage.Name);
+	TRACE_COUNTER_SET(ImageDownloaderPhaseSeconds, Stage.WallSeconds);
+	TRACE_COUNTER_ADD(ImageDownloaderOutputBytes, Stage.OutputBytes);
+	TRACE_COUNTER_ADD(ImageDownloaderDownloadedBytes, Stage.DownloadedBytes);
+
+	UE_LOG(LogImageDownloader, Log, TEXT("Phase %s: %.2fs wall, %.2fs CPU, %d files (%.1f MB) in, %d files (%.1f MB) out, %.1f MB downloaded"),
+		*Stage.Name, Stage.WallSeconds, Stage.CPUSeconds, Stage.InputFiles, ToMB(Stage.InputBytes), Stage.OutputFiles, ToMB(Stage.OutputBytes), ToMB(Stage.DownloadedBytes)
+	);
+
+	return Stage;
+}
+
+FPipelineTelemetry::FPipelineTelemetry(FString RunName0)
+{
+	RunName = RunName0;
+	StartTime = FDateTime::Now();
+	StartSeconds = FPlatformTime::Seconds();
+}
+
+void FPipelineTelemetry::Add(const FStageTelemetry& Stage)
+{
+	FScopeLock ScopeLock(&Lock);
+	Stages.Add(Stage);
+}
+
+void FPipelineTelemetry::Finish(bool bSuccess)
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+		bRunSuccess = bSuccess;
+		TotalSeconds = FPlatformTime::Seconds() - StartSeconds;
+	}
+
+	UE_LOG(LogImageDownloader, Log, TEXT("Telemetry of %s:\n%s"), *RunName, *ToTable());
+
+	FString Dir = OutputDir();
+	FString BaseName = FPaths::MakeValidFileName(RunName) + StartTime.ToString(TEXT("-%Y%m%d-%H%M%S"));
+	FString JSONFile = FPaths::Combine(Dir, BaseName + ".json");
+	FString CSVFile = FPaths::Combine(Dir, BaseName + ".csv");
+
+	if (!IPlatformFile::GetPlatformPhysical().CreateDirectoryTree(*Dir) ||
+		!FFileHelper::SaveStringToFile(ToJSON(), *JSONFile) ||
+		!FFileHelper::SaveStringToFile(ToCSV(), *CSVFile))
+	{
+		UE_LOG(LogImageDownloader, Warning, TEXT("Could not write the telemetry of %s to %s"), *RunName, *Dir);
+		return;
+	}
+
+	UE_LOG(LogImageDownloader, Log, TEXT("Wrote the telemetry of %s to %s and %s"), *RunName, *JSONFile, *CSVFile);
+}
+
+FString FPipelineTelemetry::ToTable() const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	TArray<FString> Lines;
+	Lines.Add(FString::Printf(TEXT("%-32s %9s %9s %5s %7s %9s %7s %9s %9s %8s %11s %9s"),
+		TEXT("Phase"), TEXT("Wall (s)"), TEXT("CPU (s)"), TEXT("Util"), TEXT("Files"), TEXT("In (MB)"), TEXT("Files"), TEXT("Out (MB)"),
+		TEXT("Down (MB)"), TEXT("MB/s"), TEXT("Pool hit/mi"), TEXT("Mem (MB)")
+	));
+
+	double StagesSeconds = 0;
+	for (const FStageTelemetry& Stage : Stages)
+	{
+		Lines.Add(FString::Printf(TEXT("%-32s %9.2f %9.2f %4.0f%% %7d %9.1f %7d %9.1f %9.1f %8.2f %5lld/%-5lld %9.0f%s"),
+			*Stage.Name.Left(32), Stage.WallSeconds, Stage.CPUSeconds, 100 * Stage.GetThreadUtilization(),
+			Stage.InputFiles, ToMB(Stage.InputBytes), Stage.OutputFiles, ToMB(Stage.OutputBytes),
+			ToMB(Stage.DownloadedBytes), ToMB(Stage.GetDownloadBytesPerSecond()), Stage.PoolHits, Stage.PoolMisses,
+			ToMB(Stage.UsedMemoryBytes), Stage.bSuccess ? TEXT("") : TEXT("  FAILED")
+		));
+		StagesSeconds += Stage.WallSeconds;
+	}
+
+	for (const FStageTelemetry& Stage : Stages)
+	{
+		if (StagesSeconds > 0 && Stage.WallSeconds / StagesSeconds >= 0.5)
+		{
+			Lines.Add(FString::Printf(TEXT("Phase %s took %.0f%% of the time of the phases"), *Stage.Name, 100 * Stage.WallSeconds / StagesSeconds));
+		}
+	}
+
+	Lines.Add(FString::Printf(TEXT("Total: %.2fs, %s"), TotalSeconds, bRunSuccess ? TEXT("succeeded") : TEXT("failed")));
+	return FString::Join(Lines, TEXT("\n"));
+}
+
+FString FPipelineTelemetry::ToJSON() const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	TArray<TSharedPtr<FJsonValue>> StageValues;
+	for (const FStageTelemetry& Stage : Stages)
+	{
+		TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+		Object->SetStringField(TEXT("Name"), Stage.Name);
+		Object->SetBoolField(TEXT("Success"), Stage.bSuccess);
+		Object->SetNumberField(TEXT("WallSeconds"), Stage.WallSeconds);
+		Object->SetNumberField(TEXT("CPUSeconds"), Stage.CPUSeconds);
+		Object->SetNumberField(TEXT("ThreadUtilization"), Stage.GetThreadUtilization());
+		Object->SetNumberField(TEXT("InputFiles"), Stage.InputFiles);
+		Object->SetNumberField(TEXT("InputBytes"), Stage.InputBytes);
+		Object->SetNumberField(TEXT("OutputFiles"), Stage.OutputFiles);
+		Object->SetNumberField(TEXT("OutputBytes"), Stage.OutputBytes);
+		Object->SetNumberField(TEXT("DownloadedBytes"), Stage.DownloadedBytes);
+		Object->SetNumberField(TEXT("DownloadBytesPerSecond"), Stage.GetDownloadBytesPerSecond());
+		Object->SetNumberField(TEXT("PoolHits"), Stage.PoolHits);
+		Object->SetNumberField(TEXT("PoolMisses"), Stage.PoolMisses);
+		Object->SetNumberField(TEXT("UsedMemoryBytes"), Stage.UsedMemoryBytes);
+		Object->SetNumberField(TEXT("PeakMemoryBytes"), Stage.PeakMemoryBytes);
+		Object->SetNumberField(TEXT("InMemoryPipelineBytes"), Stage.InMemoryPipelineBytes);
+		Object->SetNumberField(TEXT("GDALCacheBytes"), Stage.GDALCacheBytes);
+		StageValues.Add(MakeShared<FJsonValueObject>(Object));
+	}
+
+	TSharedPtr<FJsonObject> Run = MakeShared<FJsonObject>();
+	Run->SetStringField(TEXT("Name"), RunName);
+	Run->SetStringField(TEXT("StartTime"), StartTime.ToIso8601());
+	Run->SetBoolField(TEXT("Success"), bRunSuccess);
+	Run->SetNumberField(TEXT("Seconds"), TotalSeconds);
+	Run->SetNumberField(TEXT("Cores"), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+	Run->SetArrayField(TEXT("Phases"), StageValues);
+
+	FString Result;
+	FJsonSerializer::Serialize(Run.ToSharedRef(), TJsonWriterFactory<>::Create(&Result));
+	return Result;
+}
+
+FString FPipelineTelemetry::ToCSV() const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	TArray<FString> Lines;
+	Lines.Add(
+		"Phase,Success,WallSeconds,CPUSeconds,ThreadUtilization,InputFiles,InputBytes,OutputFiles,OutputBytes,"
+		"DownloadedBytes,DownloadBytesPerSecond,PoolHits,PoolMisses,UsedMemoryBytes,PeakMemoryBytes,InMemoryPipelineBytes,GDALCacheBytes"
+	);
+
+	for (const FStageTelemetry& Stage : Stages)
+	{
+		Lines.Add(FString::Printf(TEXT("\"%s\",%d,%f,%f,%f,%d,%lld,%d,%lld,%lld,%f,%lld,%lld,%lld,%lld,%lld,%lld"),
+			*Stage.Name.Replace(TEXT("\""), TEXT("\"\"")), Stage.bSuccess, Stage.WallSeconds, Stage.CPUSeconds, Stage.GetThreadUtilization(),
+			Stage.InputFiles, Stage.InputBytes, Stage.OutputFiles, Stage.OutputBytes, Stage.DownloadedBytes, Stage.GetDownloadBytesPerSecond(),
+			Stage.PoolHits, Stage.PoolMisses, Stage.UsedMemoryBytes, Stage.PeakMemoryBytes, Stage.InMemoryPipelineBytes, Stage.GDALCacheBytes
+		));
+	}
+
+	return FString::Join(Lines, TEXT("\n")) + "\n";
+}
+
+FString FPipelineTelemetry::OutputDir()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), "ImageDownloaderTelemetry");
+}
+
+double FPipelineTelemetry::GetProcessCPUSeconds()
+{
+#if PLATFORM_WINDOWS
+	FILETIME CreationTime, ExitTime, KernelTime, UserTime;
+	if (!GetProcessTimes(GetCurrentProcess(), &CreationTime, &ExitTime, &KernelTime, &UserTime)) return 0;
+
+	// in units of 100 nanoseconds
+	uint64 Kernel = ((uint64) KernelTime.dwHighDateTime << 32) | KernelTime.dwLowDateTime;
+	uint64 User = ((uint64) UserTime.dwHighDateTime << 32) | UserTime.dwLowDateTime;
+	return (Kernel + User) * 1e-7;
+#else
+	struct rusage Usage;
+	if (getrusage(RUSAGE_SELF, &Usage) != 0) return 0;
+
+	return Usage.ru_utime.tv_sec + Usage.ru_stime.tv_sec + (Usage.ru_utime.tv_usec + Usage.ru_stime.tv_usec) * 1e-6;
+#endif
+}
+
+int64 FPipelineTelemetry::GetFilesBytes(const TArray<FString>& Files)
+{
+	int64 Bytes = 0;
+	for (const FString& File : Files)
+	{
+		FFileStamp Stamp;
+		if (FFileStamp::Get(File, Stamp)) Bytes += Stamp.Size;
+	}
+	return Bytes;
+}
+
+#undef LOCTEXT_NAMESPACE
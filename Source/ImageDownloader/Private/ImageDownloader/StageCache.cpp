@@ -0,0 +1,211 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "ImageDownloader/StageCache.h"
+#include "ImageDownloader/LogImageDownloader.h"
+#include "ImageDownloader/PipelineMemory.h"
+
+#include "ConcurrencyHelpers/AppendOnlyManifest.h"
+
+#include "Algo/AllOf.h"
+#include "Async/ParallelFor.h"
+#include "Misc/Parse.h"
+#include "Misc/ScopeLock.h"
+
+#include <atomic>
+
+bool StageCache::Find(FString Key, const TArray<FString>& InputFiles, FStageRecord& OutRecord)
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+		FStageRecord* Found = Records.Find(Key);
+		if (!Found) return false;
+		OutRecord = *Found;
+	}
+
+	if (OutRecord.InputHashes.Num() != InputFiles.Num())
+	{
+		Remove(Key);
+		return false;
+	}
+
+	// the key already covers the size and modification time of the inputs, and outputs whose size or modification time
+	// changed are rejected before reading any file
+	for (int32 i = 0; i < OutRecord.OutputFiles.Num(); i++)
+	{
+		FFileStamp Stamp;
+		if (!FFileStamp::Get(OutRecord.OutputFiles[i], Stamp) || Stamp.ModificationTime != OutRecord.OutputStamps[i].ModificationTime || Stamp.Size != OutRecord.OutputStamps[i].Size)
+		{
+			UE_LOG(LogImageDownloader, Log, TEXT("Cannot reuse outputs of phase %s as '%s' has changed"), *Key, *OutRecord.OutputFiles[i]);
+			Remove(Key);
+			return false;
+		}
+	}
+
+	// modification times have a resolution of one second, so files rewritten right after the record are only noticed by their content
+	TArray<FString> Files = InputFiles;
+	TArray<uint32> Hashes = OutRecord.InputHashes;
+	Files.Append(OutRecord.OutputFiles);
+	for (auto& Stamp : OutRecord.OutputStamps) Hashes.Add(Stamp.ContentHash);
+
+	std::atomic<int32> Changed { INDEX_NONE };
+	ParallelFor(Files.Num(), [&](int32 i)
+	{
+		FFileStamp Stamp;
+		if (Changed == INDEX_NONE && (!FFileStamp::Get(Files[i], Stamp, true) || Stamp.ContentHash != Hashes[i])) Changed = i;
+	});
+
+	if (Changed != INDEX_NONE)
+	{
+		UE_LOG(LogImageDownloader, Log, TEXT("Cannot reuse outputs of phase %s as the content of '%s' has changed"), *Key, *Files[Changed]);
+		Remove(Key);
+		return false;
+	}
+
+	return true;
+}
+
+void StageCache::Record(FString Key, const TArray<FString>& InputFiles, FString OutputCRS, TArray<FString> OutputFiles)
+{
+	for (auto& OutputFile : OutputFiles)
+	{
+		if (PipelineMemory::IsInMemory(OutputFile)) return;
+	}
+
+	TArray<FString> Files = InputFiles;
+	Files.Append(OutputFiles);
+	TArray<FFileStamp> Stamps;
+	Stamps.SetNum(Files.Num());
+	std::atomic<bool> bSuccess { true };
+	ParallelFor(Files.Num(), [&](int32 i)
+	{
+		if (!FFileStamp::Get(Files[i], Stamps[i], true)) bSuccess = false;
+	});
+	if (!bSuccess) return;
+
+	FStageRecord Record;
+	Record.OutputCRS = OutputCRS;
+	Record.OutputFiles = OutputFiles;
+	for (int32 i = 0; i < InputFiles.Num(); i++)
+	{
+		Record.InputHashes.Add(Stamps[i].ContentHash);
+	}
+	for (int32 i = InputFiles.Num(); i < Files.Num(); i++)
+	{
+		Record.OutputStamps.Add(Stamps[i]);
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	Records.Add(Key, Record);
+	Manifest().Add(Key, ToFields(Record));
+}
+
+void StageCache::Remove(FString Key)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (Records.Remove(Key) > 0)
+	{
+		Manifest().Remove(Key);
+	}
+}
+
+void StageCache::Clear()
+{
+	FScopeLock ScopeLock(&Lock);
+	Records.Empty();
+	Manifest().Clear();
+}
+
+FAppendOnlyManifest& StageCache::Manifest()
+{
+	static FAppendOnlyManifest Manifest(
+		"stage cache", "StageCache.manifest",
+		[]() { return Records.Num(); },
+		[]()
+		{
+			TArray<FString> Lines;
+			for (auto& [Key, Record] : Records)
+			{
+				Lines.Add(FAppendOnlyManifest::MakeLine(Key, ToFields(Record)));
+			}
+			return Lines;
+		}
+	);
+	return Manifest;
+}
+
+FString StageCache::ManifestFile()
+{
+	return Manifest().GetFile();
+}
+
+void StageCache::Load()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	Records.Empty();
+	Manifest().Load(
+		[](const FString& Key, const TArray<FString>& Fields)
+		{
+			FStageRecord Record;
+			if (!FromFields(Fields, Record)) return false;
+			Records.Add(Key, Record);
+			return true;
+		},
+		[](const FString& Key) { Records.Remove(Key); }
+	);
+	Manifest().Compact();
+}
+
+TArray<FString> StageCache::ToFields(const FStageRecord& Record)
+{
+	TArray<FString> InputHashes;
+	for (uint32 Hash : Record.InputHashes)
+	{
+		InputHashes.Add(FString::Printf(TEXT("%08x"), Hash));
+	}
+
+	TArray<FString> Fields({ Record.OutputCRS, FString::Join(InputHashes, TEXT(",")) });
+	for (int32 i = 0; i < Record.OutputFiles.Num(); i++)
+	{
+		Fields.Add(Record.OutputFiles[i]);
+		Fields.Add(FString::Printf(TEXT("%lld"), Record.OutputStamps[i].ModificationTime));
+		Fields.Add(FString::Printf(TEXT("%lld"), Record.OutputStamps[i].Size));
+		Fields.Add(FString::Printf(TEXT("%08x"), Record.OutputStamps[i].ContentHash));
+	}
+	return Fields;
+}
+
+static bool IsHash(const FString& Field)
+{
+	return Field.Len() == 8 && Algo::AllOf(Field, FChar::IsHexDigit);
+}
+
+bool StageCache::FromFields(const TArray<FString>& Fields, FStageRecord& OutRecord)
+{
+	// four fields per output file; lines written before content hashes were added are rejected
+	if (Fields.Num() < 2 || (Fields.Num() - 2) % 4 != 0) return false;
+
+	OutRecord.OutputCRS = Fields[0];
+
+	TArray<FString> InputHashes;
+	Fields[1].ParseIntoArray(InputHashes, TEXT(","));
+	for (auto& Hash : InputHashes)
+	{
+		if (!IsHash(Hash)) return false;
+		OutRecord.InputHashes.Add(FParse::HexNumber(*Hash));
+	}
+
+	for (int32 i = 2; i < Fields.Num(); i += 4)
+	{
+		const FString& Hash = Fields[i + 3];
+		if (!IsHash(Hash)) return false;
+
+		FFileStamp Stamp;
+		Stamp.ModificationTime = FCString::Atoi64(*Fields[i + 1]);
+		Stamp.Size = FCString::Atoi64(*Fields[i + 2]);
+		Stamp.ContentHash = FParse::HexNumber(*Hash);
+		OutRecord.OutputFiles.Add(Fields[i]);
+		OutRecord.OutputStamps.Add(Stamp);
+	}
+	return true;
+}
@@ -0,0 +1,47 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GDALInterface/DatasetPool.h"
+
+class FAppendOnlyManifest;
+
+struct FStageRecord
+{
+	FString OutputCRS;
+
+	// in the order of the input files of the phase, whose paths, sizes and modification times are part of the key
+	TArray<uint32> InputHashes;
+
+	TArray<FString> OutputFiles;
+	TArray<FFileStamp> OutputStamps;
+};
+
+// Outputs of the fetcher phases that ran, keyed on a hash of the phase fingerprint, input CRS and input files (see HMCachedFetcher).
+// Records are persisted in an append-only manifest (see FAppendOnlyManifest), and a record is only returned while its output files are unchanged.
+class StageCache
+{
+public:
+	// Returns false if there is no record for `Key`, or if one of its input or output files was modified or deleted.
+	// The content of the files is only read when their sizes and modification times match the record,
+	// but this still reads them all on a hit, so this is meant to be called from the task pool.
+	static bool Find(FString Key, const TArray<FString>& InputFiles, FStageRecord& OutRecord);
+
+	// Does nothing if one of the files is in memory or does not exist, as such outputs cannot be reused later.
+	// Reads the input and output files to hash them, so this is meant to be called from the task pool too.
+	static void Record(FString Key, const TArray<FString>& InputFiles, FString OutputCRS, TArray<FString> OutputFiles);
+	static void Remove(FString Key);
+	static void Clear();
+
+	static FString ManifestFile();
+	static void Load();
+
+private:
+	static FAppendOnlyManifest& Manifest();
+	static TArray<FString> ToFields(const FStageRecord& Record);
+	static bool FromFields(const TArray<FString>& Fields, FStageRecord& OutRecord);
+
+	static inline TMap<FString, FStageRecord> Records;
+	static inline FCriticalSection Lock;
+};
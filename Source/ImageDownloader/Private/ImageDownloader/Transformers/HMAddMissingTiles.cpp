@@ -64,7 +64,8 @@ void HMAddMissingTiles::Fetch(FString InputCRS, TArray<FString> InputFiles, TFun
 			FString CurrentFile = FString::Format(TEXT("{0}_x{1}_y{2}.png"), { BaseName, i, j });
 			OutputFiles.Add(CurrentFile);
 
-			if (!FFileManagerGeneric::Get().FileExists(*CurrentFile))
+			VSIStatBufL Stat;
+			if (VSIStatL(TCHAR_TO_UTF8(*CurrentFile), &Stat) != 0)
 			{
 				UE_LOG(LogImageDownloader, Error, TEXT("Creating missing file: %s"), *CurrentFile);
 				GDALDataset *Dataset = MEMDriver->Create(
@@ -2,11 +2,10 @@
 
 #include "ImageDownloader/Transformers/HMConvert.h"
 #include "ImageDownloader/Directories.h"
+#include "ImageDownloader/PipelineMemory.h"
 #include "ImageDownloader/LogImageDownloader.h"
 #include "GDALInterface/GDALInterface.h"
 
-#include "Misc/ScopedSlowTask.h"
-
 #define LOCTEXT_NAMESPACE "FImageDownloaderModule"
 
 void HMConvert::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete)
@@ -23,11 +22,9 @@ void HMConvert::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<vo
 		return;
 	}
 
-	FString ConvertFolder = FPaths::Combine(Directories::ImageDownloaderDir(), Name + "-Convert");
-
-	if (!IPlatformFile::GetPlatformPhysical().DeleteDirectoryRecursively(*ConvertFolder) || !IPlatformFile::GetPlatformPhysical().CreateDirectory(*ConvertFolder))
+	FString ConvertFolder = PipelineMemory::InitializeStageDir(Name + "-Convert", bIntermediate, InputFiles);
+	if (ConvertFolder.IsEmpty())
 	{
-		Directories::CouldNotInitializeDirectory(ConvertFolder);
 		if (OnComplete) OnComplete(false);
 		return;
 	}
@@ -42,38 +39,28 @@ void HMConvert::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<vo
 	double MinAltitude = Altitudes[0];
 	double MaxAltitude = Altitudes[1];
 
-	FScopedSlowTask ConvertTask(
-		InputFiles.Num(),
-		FText::Format(
-			LOCTEXT("ConvertTask", "GDAL Interface: Translating Files to {0}"),
-			FText::FromString(NewExtension)
-		)
+	FText Message = FText::Format(
+		LOCTEXT("ConvertTask", "GDAL Interface: Translating Files to {0}"),
+		FText::FromString(NewExtension)
 	);
-	ConvertTask.MakeDialog(true);
 
-	for (int32 i = 0; i < InputFiles.Num(); i++)
+	bool bSuccess = RunPerFile(InputFiles, Message, [&](int32 i)
 	{
-		if (ConvertTask.ShouldCancel())
-		{
-			if (OnComplete) OnComplete(false);
-			return;
-		}
-
-		ConvertTask.EnterProgressFrame(1);
-
 		FString InputFile = InputFiles[i];
 		FString ConvertedFile = FPaths::Combine(ConvertFolder, FPaths::GetBaseFilename(InputFile) + "." + NewExtension);
-		OutputFiles.Add(ConvertedFile);
+		ParallelOutputs.Add(i, ConvertedFile);
 
-		if (!GDALInterface::Translate(InputFile, ConvertedFile, TArray<FString>()))
-		{
-			if (OnComplete) OnComplete(false);
-			return;
-		}
-	}
+		return GDALInterface::Translate(InputFile, ConvertedFile, TArray<FString>());
+	});
 
-	if (OnComplete) OnComplete(true);
+	if (OnComplete) OnComplete(bSuccess);
 	return;
 }
 
+bool HMConvert::GetFingerprint(FString& OutFingerprint) const
+{
+	OutFingerprint = FString::Join(TArray<FString>({ Name, NewExtension }), TEXT("|"));
+	return true;
+}
+
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
@@ -2,10 +2,11 @@
 
 #include "ImageDownloader/Transformers/HMCrop.h"
 #include "ImageDownloader/Directories.h"
+#include "ImageDownloader/PipelineMemory.h"
 #include "ImageDownloader/LogImageDownloader.h"
 #include "GDALInterface/GDALInterface.h"
 
-#include "Misc/ScopedSlowTask.h"
+#include "Misc/MessageDialog.h"
 
 #define LOCTEXT_NAMESPACE "FImageDownloaderModule"
 
@@ -22,11 +23,9 @@ void HMCrop::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(
 		return;
 	}
 
-	FString CropFolder = FPaths::Combine(Directories::ImageDownloaderDir(), Name + "-Crop");
-
-	if (!IPlatformFile::GetPlatformPhysical().DeleteDirectoryRecursively(*CropFolder) || !IPlatformFile::GetPlatformPhysical().CreateDirectory(*CropFolder))
+	FString CropFolder = PipelineMemory::InitializeStageDir(Name + "-Crop", bIntermediate, InputFiles);
+	if (CropFolder.IsEmpty())
 	{
-		Directories::CouldNotInitializeDirectory(CropFolder);
 		if (OnComplete) OnComplete(false);
 		return;
 	}
@@ -36,21 +35,11 @@ void HMCrop::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(
 	double North = Coordinates[3];
 	double East = Coordinates[1];
 
-	FScopedSlowTask CropTask(InputFiles.Num(), LOCTEXT("CropTask", "GDAL Interface: Cropping files"));
-	CropTask.MakeDialog(true);
-
-	for (int32 i = 0; i < InputFiles.Num(); i++)
+	bool bSuccess = RunPerFile(InputFiles, LOCTEXT("CropTask", "GDAL Interface: Cropping files"), [&](int32 i)
 	{
-		if (CropTask.ShouldCancel())
-		{
-			if (OnComplete) OnComplete(false);
-			return;
-		}
-		CropTask.EnterProgressFrame(1);
-
 		FString InputFile = InputFiles[i];
 		FString CroppedFile = FPaths::Combine(CropFolder, FPaths::GetBaseFilename(InputFile) + ".tif");
-		OutputFiles.Add(CroppedFile);
+		ParallelOutputs.Add(i, CroppedFile);
 
 		TArray<FString> Args;
 		Args.Add("-s_srs");
@@ -74,15 +63,25 @@ void HMCrop::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(
 			Args.Add(FString::FromInt(Pixels[1]));
 		}
 
-		if (!GDALInterface::Warp(InputFile, CroppedFile, Args))
-		{
-			if (OnComplete) OnComplete(false);
-			return;
-		}
-	}
+		return GDALInterface::Warp(InputFile, CroppedFile, Args);
+	});
 
-	if (OnComplete) OnComplete(true);
+	if (OnComplete) OnComplete(bSuccess);
 	return;
 }
 
+bool HMCrop::GetWarpOptions(FWarpOptions& OutOptions) const
+{
+	OutOptions = FWarpOptions();
+	OutOptions.Extent = Coordinates;
+	OutOptions.Size = Pixels;
+	return true;
+}
+
+bool HMCrop::GetFingerprint(FString& OutFingerprint) const
+{
+	OutFingerprint = FString::Printf(TEXT("%s|%.17g|%.17g|%.17g|%.17g|%d|%d"), *Name, Coordinates[0], Coordinates[1], Coordinates[2], Coordinates[3], Pixels.X, Pixels.Y);
+	return true;
+}
+
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
@@ -43,7 +43,7 @@ void HMEnsureOneBand::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunct
 
 		int NumRasters = Dataset->GetRasterCount();
 		GDALClose(Dataset);
-		if (NumRasters != 1 && !bWarned)
+		if (NumRasters != 1 && !bWarned && !IsRunningCommandlet())
 		{
 			bWarned = true;
 			EAppReturnType::Type UserResponse = FMessageDialog::Open(EAppMsgType::OkCancel,
@@ -3,7 +3,11 @@
 #include "ImageDownloader/Transformers/HMFunction.h"
 #include "ImageDownloader/Directories.h"
 #include "ImageDownloader/LogImageDownloader.h"
+#include "ImageDownloader/PipelineMemory.h"
+#include "GDALInterface/DatasetPool.h"
 #include "GDALInterface/GDALInterface.h"
+#include "GDALInterface/PixelExpression.h"
+#include "GDALInterface/RasterBlocks.h"
 #include "Misc/MessageDialog.h"
 
 #define LOCTEXT_NAMESPACE "FImageDownloaderModule"
@@ -11,90 +15,102 @@
 void HMFunction::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete)
 {
 	OutputCRS = InputCRS;
-	OutputFiles.Append(InputFiles);
 
-	for (auto &InputFile : InputFiles)
+	FPixelExpression Compiled;
+	if (!Expression.IsEmpty())
 	{
-		GDALDataset *Dataset = (GDALDataset *) GDALOpen(TCHAR_TO_UTF8(*InputFile), GA_Update);
-		if (!Dataset)
+		FString Error;
+		if (!FPixelExpression::Compile(Expression, Compiled, Error))
 		{
-			FMessageDialog::Open(EAppMsgType::Ok,
-				FText::Format(
-					LOCTEXT("HMFunction::Fetch::1", "Image Downloader Error: Could not open heightmap file '{0}'.\nError: {1}"),
-					FText::FromString(InputFile),
-					FText::FromString(FString(CPLGetLastErrorMsg()))
-				)
-			);
+			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
+				LOCTEXT("HMFunction::Fetch::Expression", "Image Downloader Error: {0}"),
+				FText::FromString(Error)
+			));
 			if (OnComplete) OnComplete(false);
 			return;
 		}
+	}
 
-		GDALRasterBand *Band = Dataset->GetRasterBand(1);
-
-		if (!Band)
+	// files on disk may be the outputs of a previous phase recorded by StageCache, or downloaded files, so they are not modified
+	FString FunctionFolder;
+	if (InputFiles.ContainsByPredicate([](const FString& InputFile) { return !PipelineMemory::IsInMemory(InputFile); }))
+	{
+		FunctionFolder = PipelineMemory::InitializeStageDir(Name + "-Function", bIntermediate, InputFiles);
+		if (FunctionFolder.IsEmpty())
 		{
-			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
-				LOCTEXT("HMFunction::Fetch::2", "Internal error: Could not get raster band of file {0}.\nError: {1}"),
-				FText::FromString(InputFile),
-				FText::FromString(FString(CPLGetLastErrorMsg()))
-			));
-			GDALClose(Dataset);
 			if (OnComplete) OnComplete(false);
 			return;
 		}
+	}
 
-		int SizeX = Band->GetXSize();
-		int SizeY = Band->GetYSize();
-		float *Data = (float*) CPLMalloc(SizeX * SizeY * sizeof(float));
+	for (auto &InputFile : InputFiles)
+	{
+		FString OutputFile = InputFile;
+		if (!PipelineMemory::IsInMemory(InputFile))
+		{
+			OutputFile = FPaths::Combine(FunctionFolder, FPaths::GetCleanFilename(InputFile));
+			if (!GDALInterface::Translate(InputFile, OutputFile, TArray<FString>()))
+			{
+				if (OnComplete) OnComplete(false);
+				return;
+			}
+		}
+		OutputFiles.Add(OutputFile);
 
-		if (!Data)
+		DatasetPool::Invalidate(OutputFile);
+		FGDALDatasetHandle Dataset = FGDALDatasetHandle::Open(OutputFile, true);
+		if (!Dataset)
 		{
 			FMessageDialog::Open(EAppMsgType::Ok,
-				LOCTEXT("HMFunction::Fetch::3", "Internal error: Could not allocate memory.")
+				FText::Format(
+					LOCTEXT("HMFunction::Fetch::1", "Image Downloader Error: Could not open heightmap file '{0}'.\nError: {1}"),
+					FText::FromString(OutputFile),
+					FText::FromString(FString(CPLGetLastErrorMsg()))
+				)
 			);
-			GDALClose(Dataset);
 			if (OnComplete) OnComplete(false);
 			return;
 		}
 
-		CPLErr Err;
-		Err = Band->RasterIO(GF_Read, 0, 0, SizeX, SizeY, Data, SizeX, SizeY, GDT_Float32, 0, 0);
+		GDALRasterBand *Band = Dataset->GetRasterBand(1);
 
-		if (Err != CE_None)
+		if (!Band)
 		{
 			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
-				LOCTEXT("HMFunction::Fetch::4", "Internal error: Could not read data from file {0}.\nError: {1}"),
-				FText::FromString(InputFile),
+				LOCTEXT("HMFunction::Fetch::2", "Internal error: Could not get raster band of file {0}.\nError: {1}"),
+				FText::FromString(OutputFile),
 				FText::FromString(FString(CPLGetLastErrorMsg()))
 			));
-			GDALClose(Dataset);
 			if (OnComplete) OnComplete(false);
 			return;
 		}
 
-		for (int i = 0; i < SizeX; i++)
+		// the file is processed block by block, so that large rasters do not need to fit in memory
+		bool bSuccess = RasterBlocks::ForEachWindow<float>(Band, 0, true, true, [this, &Compiled](const FRasterWindow& Window, TRasterView<float>& View)
 		{
-			for (int j = 0; j < SizeY; j++)
+			if (Compiled.IsValid())
 			{
-				Data[i + j * SizeX] = Function(Data[i + j * SizeX]);
+				Compiled.Evaluate(View.Data.GetData(), View.Data.Num());
+				return true;
 			}
-		}
-		Err = Band->RasterIO(GF_Write, 0, 0, SizeX, SizeY, Data, SizeX, SizeY, GDT_Float32, 0, 0);
-		CPLFree(Data);
 
-		if (Err != CE_None)
+			for (float& Value : View.Data)
+			{
+				Value = Function(Value);
+			}
+			return true;
+		});
+
+		if (!bSuccess)
 		{
 			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
-				LOCTEXT("HMFunction::Fetch::5", "Internal error: Could not write data to dataset in file {0}.\nError: {1}"),
-				FText::FromString(InputFile),
+				LOCTEXT("HMFunction::Fetch::4", "Internal error: Could not transform data in file {0}.\nError: {1}"),
+				FText::FromString(OutputFile),
 				FText::FromString(FString(CPLGetLastErrorMsg()))
 			));
-			GDALClose(Dataset);
 			if (OnComplete) OnComplete(false);
 			return;
 		}
-
-		GDALClose(Dataset);
 	}
 
 	if (OnComplete) OnComplete(true);
@@ -0,0 +1,102 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "ImageDownloader/Transformers/HMFusedWarp.h"
+#include "ImageDownloader/PipelineMemory.h"
+#include "ImageDownloader/LogImageDownloader.h"
+#include "GDALInterface/GDALInterface.h"
+
+#include "Misc/MessageDialog.h"
+#include "Misc/ScopedSlowTask.h"
+
+#define LOCTEXT_NAMESPACE "FImageDownloaderModule"
+
+void HMFusedWarp::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete)
+{
+	if (InputFiles.IsEmpty())
+	{
+		FMessageDialog::Open(EAppMsgType::Ok,
+			FText::Format(
+				LOCTEXT("HMFusedWarp::Fetch::NoInput", "Phases {0} did not receive any input file."),
+				FText::FromString(FString::Join(StepNames, TEXT("+")))
+			)
+		);
+		if (OnComplete) OnComplete(false);
+		return;
+	}
+
+	FWarpOptions Options;
+	Options.SourceCRS = InputCRS;
+	for (auto& Step : Steps)
+	{
+		Options = Options.Then(Step);
+	}
+	OutputCRS = Options.TargetCRS.IsEmpty() ? InputCRS : Options.TargetCRS;
+
+	if (Options.IsIdentity())
+	{
+		UE_LOG(LogImageDownloader, Log, TEXT("Skipping phases %s as they leave the input files unchanged"), *FString::Join(StepNames, TEXT("+")));
+		OutputFiles.Append(InputFiles);
+		if (OnComplete) OnComplete(true);
+		return;
+	}
+
+	FString WarpFolder = PipelineMemory::InitializeStageDir(Name + "-Warp", bIntermediate, InputFiles);
+	if (WarpFolder.IsEmpty())
+	{
+		if (OnComplete) OnComplete(false);
+		return;
+	}
+
+	FString WarpedFile = FPaths::Combine(WarpFolder, Name + ".tif");
+
+	FScopedSlowTask WarpTask(1, LOCTEXT("FusedWarpTask", "GDAL Interface: Reprojecting and cropping files"));
+	WarpTask.MakeDialog();
+
+	// a VRT is only a list of references to the input files, so the pixels are still read once, by gdalwarp
+	FString SourceFile = InputFiles[0];
+	if (InputFiles.Num() > 1)
+	{
+		SourceFile = FPaths::Combine(WarpFolder, Name + ".vrt");
+		if (!GDALInterface::Merge(InputFiles, SourceFile))
+		{
+			if (OnComplete) OnComplete(false);
+			return;
+		}
+	}
+
+	if (!GDALInterface::Warp(SourceFile, WarpedFile, Options.ToArgs()))
+	{
+		if (OnComplete) OnComplete(false);
+		return;
+	}
+
+	OutputFiles.Add(WarpedFile);
+	if (OnComplete) OnComplete(true);
+}
+
+bool HMFusedWarp::GetWarpOptions(FWarpOptions& OutOptions) const
+{
+	OutOptions = FWarpOptions();
+	for (auto& Step : Steps)
+	{
+		OutOptions = OutOptions.Then(Step);
+	}
+	return true;
+}
+
+FString HMFusedWarp::GetPlanName() const
+{
+	FWarpOptions Options;
+	GetWarpOptions(Options);
+	return FString::Format(TEXT("HMFusedWarp({0}): gdalwarp {1}"), { FString::Join(StepNames, TEXT(", ")), FString::Join(Options.ToArgs(), TEXT(" ")) });
+}
+
+bool HMFusedWarp::GetFingerprint(FString& OutFingerprint) const
+{
+	FWarpOptions Options;
+	GetWarpOptions(Options);
+	OutFingerprint = Name + "|" + FString::Join(Options.ToArgs(), TEXT(" "));
+	return true;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -2,6 +2,7 @@
 
 #include "ImageDownloader/Transformers/HMMerge.h"
 #include "ImageDownloader/Directories.h"
+#include "ImageDownloader/PipelineMemory.h"
 #include "ImageDownloader/LogImageDownloader.h"
 #include "GDALInterface/GDALInterface.h"
 
@@ -13,14 +14,9 @@ void HMMerge::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void
 {
 	OutputCRS = InputCRS;
 
-	FString MergeFolder = FPaths::Combine(
-		Directories::ImageDownloaderDir(),
-		Name + "-Merge"
-	);
-	
-	if (!IPlatformFile::GetPlatformPhysical().CreateDirectory(*MergeFolder))
+	FString MergeFolder = PipelineMemory::InitializeStageDir(Name + "-Merge", bIntermediate, InputFiles);
+	if (MergeFolder.IsEmpty())
 	{
-		Directories::CouldNotInitializeDirectory(MergeFolder);
 		if (OnComplete) OnComplete(false);
 		return;
 	}
@@ -42,4 +38,10 @@ void HMMerge::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void
 	}
 }
 
+bool HMMerge::GetFingerprint(FString& OutFingerprint) const
+{
+	OutFingerprint = Name;
+	return true;
+}
+
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
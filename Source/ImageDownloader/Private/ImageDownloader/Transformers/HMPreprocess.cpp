@@ -2,6 +2,7 @@
 
 #include "ImageDownloader/Transformers/HMPreprocess.h"
 #include "ImageDownloader/Directories.h"
+#include "ImageDownloader/PipelineMemory.h"
 #include "ImageDownloader/LogImageDownloader.h"
 #include "ConsoleHelpers/Console.h"
 
@@ -9,7 +10,7 @@
 
 #define LOCTEXT_NAMESPACE "FImageDownloaderModule"
 
-void HMPreprocess::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete)
+void HMPreprocess::Fetch(FString InputCRS, TArray<FString> InputFiles0, TFunction<void(bool)> OnComplete)
 {
 	if (!ExternalTool || ExternalTool->Command.IsEmpty())
 	{
@@ -30,6 +31,14 @@ void HMPreprocess::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction
 		return;
 	}
 
+	// the external tool cannot read files from the in-memory pipeline
+	TArray<FString> InputFiles = InputFiles0;
+	if (!PipelineMemory::Materialize(InputFiles, FPaths::Combine(Directories::ImageDownloaderDir(), Name + "-PreprocessInput")))
+	{
+		if (OnComplete) OnComplete(false);
+		return;
+	}
+
 	FScopedSlowTask PreprocessTask(InputFiles.Num(), FText::Format(LOCTEXT("PreprocessTask", "Preprocessing Files using Command {0}"), FText::FromString(ExternalTool->Command)));
 	PreprocessTask.MakeDialog();
 
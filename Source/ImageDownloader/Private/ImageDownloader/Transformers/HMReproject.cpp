@@ -2,6 +2,7 @@
 
 #include "ImageDownloader/Transformers/HMReproject.h"
 #include "ImageDownloader/Directories.h"
+#include "ImageDownloader/PipelineMemory.h"
 #include "ImageDownloader/LogImageDownloader.h"
 #include "GDALInterface/GDALInterface.h"
 
@@ -19,14 +20,9 @@ void HMReproject::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<
 		return;
 	}
 
-	FString ReprojectedFolder = FPaths::Combine(
-		Directories::ImageDownloaderDir(),
-		Name + "-" + OutputCRS.Replace(TEXT(":"), TEXT("_"))
-	);
-	
-	if (!IPlatformFile::GetPlatformPhysical().CreateDirectory(*ReprojectedFolder))
+	FString ReprojectedFolder = PipelineMemory::InitializeStageDir(Name + "-" + OutputCRS.Replace(TEXT(":"), TEXT("_")), bIntermediate, InputFiles);
+	if (ReprojectedFolder.IsEmpty())
 	{
-		Directories::CouldNotInitializeDirectory(ReprojectedFolder);
 		if (OnComplete) OnComplete(false);
 		return;
 	}
@@ -52,4 +48,20 @@ void HMReproject::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<
 	}
 }
 
+bool HMReproject::GetWarpOptions(FWarpOptions& OutOptions) const
+{
+	// same options as GDALInterface::Warp(SourceFiles, TargetFile, InCRS, OutCRS, 0)
+	OutOptions = FWarpOptions();
+	OutOptions.TargetCRS = OutputCRS;
+	OutOptions.Resampling = "bilinear";
+	OutOptions.DstNoData = 0;
+	return true;
+}
+
+bool HMReproject::GetFingerprint(FString& OutFingerprint) const
+{
+	OutFingerprint = FString::Join(TArray<FString>({ Name, OutputCRS }), TEXT("|"));
+	return true;
+}
+
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
@@ -2,12 +2,10 @@
 
 #include "ImageDownloader/Transformers/HMResolution.h"
 #include "ImageDownloader/Directories.h"
+#include "ImageDownloader/PipelineMemory.h"
 #include "ImageDownloader/LogImageDownloader.h"
 
 #include "GDALInterface/GDALInterface.h"
-#include "ConcurrencyHelpers/Concurrency.h"
-
-#include "Misc/ScopedSlowTask.h"
 
 #define LOCTEXT_NAMESPACE "FImageDownloaderModule"
 
@@ -15,34 +13,30 @@
 void HMResolution::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete)
 {
 	OutputCRS = InputCRS;
-	FString ResolutionFolder = FPaths::Combine(Directories::ImageDownloaderDir(), Name + "-Resolution" + FString::FromInt(PrecisionPercent));
-
-	if (!IPlatformFile::GetPlatformPhysical().DeleteDirectoryRecursively(*ResolutionFolder) || !IPlatformFile::GetPlatformPhysical().CreateDirectory(*ResolutionFolder))
+	FString ResolutionFolder = PipelineMemory::InitializeStageDir(Name + "-Resolution" + FString::FromInt(PrecisionPercent), bIntermediate, InputFiles);
+	if (ResolutionFolder.IsEmpty())
 	{
-		Directories::CouldNotInitializeDirectory(ResolutionFolder);
 		if (OnComplete) OnComplete(false);
 		return;
 	}
 
-	FScopedSlowTask ResolutionTask(InputFiles.Num(), LOCTEXT("WarpTask", "GDAL Interface: Scaling Resolution"));
-	ResolutionTask.MakeDialog();
-
-	for (int32 i = 0; i < InputFiles.Num(); i++)
+	bool bSuccess = RunPerFile(InputFiles, LOCTEXT("WarpTask", "GDAL Interface: Scaling Resolution"), [&](int32 i)
 	{
-		ResolutionTask.EnterProgressFrame(1);
 		FString InputFile = InputFiles[i];
 		FString OutputFile = FPaths::Combine(ResolutionFolder, FPaths::GetCleanFilename(InputFile));
-		OutputFiles.Add(OutputFile);
+		ParallelOutputs.Add(i, OutputFile);
 
-		if (!GDALInterface::ChangeResolution(InputFile, OutputFile, PrecisionPercent))
-		{
-			if (OnComplete) OnComplete(false);
-			return;
-		}
-	}
-	if (OnComplete) OnComplete(true);
+		return GDALInterface::ChangeResolution(InputFile, OutputFile, PrecisionPercent);
+	});
+
+	if (OnComplete) OnComplete(bSuccess);
 	return;
 }
 
+bool HMResolution::GetFingerprint(FString& OutFingerprint) const
+{
+	OutFingerprint = FString::Join(TArray<FString>({ Name, FString::FromInt(PrecisionPercent) }), TEXT("|"));
+	return true;
+}
 
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
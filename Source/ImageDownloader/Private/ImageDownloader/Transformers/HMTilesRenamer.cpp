@@ -3,10 +3,17 @@
 #include "ImageDownloader/Transformers/HMTilesRenamer.h"
 #include "ImageDownloader/Directories.h"
 #include "ImageDownloader/LogImageDownloader.h"
+#include "ImageDownloader/PipelineMemory.h"
 
-#include "HAL/FileManagerGeneric.h"
+#include "GDALInterface/GDALInterface.h"
+
+#include "Misc/MessageDialog.h"
 #include "Misc/ScopedSlowTask.h"
 
+#include "cpl_vsi.h"
+
+#define LOCTEXT_NAMESPACE "FImageDownloaderModule"
+
 void HMTilesRenamer::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete)
 {
 	OutputCRS = InputCRS;
@@ -14,7 +21,8 @@ void HMTilesRenamer::Fetch(FString InputCRS, TArray<FString> InputFiles, TFuncti
 	if (InputFiles.Num() == 1)
 	{
 		OutputFiles.Add(InputFiles[0]);
-		if (OnComplete) OnComplete(true);
+		bool bSuccess = bIntermediate || PipelineMemory::Materialize(OutputFiles, FPaths::Combine(Directories::ImageDownloaderDir(), Name + "-Renamer"));
+		if (OnComplete) OnComplete(bSuccess);
 		return;
 	}
 
@@ -34,13 +42,26 @@ void HMTilesRenamer::Fetch(FString InputCRS, TArray<FString> InputFiles, TFuncti
 	{
 		FString OutputFile = FPaths::Combine(RenamerFolder, Rename(InputFile));
 		UE_LOG(LogImageDownloader, Log, TEXT("Copying %s to %s"), *InputFile, *OutputFile);
-		FFileManagerGeneric::Get().Copy(*OutputFile, *InputFile);
 
+		// through VSI, as the inputs may be in memory (see PipelineMemory)
 		FString AuxFile = InputFile + ".aux.xml";
-		if (FFileManagerGeneric::Get().FileExists(*AuxFile))
+		VSIStatBufL Stat;
+		bool bCopied =
+			CPLCopyFile(TCHAR_TO_UTF8(*OutputFile), TCHAR_TO_UTF8(*InputFile)) == 0 &&
+			(VSIStatL(TCHAR_TO_UTF8(*AuxFile), &Stat) != 0 || CPLCopyFile(TCHAR_TO_UTF8(*(OutputFile + ".aux.xml")), TCHAR_TO_UTF8(*AuxFile)) == 0);
+
+		if (!bCopied)
 		{
-			FFileManagerGeneric::Get().Copy(*(OutputFile + ".aux.xml"), *AuxFile);
+			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
+				LOCTEXT("HMTilesRenamer::Fetch::Copy", "Image Downloader Error: Could not copy file {0} to {1}.\nError: {2}"),
+				FText::FromString(InputFile),
+				FText::FromString(OutputFile),
+				FText::FromString(FString(CPLGetLastErrorMsg()))
+			));
+			if (OnComplete) OnComplete(false);
+			return;
 		}
+
 		OutputFiles.Add(OutputFile);
 	}
 
@@ -53,3 +74,5 @@ FString HMTilesRenamer::Rename(FString Tile) const
 	int Y = this->TileToY(Tile);
 	return FString::Format(TEXT("{0}_x{1}_y{2}.{3}"), { Name, X - FirstTileX, Y - FirstTileY, FPaths::GetExtension(Tile) });
 }
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,51 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "ImageDownloader/Transformers/HMToCOG.h"
+#include "ImageDownloader/PipelineMemory.h"
+#include "ImageDownloader/LogImageDownloader.h"
+
+#include "GDALInterface/GDALInterface.h"
+
+#define LOCTEXT_NAMESPACE "FImageDownloaderModule"
+
+void HMToCOG::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete)
+{
+	OutputCRS = InputCRS;
+	FString COGFolder = PipelineMemory::InitializeStageDir(Name + "-COG", bIntermediate, InputFiles);
+	if (COGFolder.IsEmpty())
+	{
+		if (OnComplete) OnComplete(false);
+		return;
+	}
+
+	// the COG driver requires block sizes that are multiples of 16
+	int ClampedBlockSize = FMath::Max(16, BlockSize / 16 * 16);
+
+	TArray<FString> Args = {
+		"-of", "COG",
+		"-co", "COMPRESS=DEFLATE",
+		"-co", FString::Printf(TEXT("BLOCKSIZE=%d"), ClampedBlockSize),
+		"-co", "PREDICTOR=" + Predictor,
+		"-co", "OVERVIEW_RESAMPLING=" + Resampling,
+		"-co", "BIGTIFF=IF_SAFER"
+	};
+
+	bool bSuccess = RunPerFile(InputFiles, LOCTEXT("HMToCOG", "GDAL Interface: Writing Cloud-Optimized GeoTIFFs"), [&](int32 i)
+	{
+		FString InputFile = InputFiles[i];
+		FString OutputFile = FPaths::Combine(COGFolder, FPaths::GetBaseFilename(InputFile) + ".tif");
+		ParallelOutputs.Add(i, OutputFile);
+
+		return GDALInterface::Translate(InputFile, OutputFile, Args);
+	});
+
+	if (OnComplete) OnComplete(bSuccess);
+}
+
+bool HMToCOG::GetFingerprint(FString& OutFingerprint) const
+{
+	OutFingerprint = FString::Printf(TEXT("%s|%s|%d|%s"), *Name, *Resampling, BlockSize, *Predictor);
+	return true;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -2,21 +2,18 @@
 
 #include "ImageDownloader/Transformers/HMToPNG.h"
 #include "ImageDownloader/Directories.h"
+#include "ImageDownloader/PipelineMemory.h"
 #include "ImageDownloader/LogImageDownloader.h"
 #include "GDALInterface/GDALInterface.h"
 
-#include "Misc/ScopedSlowTask.h"
-
 #define LOCTEXT_NAMESPACE "FImageDownloaderModule"
 
 void HMToPNG::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete)
 {
 	OutputCRS = InputCRS;
-	FString PNGFolder = FPaths::Combine(Directories::ImageDownloaderDir(), Name + "-PNG");
-
-	if (!IPlatformFile::GetPlatformPhysical().DeleteDirectoryRecursively(*PNGFolder) || !IPlatformFile::GetPlatformPhysical().CreateDirectory(*PNGFolder))
+	FString PNGFolder = PipelineMemory::InitializeStageDir(Name + "-PNG", bIntermediate, InputFiles);
+	if (PNGFolder.IsEmpty())
 	{
-		Directories::CouldNotInitializeDirectory(PNGFolder);
 		if (OnComplete) OnComplete(false);
 		return;
 	}
@@ -31,42 +28,30 @@ void HMToPNG::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void
 	double MinAltitude = Altitudes[0];
 	double MaxAltitude = Altitudes[1];
 
-	FScopedSlowTask ToPNGTask(InputFiles.Num(), LOCTEXT("ToPNGTask", "GDAL Interface: Translating Files to PNG"));
-	ToPNGTask.MakeDialog(true);
-
-	for (int32 i = 0; i < InputFiles.Num(); i++)
+	bool bSuccess = RunPerFile(InputFiles, LOCTEXT("ToPNGTask", "GDAL Interface: Translating Files to PNG"), [&](int32 i)
 	{
-		if (ToPNGTask.ShouldCancel())
-		{
-			if (OnComplete) OnComplete(false);
-			return;
-		}
-		ToPNGTask.EnterProgressFrame(1);
-
 		FString InputFile = InputFiles[i];
 		FString PNGFile = FPaths::Combine(PNGFolder, FPaths::GetBaseFilename(InputFile) + ".png");
-		OutputFiles.Add(PNGFile);
+		ParallelOutputs.Add(i, PNGFile);
 
 		if (bScaleAltitude)
 		{
-			if (!GDALInterface::ConvertToPNG(InputFile, PNGFile, MinAltitude, MaxAltitude))
-			{
-				if (OnComplete) OnComplete(false);
-				return;
-			}
+			return GDALInterface::ConvertToPNG(InputFile, PNGFile, MinAltitude, MaxAltitude);
 		}
 		else
 		{
-			if (!GDALInterface::ConvertToPNG(InputFile, PNGFile, 0, 255))
-			{
-				if (OnComplete) OnComplete(false);
-				return;
-			}
+			return GDALInterface::ConvertToPNG(InputFile, PNGFile, 0, 255);
 		}
-	}
+	});
 
-	if (OnComplete) OnComplete(true);
+	if (OnComplete) OnComplete(bSuccess);
 	return;
 }
 
+bool HMToPNG::GetFingerprint(FString& OutFingerprint) const
+{
+	OutFingerprint = FString::Join(TArray<FString>({ Name, bScaleAltitude ? "Scale" : "NoScale" }), TEXT("|"));
+	return true;
+}
+
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
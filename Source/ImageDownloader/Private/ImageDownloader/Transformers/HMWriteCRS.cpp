@@ -72,4 +72,10 @@ void HMWriteCRS::Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<v
 	return;
 }
 
+bool HMWriteCRS::GetFingerprint(FString& OutFingerprint) const
+{
+	OutFingerprint = FString::Printf(TEXT("%s|%d|%d|%.17g|%.17g|%.17g|%.17g"), *Name, Width, Height, MinLong, MaxLong, MinLat, MaxLat);
+	return true;
+}
+
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,80 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "ImageDownloader/WarpOptions.h"
+
+bool FWarpOptions::IsIdentity() const
+{
+	return (TargetCRS.IsEmpty() || TargetCRS == SourceCRS) && Extent == FVector4d::Zero() && Size == FIntPoint::ZeroValue;
+}
+
+bool FWarpOptions::CanBeFollowedBy(const FWarpOptions& Next) const
+{
+	bool bHasGeometry = Extent != FVector4d::Zero() || Size != FIntPoint::ZeroValue;
+	return !bHasGeometry || Next.TargetCRS.IsEmpty();
+}
+
+FWarpOptions FWarpOptions::Then(const FWarpOptions& Next) const
+{
+	// `Next` does nothing on our output (for instance, a reprojection to the CRS we already have)
+	bool bSameCRS = Next.TargetCRS.IsEmpty() || Next.TargetCRS == TargetCRS || (TargetCRS.IsEmpty() && Next.TargetCRS == SourceCRS);
+	if (bSameCRS && Next.Extent == FVector4d::Zero() && Next.Size == FIntPoint::ZeroValue) return *this;
+
+	check(CanBeFollowedBy(Next));
+
+	FWarpOptions Result = *this;
+	if (!Next.TargetCRS.IsEmpty()) Result.TargetCRS = Next.TargetCRS;
+	if (!Next.Resampling.IsEmpty()) Result.Resampling = Next.Resampling;
+	if (Next.DstNoData.IsSet()) Result.DstNoData = Next.DstNoData;
+	if (Next.Extent != FVector4d::Zero()) Result.Extent = Next.Extent;
+	if (Next.Size != FIntPoint::ZeroValue) Result.Size = Next.Size;
+
+	return Result;
+}
+
+TArray<FString> FWarpOptions::ToArgs() const
+{
+	TArray<FString> Args;
+
+	if (!Resampling.IsEmpty())
+	{
+		Args.Add("-r");
+		Args.Add(Resampling);
+	}
+
+	if (!SourceCRS.IsEmpty())
+	{
+		Args.Add("-s_srs");
+		Args.Add(SourceCRS);
+	}
+
+	FString OutputCRS = TargetCRS.IsEmpty() ? SourceCRS : TargetCRS;
+	if (!OutputCRS.IsEmpty())
+	{
+		Args.Add("-t_srs");
+		Args.Add(OutputCRS);
+	}
+
+	if (DstNoData.IsSet())
+	{
+		Args.Add("-dstnodata");
+		Args.Add(FString::SanitizeFloat(DstNoData.GetValue()));
+	}
+
+	if (Extent != FVector4d::Zero())
+	{
+		Args.Add("-te");
+		Args.Add(FString::SanitizeFloat(Extent[0]));
+		Args.Add(FString::SanitizeFloat(Extent[2]));
+		Args.Add(FString::SanitizeFloat(Extent[1]));
+		Args.Add(FString::SanitizeFloat(Extent[3]));
+	}
+
+	if (Size != FIntPoint::ZeroValue)
+	{
+		Args.Add("-ts");
+		Args.Add(FString::FromInt(Size[0]));
+		Args.Add(FString::FromInt(Size[1]));
+	}
+
+	return Args;
+}
@@ -5,6 +5,7 @@
 
 #include "ImageDownloader/BasicImageDownloaderCustomization.h"
 #include "ImageDownloader/BasicImageDownloader.h"
+#include "ImageDownloader/StageCache.h"
 	
 IMPLEMENT_MODULE(FImageDownloaderModule, ImageDownloader)
 
@@ -12,4 +13,6 @@ void FImageDownloaderModule::StartupModule()
 {
     FPropertyEditorModule& PropertyModule = FModuleManager::LoadModuleChecked<FPropertyEditorModule>("PropertyEditor");
     PropertyModule.RegisterCustomClassLayout(ABasicImageDownloader::StaticClass()->GetFName(), FOnGetDetailCustomizationInstance::CreateStatic(&FBasicImageDownloaderCustomization::MakeInstance));
+
+    StageCache::Load();
 }
@@ -6,7 +6,7 @@
 
 #define LOCTEXT_NAMESPACE "FImageDownloaderModule"
 
-class HMURL : public HMFetcher
+class IMAGEDOWNLOADER_API HMURL : public HMFetcher
 {
 public:
 	HMURL(FString URL0, FString FileName0, FString CRS) : URL(URL0), FileName(FileName0)
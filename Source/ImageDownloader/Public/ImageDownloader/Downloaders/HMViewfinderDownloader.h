@@ -7,7 +7,7 @@
 
 #define LOCTEXT_NAMESPACE "FImageDownloaderModule"
 
-class HMViewfinderDownloader: public HMFetcher
+class IMAGEDOWNLOADER_API HMViewfinderDownloader: public HMFetcher
 {
 public:
 	HMViewfinderDownloader(FString MegaTilesString, FString BaseURL, bool bIs15);
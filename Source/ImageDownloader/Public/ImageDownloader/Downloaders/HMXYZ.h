@@ -4,13 +4,15 @@
 
 #include "CoreMinimal.h"
 #include "ImageDownloader/HMFetcher.h"
+#include "MapboxHelpers/MapboxHelpers.h"
 
 #define LOCTEXT_NAMESPACE "FImageDownloaderModule"
 
-class HMXYZ: public HMFetcher
+class IMAGEDOWNLOADER_API HMXYZ: public HMFetcher
 {
 public:
-	HMXYZ(FString Name0, FString Layer0, FString Format0, FString URL0, int Zoom0, int MinX0, int MaxX0, int MinY0, int MaxY0, bool bMaxY_IsNorth0, bool bGeoreferenceSlippyTiles0, bool bDecodeMapbox0, FString CRS0)
+	// When `bDecodeTerrainRGB0` is true, tiles are decoded from `Encoding0` into single-band heightmaps
+	HMXYZ(FString Name0, FString Layer0, FString Format0, FString URL0, int Zoom0, int MinX0, int MaxX0, int MinY0, int MaxY0, bool bMaxY_IsNorth0, bool bGeoreferenceSlippyTiles0, bool bDecodeTerrainRGB0, FString CRS0, ETerrainEncoding Encoding0 = ETerrainEncoding::Mapbox)
 	{
 		Name = Name0;
 		Layer = Layer0;
@@ -24,9 +26,11 @@ public:
 		bMaxY_IsNorth = bMaxY_IsNorth0;
 		bGeoreferenceSlippyTiles = bGeoreferenceSlippyTiles0;
 		CRS = CRS0;
-		bDecodeMapbox = bDecodeMapbox0;
+		bDecodeTerrainRGB = bDecodeTerrainRGB0;
+		Encoding = Encoding0;
 	};
 	void Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete) override;
+	bool GetFingerprint(FString& OutFingerprint) const override;
 
 private:
 	FString Name;
@@ -40,8 +44,14 @@ private:
 	int MaxY;
 	bool bMaxY_IsNorth;
 	bool bGeoreferenceSlippyTiles;
-	bool bDecodeMapbox;
+	bool bDecodeTerrainRGB;
+	ETerrainEncoding Encoding;
 	FString CRS;
+
+	static bool HasColorTable(FString File);
+
+	// Places the downloaded tiles at their EPSG:3857 extent in a single VRT, which becomes the only output file
+	bool CreateMosaic(TArray<FString> TileFiles, FString XYZFolder);
 };
 
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,26 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "ImageDownloader/HMFetcher.h"
+
+// Rewrites a chain of fetchers before it runs.
+class IMAGEDOWNLOADER_API FetcherOptimizer
+{
+public:
+	// Replaces consecutive warp phases of the AndThen chains by one HMFusedWarp phase, so that
+	// the pixels are read, resampled and written once. Takes ownership of `Fetcher` and returns the new chain.
+	static HMFetcher* FuseWarps(FString Name, HMFetcher* Fetcher);
+
+	// Wraps the phases that have a fingerprint in HMCachedFetcher, so that they are skipped when their inputs and parameters
+	// did not change since a previous run. Takes ownership of `Fetcher` and returns the new chain.
+	static HMFetcher* Memoize(HMFetcher* Fetcher);
+
+	// One line per phase, indented by nesting
+	static FString DumpPlan(HMFetcher* Fetcher);
+
+private:
+	static void Flatten(HMFetcher* Fetcher, TArray<HMFetcher*>& OutPhases);
+	static HMFetcher* FuseGroup(FString Name, TArray<HMFetcher*>& Group);
+	static void DumpPlan(HMFetcher* Fetcher, int32 Depth, TArray<FString>& OutLines);
+};
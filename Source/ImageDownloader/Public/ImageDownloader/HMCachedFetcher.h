@@ -0,0 +1,34 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ImageDownloader/HMFetcher.h"
+
+#define LOCTEXT_NAMESPACE "FImageDownloaderModule"
+
+// Skips a phase whose fingerprint, input CRS and input files (path, size, modification time and content) are the same
+// as in a previous run whose output files are unchanged, and reuses the outputs of that run instead.
+// Files are compared with the previous run on the task pool, and the phase is started from the game thread.
+class IMAGEDOWNLOADER_API HMCachedFetcher : public HMFetcher
+{
+public:
+	HMCachedFetcher(HMFetcher *Fetcher0) : Fetcher(Fetcher0) {};
+	virtual ~HMCachedFetcher() { delete Fetcher; };
+
+	HMFetcher *Fetcher;
+
+	void Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete) override;
+
+	void SetIntermediate(bool bIntermediate0) override { Fetcher->SetIntermediate(bIntermediate0); }
+
+	bool GetWarpOptions(FWarpOptions& OutOptions) const override { return Fetcher->GetWarpOptions(OutOptions); }
+	FString GetPlanName() const override { return "Cached"; }
+	TArray<HMFetcher**> GetInnerFetchers() override { return { &Fetcher }; }
+
+private:
+	// Returns false if the phase cannot be cached, or if an input file does not exist or is in memory
+	bool GetKey(const FString& InputCRS, const TArray<FString>& InputFiles, FString& OutKey) const;
+};
+
+#undef LOCTEXT_NAMESPACE
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "ImageDownloader/HMFetcher.h"
+#include "ImageDownloader/PipelineTelemetry.h"
 
 #define LOCTEXT_NAMESPACE "FImageDownloaderModule"
 
@@ -23,6 +24,22 @@ public:
 	bool bAllowEmpty;
 	
 	void Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete) override;
+
+	void SetIntermediate(bool bIntermediate0) override { if (Fetcher) Fetcher->SetIntermediate(bIntermediate0); }
+
+	void SetTelemetry(TSharedPtr<FPipelineTelemetry, ESPMode::ThreadSafe> Telemetry0) override
+	{
+		Telemetry = Telemetry0;
+		HMFetcher::SetTelemetry(Telemetry0);
+	}
+
+	bool GetWarpOptions(FWarpOptions& OutOptions) const override { return Fetcher && Fetcher->GetWarpOptions(OutOptions); }
+	FString GetPlanName() const override { return Name; }
+	TArray<HMFetcher**> GetInnerFetchers() override { return { &Fetcher }; }
+
+private:
+	TSharedPtr<FPipelineTelemetry, ESPMode::ThreadSafe> Telemetry;
+	FStageRecorder Recorder;
 };
 
 #undef LOCTEXT_NAMESPACE
@@ -3,9 +3,41 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "ImageDownloader/WarpOptions.h"
 
 #define LOCTEXT_NAMESPACE "FImageDownloaderModule"
 
+class FPipelineTelemetry;
+
+// Output files of a stage whose tasks run in parallel.
+// Each task only writes to its own slot, so no locking is required,
+// and the merged files are in the order of the tasks, not in their order of completion.
+struct IMAGEDOWNLOADER_API FParallelOutputs
+{
+public:
+	void Reset(int32 NumTasks)
+	{
+		Slots.Empty();
+		Slots.SetNum(NumTasks);
+	}
+
+	void Add(int32 Task, FString File) { Slots[Task].Add(File); }
+	void Append(int32 Task, const TArray<FString>& Files) { Slots[Task].Append(Files); }
+
+	TArray<FString> Merge() const
+	{
+		TArray<FString> Result;
+		for (auto& Slot : Slots)
+		{
+			Result.Append(Slot);
+		}
+		return Result;
+	}
+
+private:
+	TArray<TArray<FString>> Slots;
+};
+
 class IMAGEDOWNLOADER_API HMFetcher
 {
 public:
@@ -19,6 +51,42 @@ public:
 
 	HMFetcher* AndThen(HMFetcher* OtherFetcher);
 	HMFetcher* AndRun(TFunction<bool(HMFetcher*)> Lambda);
+
+	// Intermediate fetchers have their outputs read only by the next fetcher of the chain, so they can keep them in memory (see PipelineMemory)
+	virtual void SetIntermediate(bool bIntermediate0) { bIntermediate = bIntermediate0; }
+
+	// Introspection of the chain, used by FetcherOptimizer
+
+	// Returns true when this phase is a single gdalwarp call with the given options
+	virtual bool GetWarpOptions(FWarpOptions& OutOptions) const { return false; }
+	virtual FString GetPlanName() const { return "Fetcher"; }
+	virtual bool IsSequence() const { return false; }
+	virtual TArray<HMFetcher**> GetInnerFetchers() { return {}; }
+
+	// Returns true when the outputs of this phase only depend on its input files, its input CRS and `OutFingerprint`,
+	// so that they can be reused by HMCachedFetcher while none of these change
+	virtual bool GetFingerprint(FString& OutFingerprint) const { return false; }
+
+	// Where the phases of the chain (see HMDebugFetcher) record their telemetry, or nullptr
+	virtual void SetTelemetry(TSharedPtr<FPipelineTelemetry, ESPMode::ThreadSafe> Telemetry)
+	{
+		for (HMFetcher** Inner : GetInnerFetchers())
+		{
+			if (*Inner) (*Inner)->SetTelemetry(Telemetry);
+		}
+	}
+
+protected:
+	bool bIntermediate = false;
+
+	// To be used instead of `OutputFiles` from inside parallel tasks, and merged into `OutputFiles` once they are all finished
+	FParallelOutputs ParallelOutputs;
+
+	// Runs `Action(i)` for each input file on the task pool, with as many files at a time as ParallelMemoryBudgetMB allows,
+	// and blocks until they are all done, showing a cancellable progress dialog when called from the game thread.
+	// `Action` adds its outputs to ParallelOutputs, which are appended to OutputFiles in the order of the inputs.
+	// Must not be called from a task of the pool, as it waits for other tasks of the pool.
+	bool RunPerFile(const TArray<FString>& InputFiles, FText Message, TFunction<bool(int32 i)> Action);
 };
 
 class IMAGEDOWNLOADER_API HMAndThenFetcher : public HMFetcher
@@ -35,6 +103,16 @@ public:
 	HMFetcher* Fetcher2;
 	
 	void Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete) override;
+
+	void SetIntermediate(bool bIntermediate0) override
+	{
+		Fetcher1->SetIntermediate(true);
+		Fetcher2->SetIntermediate(bIntermediate0);
+	}
+
+	FString GetPlanName() const override { return "AndThen"; }
+	bool IsSequence() const override { return true; }
+	TArray<HMFetcher**> GetInnerFetchers() override { return { &Fetcher1, &Fetcher2 }; }
 };
 
 class IMAGEDOWNLOADER_API HMAndRunFetcher : public HMFetcher
@@ -51,6 +129,11 @@ public:
 	TFunction<bool(HMFetcher*)> Lambda;
 	
 	void Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete) override;
+
+	void SetIntermediate(bool bIntermediate0) override { Fetcher->SetIntermediate(bIntermediate0); }
+
+	FString GetPlanName() const override { return "AndRun"; }
+	TArray<HMFetcher**> GetInnerFetchers() override { return { &Fetcher }; }
 };
 
 #undef LOCTEXT_NAMESPACE
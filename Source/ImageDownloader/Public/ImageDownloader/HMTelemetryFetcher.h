@@ -0,0 +1,28 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ImageDownloader/HMFetcher.h"
+
+#define LOCTEXT_NAMESPACE "FImageDownloaderModule"
+
+// Collects the telemetry of the phases of `Fetcher` during each run, and reports it when the run ends (see FPipelineTelemetry)
+class IMAGEDOWNLOADER_API HMTelemetryFetcher : public HMFetcher
+{
+public:
+	HMTelemetryFetcher(FString Name0, HMFetcher *Fetcher0) : Name(Name0), Fetcher(Fetcher0) {};
+	virtual ~HMTelemetryFetcher() { delete Fetcher; };
+
+	FString Name;
+	HMFetcher *Fetcher;
+
+	void Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete) override;
+
+	void SetIntermediate(bool bIntermediate0) override { Fetcher->SetIntermediate(bIntermediate0); }
+
+	FString GetPlanName() const override { return "Telemetry"; }
+	TArray<HMFetcher**> GetInnerFetchers() override { return { &Fetcher }; }
+};
+
+#undef LOCTEXT_NAMESPACE
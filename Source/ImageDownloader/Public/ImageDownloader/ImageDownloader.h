@@ -58,6 +58,25 @@ enum class EParametersSelection: uint8
 	FromBoundingActor,
 };
 
+UENUM(BlueprintType)
+enum class EOverviewResampling : uint8
+{
+	Nearest,
+	Bilinear,
+	Cubic,
+	Average,
+	Mode
+};
+
+UENUM(BlueprintType)
+enum class ECOGPredictor : uint8
+{
+	None,
+	Automatic,
+	Horizontal,
+	FloatingPoint
+};
+
 UCLASS()
 class IMAGEDOWNLOADER_API UImageDownloader : public UActorComponent
 {
@@ -224,6 +243,13 @@ public:
 	/* The coordinate system used by the downloaded files. */
 	FString XYZ_CRS = "";
 
+	UPROPERTY(
+		EditAnywhere, BlueprintReadWrite, Category = "ImageDownloader|Source",
+		meta = (EditCondition = "IsXYZ() && !IsMapbox()", EditConditionHides, DisplayPriority = "23")
+	)
+	/* Decode the tiles into heightmaps using the Terrarium encoding: (R * 256 + G + B / 256) - 32768, as used by AWS Terrain Tiles. */
+	bool bXYZ_DecodeTerrarium = false;
+
 
 
 
@@ -725,6 +751,41 @@ public:
 	int PrecisionPercent = 100;
 
 
+	/***************************
+	 * Cloud-Optimized GeoTIFF *
+	 ***************************/
+
+	UPROPERTY(
+		EditAnywhere, BlueprintReadWrite, Category = "ImageDownloader|COG",
+		meta = (DisplayPriority = "30")
+	)
+	/* Check this to write the final images as tiled, compressed Cloud-Optimized GeoTIFFs with internal overviews,
+	   so that later crops and previews can read only the parts and the resolution they need.
+	   This is ignored when the images are converted to PNG. */
+	bool bOutputCOG = false;
+
+	UPROPERTY(
+		EditAnywhere, BlueprintReadWrite, Category = "ImageDownloader|COG",
+		meta = (EditCondition = "bOutputCOG", EditConditionHides, DisplayPriority = "31")
+	)
+	/* Resampling method used to compute the overviews. */
+	EOverviewResampling COG_OverviewResampling = EOverviewResampling::Average;
+
+	UPROPERTY(
+		EditAnywhere, BlueprintReadWrite, Category = "ImageDownloader|COG",
+		meta = (EditCondition = "bOutputCOG", EditConditionHides, ClampMin = "16", DisplayPriority = "32")
+	)
+	/* Width and height of the tiles, rounded down to a multiple of 16. */
+	int COG_BlockSize = 512;
+
+	UPROPERTY(
+		EditAnywhere, BlueprintReadWrite, Category = "ImageDownloader|COG",
+		meta = (EditCondition = "bOutputCOG", EditConditionHides, DisplayPriority = "33")
+	)
+	/* Predictor applied before compression. Automatic picks the floating point predictor for floating point heightmaps. */
+	ECOGPredictor COG_Predictor = ECOGPredictor::Automatic;
+
+
 	/**********************
 	 * Adapt to Landscape *
 	 **********************/
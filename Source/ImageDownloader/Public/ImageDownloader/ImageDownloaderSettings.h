@@ -18,4 +18,38 @@ public:
 
 	UPROPERTY(Config, EditAnywhere)
 	FString Mapbox_Token;
+
+	/* Keep the intermediate images of the processing phases in memory instead of writing them to disk. */
+	UPROPERTY(Config, EditAnywhere, Category = "Performance")
+	bool bInMemoryPipeline = false;
+
+	/* Above this amount of memory, intermediate images are written to disk again. */
+	UPROPERTY(Config, EditAnywhere, Category = "Performance", meta = (EditCondition = "bInMemoryPipeline", ClampMin = "0"))
+	int32 InMemoryPipelineBudgetMB = 2048;
+
+	/* Size of the GDAL block cache, shared by all the files that are processed in parallel. */
+	UPROPERTY(Config, EditAnywhere, Category = "Performance", meta = (ClampMin = "16"))
+	int32 GDALCacheMaxMB = 512;
+
+	/* Files are processed in parallel only as long as their uncompressed size fits in this budget. */
+	UPROPERTY(Config, EditAnywhere, Category = "Performance", meta = (ClampMin = "0"))
+	int32 ParallelMemoryBudgetMB = 4096;
+
+	/* Run consecutive reprojection and cropping phases as a single warp, so that images are resampled only once. */
+	UPROPERTY(Config, EditAnywhere, Category = "Performance")
+	bool bFuseWarpPhases = true;
+
+	/* Skip the phases whose parameters and input files did not change since a previous run, and reuse their output files.
+	 * Phases whose outputs were kept in memory (see In Memory Pipeline) always run again. */
+	UPROPERTY(Config, EditAnywhere, Category = "Performance")
+	bool bReuseStageOutputs = true;
+
+	/* Record the time, CPU usage, file sizes, downloads and memory of each phase. A summary table is logged at the end of each
+	 * run, and written as JSON and CSV files to Saved/ImageDownloaderTelemetry. Phases are also traced to Unreal Insights. */
+	UPROPERTY(Config, EditAnywhere, Category = "Performance")
+	bool bRecordTelemetry = false;
+
+	/* Log the phases that will run, after fusion, each time images are fetched. */
+	UPROPERTY(Config, EditAnywhere, Category = "Performance")
+	bool bLogFetcherPlan = false;
 };
@@ -0,0 +1,31 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Keeps the intermediate outputs of fetcher chains in GDAL's /vsimem/ file system instead of writing them to disk.
+// This is enabled in the project settings, and stages write to disk again once the memory budget is exhausted.
+// Only GDAL can read in-memory files, so final outputs are always written to disk.
+class IMAGEDOWNLOADER_API PipelineMemory
+{
+public:
+	// Clears and returns the folder where a stage writes its outputs: a /vsimem/ folder if `bIntermediate` is true,
+	// the in-memory pipeline is enabled and the outputs (estimated from `InputFiles`) fit in the budget, a folder
+	// of ImageDownloaderDir otherwise. Returns an empty string on error.
+	static FString InitializeStageDir(FString FolderName, bool bIntermediate, const TArray<FString>& InputFiles);
+
+	// Copies the in-memory files of `Files` to `Folder` on disk and replaces them in `Files`,
+	// for consumers that cannot read /vsimem/ (e.g. external tools)
+	static bool Materialize(TArray<FString>& Files, FString Folder);
+
+	// Frees the in-memory files of `Consumed` that are not in `Kept`
+	static void Release(const TArray<FString>& Consumed, const TArray<FString>& Kept);
+
+	static bool IsInMemory(const FString& File);
+	static int64 GetUsedBytes();
+	static void Clear();
+
+	// Size of the uncompressed rasters, which is what the stages write
+	static int64 EstimateBytes(const TArray<FString>& Files);
+};
@@ -0,0 +1,86 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct IMAGEDOWNLOADER_API FStageTelemetry
+{
+	FString Name;
+	bool bSuccess = false;
+
+	double WallSeconds = 0;
+
+	// CPU time of the whole process while the phase ran, including the threads of GDAL and of the task pool
+	double CPUSeconds = 0;
+
+	int32 InputFiles = 0;
+	int64 InputBytes = 0;
+	int32 OutputFiles = 0;
+	int64 OutputBytes = 0;
+
+	int64 DownloadedBytes = 0;
+
+	// Datasets and metadata served from DatasetPool, and files that had to be opened
+	int64 PoolHits = 0;
+	int64 PoolMisses = 0;
+
+	// Process memory when the phase ended, and highest process memory so far
+	int64 UsedMemoryBytes = 0;
+	int64 PeakMemoryBytes = 0;
+	int64 InMemoryPipelineBytes = 0;
+	int64 GDALCacheBytes = 0;
+
+	// Average number of busy cores divided by the number of cores, between 0 and 1
+	double GetThreadUtilization() const;
+	double GetDownloadBytesPerSecond() const;
+};
+
+// Telemetry of one phase, from Begin to End
+class IMAGEDOWNLOADER_API FStageRecorder
+{
+public:
+	void Begin(FString Name, const TArray<FString>& InputFiles);
+	FStageTelemetry End(bool bSuccess, const TArray<FString>& OutputFiles);
+
+private:
+	FStageTelemetry Stage;
+	double StartSeconds = 0;
+	double StartCPUSeconds = 0;
+	int64 StartDownloadedBytes = 0;
+	int64 StartPoolHits = 0;
+	int64 StartPoolMisses = 0;
+};
+
+// Collects the telemetry of the phases of one run of a fetcher chain (see HMTelemetryFetcher), from any thread.
+// Phases are also traced to Unreal Insights, as bookmarks and counters, when the trace is enabled.
+class IMAGEDOWNLOADER_API FPipelineTelemetry
+{
+public:
+	FPipelineTelemetry(FString RunName0);
+
+	void Add(const FStageTelemetry& Stage);
+
+	// Logs the summary table, and writes it as JSON and CSV files in OutputDir
+	void Finish(bool bSuccess);
+
+	FString ToTable() const;
+	FString ToJSON() const;
+	FString ToCSV() const;
+
+	static FString OutputDir();
+	static double GetProcessCPUSeconds();
+
+	// Sizes of the files on disk and in memory
+	static int64 GetFilesBytes(const TArray<FString>& Files);
+
+private:
+	FString RunName;
+	FDateTime StartTime;
+	double StartSeconds = 0;
+	double TotalSeconds = 0;
+	bool bRunSuccess = false;
+
+	mutable FCriticalSection Lock;
+	TArray<FStageTelemetry> Stages;
+};
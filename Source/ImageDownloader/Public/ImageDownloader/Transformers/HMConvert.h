@@ -12,6 +12,7 @@ public:
 	HMConvert(FString Name0, FString NewExtension0) :
 		Name(Name0), NewExtension(NewExtension0) {};
 	void Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete) override;
+	bool GetFingerprint(FString& OutFingerprint) const override;
 
 private:
 	FString Name;
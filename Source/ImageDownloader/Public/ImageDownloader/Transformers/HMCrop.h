@@ -15,6 +15,10 @@ public:
 		Pixels(Pixels0)
 	{};
 	void Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete) override;
+	bool GetFingerprint(FString& OutFingerprint) const override;
+
+	bool GetWarpOptions(FWarpOptions& OutOptions) const override;
+	FString GetPlanName() const override { return "HMCrop"; }
 
 private:
 	FString Name;
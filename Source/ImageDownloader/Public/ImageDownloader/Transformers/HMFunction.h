@@ -6,15 +6,23 @@
 
 #define LOCTEXT_NAMESPACE "FImageDownloaderModule"
 
+// Applies a function to the pixels of the first band of copies of the input files.
+// Inputs kept in memory (see PipelineMemory) are edited in place, as they are only read by this phase and never reused by StageCache.
+// Functions given as an expression (see FPixelExpression) are compiled, and much faster than arbitrary lambdas.
 class HMFunction : public HMFetcher
 {
 public:
-	HMFunction(TFunction<float(float)> Function0) :
-		Function(Function0) {};
+	HMFunction(FString Name0, FString Expression0) :
+		Name(Name0), Expression(Expression0) {};
+
+	HMFunction(FString Name0, TFunction<float(float)> Function0) :
+		Name(Name0), Function(Function0) {};
 
 	void Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete) override;
 
 private:
+	FString Name;
+	FString Expression;
 	TFunction<float(float)> Function;
 };
 
@@ -0,0 +1,30 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "ImageDownloader/HMFetcher.h"
+
+#define LOCTEXT_NAMESPACE "FImageDownloaderModule"
+
+// Consecutive warp phases (see FWarpOptions) replaced by FetcherOptimizer with a single gdalwarp call
+class IMAGEDOWNLOADER_API HMFusedWarp : public HMFetcher
+{
+public:
+	HMFusedWarp(FString Name0, TArray<FString> StepNames0, TArray<FWarpOptions> Steps0) :
+		Name(Name0),
+		StepNames(StepNames0),
+		Steps(Steps0)
+	{};
+	void Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete) override;
+	bool GetFingerprint(FString& OutFingerprint) const override;
+
+	bool GetWarpOptions(FWarpOptions& OutOptions) const override;
+	FString GetPlanName() const override;
+
+private:
+	FString Name;
+	TArray<FString> StepNames;
+	TArray<FWarpOptions> Steps;
+};
+
+#undef LOCTEXT_NAMESPACE
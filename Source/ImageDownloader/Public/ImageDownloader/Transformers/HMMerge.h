@@ -11,6 +11,7 @@ class HMMerge : public HMFetcher
 public:
 	HMMerge(FString Name0) : Name(Name0) {}
 	void Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete) override;
+	bool GetFingerprint(FString& OutFingerprint) const override;
 
 private:
 	FString Name;
@@ -14,6 +14,10 @@ public:
 		OutputCRS = CRSReprojection;
 	};
 	void Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete) override;
+	bool GetFingerprint(FString& OutFingerprint) const override;
+
+	bool GetWarpOptions(FWarpOptions& OutOptions) const override;
+	FString GetPlanName() const override { return "HMReproject"; }
 
 private:
 	FString Name;
@@ -0,0 +1,27 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "ImageDownloader/HMFetcher.h"
+
+#define LOCTEXT_NAMESPACE "FImageDownloaderModule"
+
+// Rewrites the images as tiled, compressed Cloud-Optimized GeoTIFFs with internal overviews,
+// so that later reads of a part of the image or at a lower resolution do not read the whole image.
+class HMToCOG : public HMFetcher
+{
+public:
+	// `Resampling` is used for the overviews, and `Predictor` is a value of the PREDICTOR creation option of the COG driver
+	HMToCOG(FString Name0, FString Resampling0, int BlockSize0, FString Predictor0) :
+		Name(Name0), Resampling(Resampling0), BlockSize(BlockSize0), Predictor(Predictor0) {};
+	void Fetch(FString InputCRS, TArray<FString> InputFiles, TFunction<void(bool)> OnComplete) override;
+	bool GetFingerprint(FString& OutFingerprint) const override;
+
+private:
+	FString Name;
+	FString Resampling;
+	int BlockSize;
+	FString Predictor;
+};
+
+#undef LOCTEXT_NAMESPACE
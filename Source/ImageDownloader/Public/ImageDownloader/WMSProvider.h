@@ -11,7 +11,7 @@
 #define LOCTEXT_NAMESPACE "FImageDownloaderModule"
 
 USTRUCT()
-struct FWMSProvider
+struct IMAGEDOWNLOADER_API FWMSProvider
 {
 	GENERATED_BODY()
 
@@ -0,0 +1,31 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Options of a phase that amounts to a single gdalwarp call on its inputs.
+// Options of consecutive phases can be merged with `Then`, so that the pixels are read and resampled only once.
+// An empty TargetCRS means that the phase keeps the CRS of its input.
+struct IMAGEDOWNLOADER_API FWarpOptions
+{
+	FString SourceCRS;
+	FString TargetCRS;
+	FString Resampling;
+	TOptional<double> DstNoData;
+
+	// West, East, South, North in TargetCRS, zero when unset (same convention as HMCrop)
+	FVector4d Extent = FVector4d::Zero();
+	FIntPoint Size = FIntPoint::ZeroValue;
+
+	// Whether this leaves images in SourceCRS unchanged
+	bool IsIdentity() const;
+
+	// Whether `Next` can be merged into this; a reprojection after a crop or a resize cannot
+	bool CanBeFollowedBy(const FWarpOptions& Next) const;
+
+	// Returns the options of applying this and then `Next`
+	FWarpOptions Then(const FWarpOptions& Next) const;
+
+	TArray<FString> ToArgs() const;
+};
@@ -38,14 +38,20 @@ public class LandscapeCombinator : ModuleRules
 				"Landscape",
 				"LandscapeEditor",
 				"PropertyEditor",
+				"Json",
+				"GeometryCore",
+				"GeometryFramework",
 
 				// Other dependencies
                 "Coordinates",
 				"ConsoleHelpers",
+				"ConcurrencyHelpers",
+				"FileDownloader",
                 "GDALInterface",
                 "LandscapeUtils",
                 "HeightmapModifier",
 				"ImageDownloader",
+				"MapboxHelpers",
 
 				"SplineImporter", // artificial dependency
 				"BuildingFromSpline" // artificial dependency
@@ -0,0 +1,605 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "LandscapeCombinator/LandscapeCombinatorBenchmarkCommandlet.h"
+#include "LandscapeCombinator/LogLandscapeCombinator.h"
+
+#include "BuildingFromSpline/Building.h"
+#include "Coordinates/GlobalCoordinates.h"
+#include "GDALInterface/GDALInterface.h"
+#include "GDALInterface/PixelExpression.h"
+#include "GDALInterface/RasterBlocks.h"
+#include "MapboxHelpers/MapboxHelpers.h"
+
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UDynamicMesh.h"
+
+#include "gdal_priv.h"
+
+#define LOCTEXT_NAMESPACE "FLandscapeCombinatorModule"
+
+ULandscapeCombinatorBenchmarkCommandlet::ULandscapeCombinatorBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 ULandscapeCombinatorBenchmarkCommandlet::Main(const FString& Params)
+{
+	// message dialogs are logged instead of waiting for a user
+	GIsRunningUnattendedScript = true;
+
+	int32 Size = 2048;
+	int32 NumPoints = 10000;
+	int32 NumWays = 2000;
+	int32 NumBuildings = 50;
+	FString ReportFile;
+
+	FParse::Value(*Params, TEXT("Filter="), Filter);
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+	FParse::Value(*Params, TEXT("Size="), Size);
+	FParse::Value(*Params, TEXT("Points="), NumPoints);
+	FParse::Value(*Params, TEXT("Ways="), NumWays);
+	FParse::Value(*Params, TEXT("Buildings="), NumBuildings);
+	FParse::Value(*Params, TEXT("Report="), ReportFile);
+	Iterations = FMath::Max(1, Iterations);
+
+	FixturesDir = FPaths::Combine(FPaths::ProjectSavedDir(), "LandscapeCombinatorBenchmark");
+	IPlatformFile::GetPlatformPhysical().DeleteDirectoryRecursively(*FixturesDir);
+	if (!IPlatformFile::GetPlatformPhysical().CreateDirectoryTree(*FixturesDir))
+	{
+		UE_LOG(LogLandscapeCombinator, Error, TEXT("Could not create the fixtures directory %s"), *FixturesDir);
+		return 1;
+	}
+
+	BenchmarkTerrainRGBDecode(Size);
+	BenchmarkWarp(Size);
+	BenchmarkPixelExpression(Size);
+	BenchmarkCoordinateTransform(NumPoints);
+	BenchmarkOGRPointLists(NumWays);
+	BenchmarkBuildingMesh(NumBuildings);
+
+	IPlatformFile::GetPlatformPhysical().DeleteDirectoryRecursively(*FixturesDir);
+
+	UE_LOG(LogLandscapeCombinator, Display, TEXT("Benchmarks (%d iterations):\n%s"), Iterations, *ToTable());
+
+	if (!ReportFile.IsEmpty() && !FFileHelper::SaveStringToFile(ToJSON(), *ReportFile))
+	{
+		UE_LOG(LogLandscapeCombinator, Error, TEXT("Could not write the report %s"), *ReportFile);
+	}
+
+	for (const FBenchmarkResult& Result : Results)
+	{
+		if (!Result.bSuccess) return 1;
+	}
+	return 0;
+}
+
+void ULandscapeCombinatorBenchmarkCommandlet::Measure(FString Name, double Items, FString Unit, TFunction<bool()> Body)
+{
+	FBenchmarkResult Result;
+	Result.Name = Name;
+	Result.Items = Items;
+	Result.Unit = Unit;
+	Result.bSuccess = true;
+
+	TArray<double> Times;
+	for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+	{
+		double Start = FPlatformTime::Seconds();
+		if (!Body())
+		{
+			UE_LOG(LogLandscapeCombinator, Error, TEXT("Benchmark %s failed at iteration %d"), *Name, Iteration);
+			Result.bSuccess = false;
+			break;
+		}
+		Times.Add(FPlatformTime::Seconds() - Start);
+	}
+
+	if (!Times.IsEmpty())
+	{
+		Times.Sort();
+		Result.Iterations = Times.Num();
+		Result.MedianSeconds = Times[Times.Num() / 2];
+		Result.MinSeconds = Times[0];
+	}
+
+	Results.Add(Result);
+}
+
+void ULandscapeCombinatorBenchmarkCommandlet::BenchmarkTerrainRGBDecode(int32 Size)
+{
+	FString Name = "TerrainRGBDecode";
+	FString LegacyName = "TerrainRGBDecodeLegacy";
+	if (!IsSelected(Name) && !IsSelected(LegacyName)) return;
+
+	FString InputFile = FPaths::Combine(FixturesDir, "TerrainRGB.png");
+	FString OutputFile = FPaths::Combine(FixturesDir, "TerrainRGB-decoded.tif");
+	if (!WriteSyntheticTerrainRGB(InputFile, Size))
+	{
+		Results.Add({ Name });
+		return;
+	}
+
+	if (IsSelected(Name))
+	{
+		Measure(Name, (double) Size * Size / 1e6, "Mpixels", [InputFile, OutputFile]()
+		{
+			bool bShowedDialog = false;
+			return MapboxHelpers::DecodeTerrainRGB(InputFile, OutputFile, ETerrainEncoding::Mapbox, &bShowedDialog);
+		});
+
+		// the decoding loops alone, without reading and writing files
+		MapboxHelpers::Benchmark(Size, Iterations);
+	}
+
+	if (IsSelected(LegacyName))
+	{
+		FString LegacyOutputFile = FPaths::Combine(FixturesDir, "TerrainRGB-decoded-legacy.tif");
+		Measure(LegacyName, (double) Size * Size / 1e6, "Mpixels", [InputFile, LegacyOutputFile]()
+		{
+			return DecodeTerrainRGBLegacy(InputFile, LegacyOutputFile);
+		});
+	}
+}
+
+bool ULandscapeCombinatorBenchmarkCommandlet::DecodeTerrainRGBLegacy(const FString& InputFile, const FString& OutputFile)
+{
+	FGDALDatasetHandle Dataset = FGDALDatasetHandle::Open(InputFile);
+	if (!Dataset || Dataset->GetRasterCount() < 3) return false;
+
+	const int SizeX = Dataset->GetRasterXSize();
+	const int SizeY = Dataset->GetRasterYSize();
+
+	TArray<uint8> Red, Green, Blue;
+	Red.SetNumUninitialized(SizeX * SizeY);
+	Green.SetNumUninitialized(SizeX * SizeY);
+	Blue.SetNumUninitialized(SizeX * SizeY);
+	if (
+		Dataset->GetRasterBand(1)->RasterIO(GF_Read, 0, 0, SizeX, SizeY, Red.GetData(), SizeX, SizeY, GDT_Byte, 0, 0) != CE_None ||
+		Dataset->GetRasterBand(2)->RasterIO(GF_Read, 0, 0, SizeX, SizeY, Green.GetData(), SizeX, SizeY, GDT_Byte, 0, 0) != CE_None ||
+		Dataset->GetRasterBand(3)->RasterIO(GF_Read, 0, 0, SizeX, SizeY, Blue.GetData(), SizeX, SizeY, GDT_Byte, 0, 0) != CE_None
+	)
+	{
+		return false;
+	}
+
+	TArray<float> HeightmapData;
+	HeightmapData.SetNumUninitialized(SizeX * SizeY);
+	for (int X = 0; X < SizeX; X++)
+	{
+		for (int Y = 0; Y < SizeY; Y++)
+		{
+			int i = X + Y * SizeX;
+			float R = Red[i];
+			float G = Green[i];
+			float B = Blue[i];
+			HeightmapData[i] = -10000 + ((R * 256 * 256 + G * 256 + B) * 0.1);
+		}
+	}
+
+	GDALDriver *MEMDriver = GetGDALDriverManager()->GetDriverByName("MEM");
+	GDALDriver *TIFDriver = GetGDALDriverManager()->GetDriverByName("GTiff");
+	if (!MEMDriver || !TIFDriver) return false;
+
+	FGDALDatasetHandle MEMDataset(MEMDriver->Create("", SizeX, SizeY, 1, GDT_Float32, nullptr));
+	if (!MEMDataset || MEMDataset->GetRasterBand(1)->RasterIO(GF_Write, 0, 0, SizeX, SizeY, HeightmapData.GetData(), SizeX, SizeY, GDT_Float32, 0, 0) != CE_None)
+	{
+		return false;
+	}
+
+	FGDALDatasetHandle TIFDataset(TIFDriver->CreateCopy(TCHAR_TO_UTF8(*OutputFile), MEMDataset.Get(), 1, nullptr, nullptr, nullptr));
+	return (bool) TIFDataset;
+}
+
+void ULandscapeCombinatorBenchmarkCommandlet::BenchmarkWarp(int32 Size)
+{
+	FString Name = "Warp";
+	if (!IsSelected(Name)) return;
+
+	FString InputFile = FPaths::Combine(FixturesDir, "DEM.tif");
+	FString OutputFile = FPaths::Combine(FixturesDir, "DEM-3857.tif");
+	if (!WriteSyntheticDEM(InputFile, Size))
+	{
+		Results.Add({ Name });
+		return;
+	}
+
+	Measure(Name, (double) Size * Size / 1e6, "Mpixels", [InputFile, OutputFile]()
+	{
+		return GDALInterface::Warp(InputFile, OutputFile, "EPSG:4326", "EPSG:3857", 0);
+	});
+}
+
+void ULandscapeCombinatorBenchmarkCommandlet::BenchmarkPixelExpression(int32 Size)
+{
+	if (!IsSelected("PixelExpression") && !IsSelected("PixelLambda")) return;
+
+	// a tenth of the values are nodata
+	const int64 NumValues = (int64) Size * Size;
+	TArray<float> Values;
+	Values.SetNumUninitialized(NumValues);
+	FRandomStream Random(0);
+	for (int64 i = 0; i < NumValues; i++)
+	{
+		Values[i] = Random.FRand() < 0.1 ? -99999 : Random.FRandRange(0, 2000);
+	}
+
+	// both functions are applied to their own output, which is stable after the first iteration
+	if (IsSelected("PixelExpression"))
+	{
+		TArray<float> Data = Values;
+		FPixelExpression Expression;
+		FString Error;
+		if (!FPixelExpression::Compile("x == -99999 ? -10 : x", Expression, Error))
+		{
+			UE_LOG(LogLandscapeCombinator, Error, TEXT("%s"), *Error);
+			Results.Add({ "PixelExpression" });
+		}
+		else
+		{
+			Measure("PixelExpression", NumValues / 1e6, "Mpixels", [&Expression, &Data]()
+			{
+				Expression.Evaluate(Data.GetData(), Data.Num());
+				return true;
+			});
+		}
+	}
+
+	if (IsSelected("PixelLambda"))
+	{
+		TArray<float> Data = Values;
+		float OriginalValue = -99999;
+		float TransformedValue = -10;
+		TFunction<float(float)> Function = [OriginalValue, TransformedValue](float x) { return x == OriginalValue ? TransformedValue : x; };
+		Measure("PixelLambda", NumValues / 1e6, "Mpixels", [&Function, &Data]()
+		{
+			for (float& Value : Data)
+			{
+				Value = Function(Value);
+			}
+			return true;
+		});
+	}
+}
+
+void ULandscapeCombinatorBenchmarkCommandlet::BenchmarkCoordinateTransform(int32 NumPoints)
+{
+	FString Name = "CoordinateTransform";
+	FString BatchName = "CoordinateTransformBatch";
+	if (!IsSelected(Name) && !IsSelected(BatchName)) return;
+
+	UGlobalCoordinates* GlobalCoordinates = NewObject<UGlobalCoordinates>(GetTransientPackage());
+	GlobalCoordinates->CRS = "EPSG:2154";
+	GlobalCoordinates->CmPerLongUnit = 100;
+	GlobalCoordinates->CmPerLatUnit = -100;
+	GlobalCoordinates->WorldOriginLong = 650000;
+	GlobalCoordinates->WorldOriginLat = 6860000;
+	GlobalCoordinates->AddToRoot();
+
+	FRandomStream Random(0);
+	TArray<FVector2D> Points;
+	for (int32 i = 0; i < NumPoints; i++)
+	{
+		Points.Add(FVector2D(Random.FRandRange(-1, 7), Random.FRandRange(43, 50)));
+	}
+
+	if (IsSelected(Name))
+	{
+		Measure(Name, NumPoints / 1e3, "kpoints", [GlobalCoordinates, &Points]()
+		{
+			for (const FVector2D& Point : Points)
+			{
+				FVector2D XY;
+				if (!GlobalCoordinates->GetUnrealCoordinatesFromCRS(Point.X, Point.Y, "EPSG:4326", XY)) return false;
+			}
+			return true;
+		});
+	}
+
+	if (IsSelected(BatchName))
+	{
+		// the batch version must give exactly the results of the single-point version
+		TArray<FVector2D> BatchResults = Points;
+		bool bSameResults = GlobalCoordinates->GetUnrealCoordinatesFromCRS(BatchResults, "EPSG:4326");
+		for (int32 i = 0; bSameResults && i < NumPoints; i++)
+		{
+			FVector2D Expected;
+			bSameResults = GlobalCoordinates->GetUnrealCoordinatesFromCRS(Points[i].X, Points[i].Y, "EPSG:4326", Expected) && BatchResults[i] == Expected;
+			if (!bSameResults)
+			{
+				UE_LOG(LogLandscapeCombinator, Error, TEXT("%s: point %d converted to %s instead of %s"),
+					*BatchName, i, *BatchResults[i].ToString(), *Expected.ToString()
+				);
+			}
+		}
+
+		if (!bSameResults)
+		{
+			Results.Add({ BatchName });
+		}
+		else
+		{
+			Measure(BatchName, NumPoints / 1e3, "kpoints", [GlobalCoordinates, &Points]()
+			{
+				TArray<FVector2D> Converted = Points;
+				return GlobalCoordinates->GetUnrealCoordinatesFromCRS(Converted, "EPSG:4326");
+			});
+		}
+	}
+
+	GlobalCoordinates->RemoveFromRoot();
+}
+
+void ULandscapeCombinatorBenchmarkCommandlet::BenchmarkOGRPointLists(int32 NumWays)
+{
+	FString Name = "OGRPointLists";
+	if (!IsSelected(Name)) return;
+
+	const int32 NodesPerWay = 16;
+	FString OSMFile = FPaths::Combine(FixturesDir, "Ways.osm");
+	if (!WriteSyntheticOSM(OSMFile, NumWays, NodesPerWay))
+	{
+		Results.Add({ Name });
+		return;
+	}
+
+	// like ASplineImporter, the file is opened for each run; the spline components are not created
+	Measure(Name, (double) NumWays * NodesPerWay / 1e3, "kpoints", [OSMFile, NumWays]()
+	{
+		GDALDataset* Dataset = (GDALDataset*) GDALOpenEx(TCHAR_TO_UTF8(*OSMFile), GDAL_OF_VECTOR, nullptr, nullptr, nullptr);
+		if (!Dataset) return false;
+
+		TArray<FPointList> PointLists = GDALInterface::GetPointLists(Dataset);
+		GDALClose(Dataset);
+		return PointLists.Num() >= NumWays;
+	});
+}
+
+void ULandscapeCombinatorBenchmarkCommandlet::BenchmarkBuildingMesh(int32 NumBuildings)
+{
+	FString Name = "BuildingMesh";
+	if (!IsSelected(Name)) return;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Editor, false, "LandscapeCombinatorBenchmark");
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Editor);
+	WorldContext.SetCurrentWorld(World);
+
+	FRandomStream Random(0);
+	TArray<ABuilding*> Buildings;
+	for (int32 i = 0; i < NumBuildings; i++)
+	{
+		ABuilding* Building = World->SpawnActor<ABuilding>();
+		if (!Building) continue;
+
+		Building->BuildingConfiguration->bConvertToStaticMesh = false;
+		Building->BuildingConfiguration->bConvertToVolume = false;
+
+		FVector Center(5000 * (i % 10), 5000 * (i / 10), 0);
+		TArray<FVector> Polygon = RandomPolygon(Random, Center, Random.RandRange(4, 12), Random.FRandRange(800, 2000));
+
+		USplineComponent* Spline = Building->SplineComponent;
+		Spline->ClearSplinePoints();
+		for (int32 j = 0; j < Polygon.Num(); j++)
+		{
+			Spline->AddSplinePoint(Polygon[j], ESplineCoordinateSpace::World, false);
+			Spline->SetSplinePointType(j, ESplinePointType::Linear, false);
+		}
+		Spline->UpdateSpline();
+
+		Buildings.Add(Building);
+	}
+
+	if (Buildings.Num() == NumBuildings)
+	{
+		Measure(Name, NumBuildings, "buildings", [&Buildings]()
+		{
+			for (ABuilding* Building : Buildings)
+			{
+				Building->GenerateBuilding();
+				if (Building->DynamicMeshComponent->GetDynamicMesh()->GetTriangleCount() == 0) return false;
+			}
+			return true;
+		});
+	}
+	else
+	{
+		UE_LOG(LogLandscapeCombinator, Error, TEXT("Could only spawn %d buildings out of %d"), Buildings.Num(), NumBuildings);
+		Results.Add({ Name });
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+}
+
+float ULandscapeCombinatorBenchmarkCommandlet::SyntheticElevation(int32 X, int32 Y, int32 Size)
+{
+	double U = (double) X / Size * 2 * PI;
+	double V = (double) Y / Size * 2 * PI;
+	return 1000 + 500 * FMath::Sin(3 * U) * FMath::Cos(2 * V) + 300 * FMath::Sin(11 * U + 7 * V) + 200 * FMath::Cos(29 * V);
+}
+
+bool ULandscapeCombinatorBenchmarkCommandlet::WriteSyntheticDEM(const FString& File, int32 Size)
+{
+	GDALDriver* Driver = GetGDALDriverManager()->GetDriverByName("GTiff");
+	if (!Driver) return false;
+
+	GDALDataset* Dataset = Driver->Create(TCHAR_TO_UTF8(*File), Size, Size, 1, GDT_Float32, nullptr);
+	if (!Dataset) return false;
+
+	// one degree around (5, 45)
+	double GeoTransform[6] = { 5, 1.0 / Size, 0, 46, 0, -1.0 / Size };
+	OGRSpatialReference SRS;
+	char* WKT = nullptr;
+	SRS.importFromEPSG(4326);
+	SRS.exportToWkt(&WKT);
+	Dataset->SetGeoTransform(GeoTransform);
+	Dataset->SetProjection(WKT);
+	CPLFree(WKT);
+
+	TArray<float> Row;
+	Row.SetNumUninitialized(Size);
+	bool bSuccess = true;
+	for (int32 Y = 0; Y < Size && bSuccess; Y++)
+	{
+		for (int32 X = 0; X < Size; X++)
+		{
+			Row[X] = SyntheticElevation(X, Y, Size);
+		}
+		bSuccess = Dataset->GetRasterBand(1)->RasterIO(GF_Write, 0, Y, Size, 1, Row.GetData(), Size, 1, GDT_Float32, 0, 0) == CE_None;
+	}
+
+	GDALClose(Dataset);
+	return bSuccess;
+}
+
+bool ULandscapeCombinatorBenchmarkCommandlet::WriteSyntheticTerrainRGB(const FString& File, int32 Size)
+{
+	GDALDriver* MemDriver = GetGDALDriverManager()->GetDriverByName("MEM");
+	GDALDriver* PNGDriver = GetGDALDriverManager()->GetDriverByName("PNG");
+	if (!MemDriver || !PNGDriver) return false;
+
+	GDALDataset* Dataset = MemDriver->Create("", Size, Size, 3, GDT_Byte, nullptr);
+	if (!Dataset) return false;
+
+	TArray<uint8> Red, Green, Blue;
+	Red.SetNumUninitialized(Size);
+	Green.SetNumUninitialized(Size);
+	Blue.SetNumUninitialized(Size);
+
+	bool bSuccess = true;
+	for (int32 Y = 0; Y < Size && bSuccess; Y++)
+	{
+		for (int32 X = 0; X < Size; X++)
+		{
+			// inverse of the Mapbox encoding, see ETerrainEncoding
+			uint32 Value = FMath::RoundToInt((SyntheticElevation(X, Y, Size) + 10000) * 10);
+			Red[X] = (Value >> 16) & 255;
+			Green[X] = (Value >> 8) & 255;
+			Blue[X] = Value & 255;
+		}
+		bSuccess =
+			Dataset->GetRasterBand(1)->RasterIO(GF_Write, 0, Y, Size, 1, Red.GetData(), Size, 1, GDT_Byte, 0, 0) == CE_None &&
+			Dataset->GetRasterBand(2)->RasterIO(GF_Write, 0, Y, Size, 1, Green.GetData(), Size, 1, GDT_Byte, 0, 0) == CE_None &&
+			Dataset->GetRasterBand(3)->RasterIO(GF_Write, 0, Y, Size, 1, Blue.GetData(), Size, 1, GDT_Byte, 0, 0) == CE_None;
+	}
+
+	GDALDataset* PNG = bSuccess ? PNGDriver->CreateCopy(TCHAR_TO_UTF8(*File), Dataset, false, nullptr, nullptr, nullptr) : nullptr;
+	GDALClose(Dataset);
+	if (!PNG) return false;
+
+	GDALClose(PNG);
+	return true;
+}
+
+bool ULandscapeCombinatorBenchmarkCommandlet::WriteSyntheticOSM(const FString& File, int32 NumWays, int32 NodesPerWay)
+{
+	FRandomStream Random(0);
+	TArray<FString> Lines;
+	Lines.Add("<?xml version=\"1.0\" encoding=\"UTF-8\"?>");
+	Lines.Add("<osm version=\"0.6\" generator=\"LandscapeCombinatorBenchmark\">");
+
+	int64 NodeId = 1;
+	TArray<FString> WayLines;
+	for (int32 Way = 0; Way < NumWays; Way++)
+	{
+		// ways on a grid of about 100m around (2.35, 48.85)
+		FVector Center(2.35 + 0.001 * (Way % 100), 48.85 + 0.001 * (Way / 100), 0);
+		TArray<FVector> Polygon = RandomPolygon(Random, Center, NodesPerWay - 1, 0.0004);
+
+		WayLines.Add(FString::Printf(TEXT("  <way id=\"%d\">"), Way + 1));
+		int64 FirstNodeId = NodeId;
+		for (const FVector& Point : Polygon)
+		{
+			Lines.Add(FString::Printf(TEXT("  <node id=\"%lld\" lat=\"%.7f\" lon=\"%.7f\"/>"), NodeId, Point.Y, Point.X));
+			WayLines.Add(FString::Printf(TEXT("    <nd ref=\"%lld\"/>"), NodeId));
+			NodeId++;
+		}
+
+		// closed way
+		WayLines.Add(FString::Printf(TEXT("    <nd ref=\"%lld\"/>"), FirstNodeId));
+		WayLines.Add("    <tag k=\"building\" v=\"yes\"/>");
+		WayLines.Add(FString::Printf(TEXT("    <tag k=\"building:levels\" v=\"%d\"/>"), Random.RandRange(1, 8)));
+		WayLines.Add("  </way>");
+	}
+
+	Lines.Append(WayLines);
+	Lines.Add("</osm>");
+
+	return FFileHelper::SaveStringArrayToFile(Lines, *File);
+}
+
+TArray<FVector> ULandscapeCombinatorBenchmarkCommandlet::RandomPolygon(FRandomStream& Random, FVector Center, int32 NumVertices, double Radius)
+{
+	TArray<double> Angles;
+	for (int32 i = 0; i < NumVertices; i++)
+	{
+		Angles.Add(Random.FRandRange(0, 2 * PI));
+	}
+	Angles.Sort();
+
+	TArray<FVector> Polygon;
+	for (double Angle : Angles)
+	{
+		double VertexRadius = Radius * Random.FRandRange(0.5, 1);
+		Polygon.Add(Center + FVector(VertexRadius * FMath::Cos(Angle), VertexRadius * FMath::Sin(Angle), 0));
+	}
+	return Polygon;
+}
+
+FString ULandscapeCombinatorBenchmarkCommandlet::ToTable() const
+{
+	TArray<FString> Lines;
+	Lines.Add(FString::Printf(TEXT("%-24s %12s %12s %16s"), TEXT("Benchmark"), TEXT("Median (ms)"), TEXT("Min (ms)"), TEXT("Throughput")));
+	for (const FBenchmarkResult& Result : Results)
+	{
+		if (!Result.bSuccess)
+		{
+			Lines.Add(FString::Printf(TEXT("%-24s FAILED"), *Result.Name));
+			continue;
+		}
+
+		double Throughput = Result.MedianSeconds > 0 ? Result.Items / Result.MedianSeconds : 0;
+		Lines.Add(FString::Printf(TEXT("%-24s %12.2f %12.2f %10.2f %s/s"),
+			*Result.Name, Result.MedianSeconds * 1000, Result.MinSeconds * 1000, Throughput, *Result.Unit
+		));
+	}
+	return FString::Join(Lines, TEXT("\n"));
+}
+
+FString ULandscapeCombinatorBenchmarkCommandlet::ToJSON() const
+{
+	TArray<TSharedPtr<FJsonValue>> Values;
+	for (const FBenchmarkResult& Result : Results)
+	{
+		TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+		Object->SetStringField(TEXT("Name"), Result.Name);
+		Object->SetBoolField(TEXT("Success"), Result.bSuccess);
+		Object->SetNumberField(TEXT("Iterations"), Result.Iterations);
+		Object->SetNumberField(TEXT("MedianSeconds"), Result.MedianSeconds);
+		Object->SetNumberField(TEXT("MinSeconds"), Result.MinSeconds);
+		Object->SetNumberField(TEXT("Items"), Result.Items);
+		Object->SetStringField(TEXT("Unit"), Result.Unit);
+		Object->SetNumberField(TEXT("Throughput"), Result.MedianSeconds > 0 ? Result.Items / Result.MedianSeconds : 0);
+		Values.Add(MakeShared<FJsonValueObject>(Object));
+	}
+
+	TSharedPtr<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetStringField(TEXT("Platform"), FPlatformProperties::IniPlatformName());
+	Report->SetStringField(TEXT("CPU"), FPlatformMisc::GetCPUBrand().TrimStartAndEnd());
+	Report->SetNumberField(TEXT("Cores"), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+	Report->SetArrayField(TEXT("Benchmarks"), Values);
+
+	FString Result;
+	FJsonSerializer::Serialize(Report.ToSharedRef(), TJsonWriterFactory<>::Create(&Result));
+	return Result;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,359 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "LandscapeCombinator/LandscapeCombinatorCommandlet.h"
+#include "LandscapeCombinator/LogLandscapeCombinator.h"
+
+#include "ConcurrencyHelpers/TaskPool.h"
+#include "FileDownloader/Download.h"
+#include "FileDownloader/DownloadProgress.h"
+
+#include "Containers/Ticker.h"
+#include "Dom/JsonObject.h"
+#include "EngineUtils.h"
+#include "FileHelpers.h"
+#include "Misc/FileHelper.h"
+#include "Misc/OutputDeviceRedirector.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+#define LOCTEXT_NAMESPACE "FLandscapeCombinatorModule"
+
+namespace
+{
+	// Records the errors and the message dialogs logged while a job runs, from any thread
+	class FJobLogCapture : public FOutputDevice
+	{
+	public:
+		TArray<FString> Errors;
+		TArray<FString> Dialogs;
+
+		void Serialize(const TCHAR* Message, ELogVerbosity::Type Verbosity, const FName& Category) override
+		{
+			// FMessageDialog logs the messages under LogDialogs, at Log verbosity, instead of opening them in unattended mode
+			static const FName LogDialogs("LogDialogs");
+
+			bool bDialog = Category == LogDialogs;
+			bool bError = (Verbosity & ELogVerbosity::VerbosityMask) <= ELogVerbosity::Error;
+			if (!bDialog && !bError) return;
+
+			FScopeLock ScopeLock(&Lock);
+			(bDialog ? Dialogs : Errors).Add(FString::Printf(TEXT("%s: %s"), *Category.ToString(), Message));
+		}
+
+		bool CanBeUsedOnAnyThread() const override { return true; }
+		bool CanBeUsedOnMultipleThreads() const override { return true; }
+
+		void Get(TArray<FString>& OutErrors, TArray<FString>& OutDialogs)
+		{
+			FScopeLock ScopeLock(&Lock);
+			OutErrors = Errors;
+			OutDialogs = Dialogs;
+		}
+
+	private:
+		FCriticalSection Lock;
+	};
+
+	TArray<TSharedPtr<FJsonValue>> ToJsonArray(const TArray<FString>& Strings)
+	{
+		TArray<TSharedPtr<FJsonValue>> Values;
+		for (const FString& String : Strings)
+		{
+			Values.Add(MakeShared<FJsonValueString>(String));
+		}
+		return Values;
+	}
+}
+
+ULandscapeCombinatorCommandlet::ULandscapeCombinatorCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 ULandscapeCombinatorCommandlet::Main(const FString& Params)
+{
+	// message dialogs are logged instead of waiting for a user
+	GIsRunningUnattendedScript = true;
+
+	FString JobsFile;
+	if (!FParse::Value(*Params, TEXT("Jobs="), JobsFile))
+	{
+		UE_LOG(LogLandscapeCombinator, Error, TEXT("Usage: -run=LandscapeCombinator -Jobs=<path to the jobs JSON file>"));
+		return 2;
+	}
+
+	FString JobsString;
+	TSharedPtr<FJsonObject> Spec;
+	if (!FFileHelper::LoadFileToString(JobsString, *JobsFile) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(JobsString), Spec) || !Spec.IsValid())
+	{
+		UE_LOG(LogLandscapeCombinator, Error, TEXT("Could not read the jobs file %s"), *JobsFile);
+		return 2;
+	}
+
+	const TArray<TSharedPtr<FJsonValue>>* Jobs;
+	if (!Spec->TryGetArrayField(TEXT("Jobs"), Jobs))
+	{
+		UE_LOG(LogLandscapeCombinator, Error, TEXT("The jobs file %s has no Jobs array"), *JobsFile);
+		return 2;
+	}
+
+	FString MapName;
+	bool bSaveMap = false;
+	FString ReportFile;
+	double TimeoutSeconds = 0;
+	double IdleSeconds = 2;
+	Spec->TryGetStringField(TEXT("Map"), MapName);
+	Spec->TryGetBoolField(TEXT("SaveMap"), bSaveMap);
+	Spec->TryGetStringField(TEXT("Report"), ReportFile);
+	Spec->TryGetNumberField(TEXT("StepTimeoutSeconds"), TimeoutSeconds);
+	Spec->TryGetNumberField(TEXT("IdleSeconds"), IdleSeconds);
+
+	UWorld* World = nullptr;
+	if (!MapName.IsEmpty())
+	{
+		World = UEditorLoadingAndSavingUtils::LoadMap(MapName);
+	}
+	if (!World)
+	{
+		UE_LOG(LogLandscapeCombinator, Error, TEXT("Could not load the map '%s'"), *MapName);
+		return 2;
+	}
+
+	double Start = FPlatformTime::Seconds();
+	int32 NumFailed = 0;
+	TArray<TSharedPtr<FJsonValue>> JobReports;
+
+	for (const TSharedPtr<FJsonValue>& JobValue : *Jobs)
+	{
+		TSharedPtr<FJsonObject> JobReport = MakeShared<FJsonObject>();
+		const TSharedPtr<FJsonObject>* Job;
+		bool bSuccess = JobValue->TryGetObject(Job) && RunJob(World, *Job, TimeoutSeconds, IdleSeconds, JobReport);
+		if (!bSuccess) NumFailed++;
+		JobReport->SetBoolField(TEXT("Success"), bSuccess);
+		JobReports.Add(MakeShared<FJsonValueObject>(JobReport));
+	}
+
+	if (bSaveMap && !UEditorLoadingAndSavingUtils::SaveDirtyPackages(true, true))
+	{
+		UE_LOG(LogLandscapeCombinator, Error, TEXT("Could not save the map '%s'"), *MapName);
+		NumFailed++;
+	}
+
+	double TotalSeconds = FPlatformTime::Seconds() - Start;
+	UE_LOG(LogLandscapeCombinator, Display, TEXT("Ran %d jobs in %.1f seconds, %d failed"), Jobs->Num(), TotalSeconds, NumFailed);
+
+	if (!ReportFile.IsEmpty())
+	{
+		TSharedPtr<FJsonObject> Report = MakeShared<FJsonObject>();
+		Report->SetStringField(TEXT("Map"), MapName);
+		Report->SetNumberField(TEXT("Seconds"), TotalSeconds);
+		Report->SetNumberField(TEXT("Failed"), NumFailed);
+		Report->SetArrayField(TEXT("Jobs"), JobReports);
+
+		FString ReportString;
+		if (!FJsonSerializer::Serialize(Report.ToSharedRef(), TJsonWriterFactory<>::Create(&ReportString)) || !FFileHelper::SaveStringToFile(ReportString, *ReportFile))
+		{
+			UE_LOG(LogLandscapeCombinator, Error, TEXT("Could not write the report %s"), *ReportFile);
+		}
+	}
+
+	return NumFailed == 0 ? 0 : 1;
+}
+
+bool ULandscapeCombinatorCommandlet::RunJob(UWorld* World, const TSharedPtr<FJsonObject>& Job, double TimeoutSeconds, double IdleSeconds, TSharedPtr<FJsonObject> OutReport)
+{
+	// only the actor is required, a job without an action only sets properties
+	FString Name, ActorLabel, Action;
+	Job->TryGetStringField(TEXT("Name"), Name);
+	Job->TryGetStringField(TEXT("Actor"), ActorLabel);
+	Job->TryGetStringField(TEXT("Action"), Action);
+
+	OutReport->SetStringField(TEXT("Name"), Name);
+	OutReport->SetStringField(TEXT("Actor"), ActorLabel);
+	OutReport->SetStringField(TEXT("Action"), Action);
+
+	UE_LOG(LogLandscapeCombinator, Display, TEXT("Running job '%s': %s on %s"), *Name, *Action, *ActorLabel);
+
+	FJobLogCapture Capture;
+	GLog->AddOutputDevice(&Capture);
+
+	double Start = FPlatformTime::Seconds();
+	bool bSuccess = true;
+	FString Error;
+
+	AActor* Actor = nullptr;
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		if (It->GetActorLabel() == ActorLabel)
+		{
+			Actor = *It;
+			break;
+		}
+	}
+
+	if (!Actor)
+	{
+		Error = FString::Printf(TEXT("Could not find an actor with label '%s'"), *ActorLabel);
+		bSuccess = false;
+	}
+
+	const TSharedPtr<FJsonObject>* Properties;
+	if (bSuccess && Job->TryGetObjectField(TEXT("Properties"), Properties))
+	{
+		Actor->Modify();
+		for (auto& [Path, Value] : (*Properties)->Values)
+		{
+			if (!SetProperty(Actor, Path, Value->AsString(), Error))
+			{
+				bSuccess = false;
+				break;
+			}
+		}
+	}
+
+	if (bSuccess && !Action.IsEmpty())
+	{
+		bSuccess = CallFunction(Actor, Action, Error);
+	}
+
+	if (bSuccess && !WaitUntilIdle(TimeoutSeconds, IdleSeconds))
+	{
+		Error = FString::Printf(TEXT("Timed out after %.0f seconds"), TimeoutSeconds);
+		bSuccess = false;
+		DownloadProgress::CancelAll();
+	}
+
+	double Seconds = FPlatformTime::Seconds() - Start;
+
+	GLog->Flush();
+	GLog->RemoveOutputDevice(&Capture);
+
+	TArray<FString> Errors, Dialogs;
+	Capture.Get(Errors, Dialogs);
+	if (!Error.IsEmpty())
+	{
+		UE_LOG(LogLandscapeCombinator, Error, TEXT("Job '%s': %s"), *Name, *Error);
+		Errors.Add(Error);
+	}
+
+	// the actors report failures through dialogs and logs only
+	bSuccess = bSuccess && Errors.IsEmpty() && Dialogs.IsEmpty();
+
+	OutReport->SetNumberField(TEXT("Seconds"), Seconds);
+	OutReport->SetArrayField(TEXT("Errors"), ToJsonArray(Errors));
+	OutReport->SetArrayField(TEXT("Dialogs"), ToJsonArray(Dialogs));
+
+	UE_LOG(LogLandscapeCombinator, Display, TEXT("Job '%s' %s in %.1f seconds"), *Name, bSuccess ? TEXT("succeeded") : TEXT("failed"), Seconds);
+	return bSuccess;
+}
+
+UObject* ULandscapeCombinatorCommandlet::ResolvePath(UObject* Root, FString& Path, FString& OutError)
+{
+	UObject* Object = Root;
+	FString Left, Right;
+	while (Path.Split(TEXT("."), &Left, &Right))
+	{
+		FObjectPropertyBase* Property = FindFProperty<FObjectPropertyBase>(Object->GetClass(), *Left);
+		UObject* Inner = Property ? Property->GetObjectPropertyValue_InContainer(Object) : nullptr;
+		if (!Inner)
+		{
+			OutError = FString::Printf(TEXT("%s has no object property named '%s'"), *Object->GetName(), *Left);
+			return nullptr;
+		}
+
+		Object = Inner;
+		Path = Right;
+	}
+	return Object;
+}
+
+bool ULandscapeCombinatorCommandlet::SetProperty(UObject* Root, FString Path, const FString& Value, FString& OutError)
+{
+	UObject* Object = ResolvePath(Root, Path, OutError);
+	if (!Object) return false;
+
+	FProperty* Property = FindFProperty<FProperty>(Object->GetClass(), *Path);
+	if (!Property)
+	{
+		OutError = FString::Printf(TEXT("%s has no property named '%s'"), *Object->GetName(), *Path);
+		return false;
+	}
+
+	Object->PreEditChange(Property);
+	bool bImported = Property->ImportText_InContainer(*Value, Object, Object, PPF_None) != nullptr;
+	FPropertyChangedEvent ChangedEvent(Property, EPropertyChangeType::ValueSet);
+	Object->PostEditChangeProperty(ChangedEvent);
+
+	if (!bImported)
+	{
+		OutError = FString::Printf(TEXT("Could not set %s.%s to '%s'"), *Object->GetName(), *Path, *Value);
+		return false;
+	}
+
+	UE_LOG(LogLandscapeCombinator, Log, TEXT("Set %s.%s to '%s'"), *Object->GetName(), *Path, *Value);
+	return true;
+}
+
+bool ULandscapeCombinatorCommandlet::CallFunction(UObject* Root, FString Path, FString& OutError)
+{
+	UObject* Object = ResolvePath(Root, Path, OutError);
+	if (!Object) return false;
+
+	UFunction* Function = Object->FindFunction(FName(*Path));
+	if (!Function || Function->NumParms != 0)
+	{
+		OutError = FString::Printf(TEXT("%s has no function named '%s' without parameters"), *Object->GetName(), *Path);
+		return false;
+	}
+
+	Object->ProcessEvent(Function, nullptr);
+	return true;
+}
+
+bool ULandscapeCombinatorCommandlet::WaitUntilIdle(double TimeoutSeconds, double IdleSeconds)
+{
+	double Start = FPlatformTime::Seconds();
+	double LastTick = Start;
+	double IdleSince = -1;
+
+	while (true)
+	{
+		// game thread tasks and tickers drive the completion callbacks and the HTTP requests
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		double Now = FPlatformTime::Seconds();
+		FTSTicker::GetCoreTicker().Tick(Now - LastTick);
+		LastTick = Now;
+
+		// downloads waiting for a HEAD request or for HostLimiter are not in DownloadProgress yet
+		bool bBusy =
+			Download::NumInFlight() > 0 ||
+			DownloadProgress::GetSnapshot().FilesActive() > 0 ||
+			FTaskPool::Get().NumPendingTasks() > 0 ||
+			FTaskBatch::NumRunning() > 0;
+
+		if (bBusy)
+		{
+			IdleSince = -1;
+		}
+		else if (IdleSince < 0)
+		{
+			IdleSince = Now;
+		}
+		else if (Now - IdleSince >= IdleSeconds)
+		{
+			return true;
+		}
+
+		if (TimeoutSeconds > 0 && Now - Start > TimeoutSeconds) return false;
+
+		FPlatformProcess::Sleep(0.01);
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -74,7 +74,7 @@ void ALandscapeSpawner::SpawnLandscape()
 		return;
 	}
 
-	if (ALevelCoordinates::GetGlobalCoordinates(this->GetWorld(), false))
+	if (ALevelCoordinates::GetGlobalCoordinates(this->GetWorld(), false) && !IsRunningCommandlet())
 	{
 		EAppReturnType::Type UserResponse = FMessageDialog::Open(EAppMsgType::OkCancel,
 			LOCTEXT(
@@ -0,0 +1,84 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "LandscapeCombinatorBenchmarkCommandlet.generated.h"
+
+/*
+ * Measures the throughput of the plugin's hot paths on synthetic data, for instance:
+ *
+ *     UnrealEditor-Cmd MyProject.uproject -run=LandscapeCombinatorBenchmark -nullrhi -Report=C:/Path/To/Benchmark.json
+ *
+ * Benchmarks:
+ *  - TerrainRGBDecode: MapboxHelpers::DecodeTerrainRGB on a generated Size x Size terrain RGB PNG,
+ *    followed by MapboxHelpers::Benchmark, which logs the time of the decoding loops alone
+ *  - TerrainRGBDecodeLegacy: the former MapboxHelpers::DecodeMapboxThreeBands on the same PNG, which decoded the whole tile
+ *    with a scalar, column-major loop into a MEM dataset copied to a GeoTIFF
+ *  - Warp: GDALInterface::Warp of a generated Size x Size DEM from EPSG:4326 to EPSG:3857
+ *  - PixelExpression, PixelLambda: a nodata replacement on Size x Size values, compiled with FPixelExpression or as a TFunction
+ *  - CoordinateTransform: UGlobalCoordinates::GetUnrealCoordinatesFromCRS on `Points` random points
+ *  - CoordinateTransformBatch: the batch version on the same points, checked against the single-point version
+ *  - OGRPointLists: GDALInterface::GetPointLists, which reads the points of the splines of ASplineImporter,
+ *    on a generated OSM XML file with `Ways` closed ways
+ *  - BuildingMesh: ABuilding::GenerateBuilding on `Buildings` random polygons in a transient world
+ *
+ * Options: -Filter=<substring of benchmark names>, -Iterations=5, -Size=2048, -Points=10000, -Ways=2000, -Buildings=50.
+ * Each benchmark reports the median and minimum time of its iterations, and the throughput for the median.
+ * The exit code is 1 if a benchmark fails.
+ */
+UCLASS()
+class LANDSCAPECOMBINATOR_API ULandscapeCombinatorBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	ULandscapeCombinatorBenchmarkCommandlet();
+
+	int32 Main(const FString& Params) override;
+
+private:
+	struct FBenchmarkResult
+	{
+		FString Name;
+		bool bSuccess = false;
+		int32 Iterations = 0;
+		double MedianSeconds = 0;
+		double MinSeconds = 0;
+		double Items = 0;
+		FString Unit;
+	};
+
+	TArray<FBenchmarkResult> Results;
+	FString Filter;
+	int32 Iterations = 5;
+	FString FixturesDir;
+
+	// Runs `Body` `Iterations` times unless the benchmark is filtered out; `Body` processes `Items` units of work
+	void Measure(FString Name, double Items, FString Unit, TFunction<bool()> Body);
+	bool IsSelected(const FString& Name) const { return Filter.IsEmpty() || Name.Contains(Filter); }
+
+	void BenchmarkTerrainRGBDecode(int32 Size);
+	void BenchmarkWarp(int32 Size);
+	void BenchmarkPixelExpression(int32 Size);
+	void BenchmarkCoordinateTransform(int32 NumPoints);
+	void BenchmarkOGRPointLists(int32 NumWays);
+	void BenchmarkBuildingMesh(int32 NumBuildings);
+
+	// Synthetic fixtures, with elevations made of a few sine waves over [0, 2000] meters
+	static float SyntheticElevation(int32 X, int32 Y, int32 Size);
+	static bool WriteSyntheticDEM(const FString& File, int32 Size);
+	static bool WriteSyntheticTerrainRGB(const FString& File, int32 Size);
+	static bool WriteSyntheticOSM(const FString& File, int32 NumWays, int32 NodesPerWay);
+
+	// The former Mapbox decoder, kept as a baseline for TerrainRGBDecode
+	static bool DecodeTerrainRGBLegacy(const FString& InputFile, const FString& OutputFile);
+
+	// A random star-shaped, hence simple, polygon around `Center`
+	static TArray<FVector> RandomPolygon(FRandomStream& Random, FVector Center, int32 NumVertices, double Radius);
+
+	FString ToTable() const;
+	FString ToJSON() const;
+};
@@ -0,0 +1,67 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "LandscapeCombinatorCommandlet.generated.h"
+
+class FJsonObject;
+
+/*
+ * Runs the actions of the plugin's actors (landscape spawners, image downloaders, spline importers, buildings)
+ * without the editor UI, for instance:
+ *
+ *     UnrealEditor-Cmd MyProject.uproject -run=LandscapeCombinator -Jobs=C:/Path/To/Jobs.json
+ *
+ * The jobs file looks like:
+ *
+ *     {
+ *       "Map": "/Game/Maps/Terrain",
+ *       "SaveMap": true,
+ *       "Report": "C:/Path/To/Report.json",
+ *       "StepTimeoutSeconds": 3600,
+ *       "Jobs": [
+ *         {
+ *           "Name": "Heightmap",
+ *           "Actor": "LandscapeSpawner1",
+ *           "Properties": { "HeightmapDownloader.XYZ_Zoom": "12" },
+ *           "Action": "SpawnLandscape"
+ *         },
+ *         { "Name": "Roads", "Actor": "SplineImporter1", "Action": "GenerateSplines" },
+ *         { "Name": "Buildings", "Actor": "BuildingsFromSplines1", "Action": "GenerateBuildings" }
+ *       ]
+ *     }
+ *
+ * `Actor` is the label of an actor in the map. `Properties` are set before calling `Action`, with the same
+ * text syntax as copy-pasting values in the details panel. Both accept paths through object properties,
+ * such as `HeightmapDownloader.XYZ_Zoom` or `HeightmapDownloader.DeleteAllProcessedImages`.
+ *
+ * Jobs run in order. A job is complete once no download, task, or task batch has been running for
+ * `IdleSeconds` (2 by default), and fails if it logs an error or a message dialog, or if it exceeds
+ * `StepTimeoutSeconds` (0 for no timeout). The exit code is 0 when all jobs succeed, 1 when a job
+ * fails, and 2 when the jobs file or the map cannot be loaded.
+ */
+UCLASS()
+class LANDSCAPECOMBINATOR_API ULandscapeCombinatorCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	ULandscapeCombinatorCommandlet();
+
+	int32 Main(const FString& Params) override;
+
+private:
+	bool RunJob(UWorld* World, const TSharedPtr<FJsonObject>& Job, double TimeoutSeconds, double IdleSeconds, TSharedPtr<FJsonObject> OutReport);
+
+	// Resolves `Path` (for instance `HeightmapDownloader.XYZ_Zoom`) to the object that owns the last segment,
+	// and removes the object segments from `Path`
+	static UObject* ResolvePath(UObject* Root, FString& Path, FString& OutError);
+	static bool SetProperty(UObject* Root, FString Path, const FString& Value, FString& OutError);
+	static bool CallFunction(UObject* Root, FString Path, FString& OutError);
+
+	// Processes game thread tasks and tickers until no asynchronous work has been running for `IdleSeconds`
+	static bool WaitUntilIdle(double TimeoutSeconds, double IdleSeconds);
+};
@@ -0,0 +1,45 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class LandscapeCombinatorTests : ModuleRules
+{
+	public LandscapeCombinatorTests(ReadOnlyTargetRules Target) : base(Target)
+	{
+		CppStandard = CppStandardVersion.Cpp20;
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+        IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_2;
+
+        // Unreal Dependencies
+        PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+			}
+		);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				// Unreal Engine Dependencies
+				"CoreUObject",
+				"Engine",
+				"HTTP",
+				"Landscape",
+				"Networking",
+				"Projects",
+				"Sockets",
+				"UMG",
+
+				// Landscape Combinator Dependencies
+				"ConcurrencyHelpers",
+				"ConsoleHelpers",
+				"Coordinates",
+				"FileDownloader",
+				"GDALInterface",
+				"ImageDownloader",
+				"MapboxHelpers"
+			}
+		);
+	}
+}
@@ -0,0 +1,137 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "Coordinates/GlobalCoordinates.h"
+#include "GDALInterface/GDALInterface.h"
+#include "GDALInterface/TransformRegistry.h"
+
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Random points in EPSG:4326 over France, where EPSG:2154 is defined
+static TArray<FVector2D> RandomPoints(int32 Num)
+{
+	FRandomStream Random(2154);
+	TArray<FVector2D> Points;
+	for (int32 i = 0; i < Num; i++)
+	{
+		Points.Add(FVector2D(Random.FRandRange(-4, 8), Random.FRandRange(43, 50)));
+	}
+	return Points;
+}
+
+static UGlobalCoordinates* MakeGlobalCoordinates()
+{
+	UGlobalCoordinates* GlobalCoordinates = NewObject<UGlobalCoordinates>();
+	GlobalCoordinates->CRS = "EPSG:2154";
+	GlobalCoordinates->CmPerLongUnit = 100;
+	GlobalCoordinates->CmPerLatUnit = -100;
+	GlobalCoordinates->WorldOriginLong = 700000;
+	GlobalCoordinates->WorldOriginLat = 6600000;
+	return GlobalCoordinates;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCoordinatesBatchTest, "LandscapeCombinator.Coordinates.BatchMatchesSinglePoint",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FCoordinatesBatchTest::RunTest(const FString& Parameters)
+{
+	// small chunks, so that the batch is transformed by several threads
+	TGuardValue<int32> BatchSize(TransformRegistry::ParallelBatchSize, 256);
+
+	const TArray<FVector2D> Points = RandomPoints(2000);
+
+	TArray<FVector2D> Batch = Points;
+	if (!TestTrue("Batch conversion", TransformRegistry::Transform("EPSG:4326", "EPSG:2154", Batch))) return false;
+
+	for (int32 i = 0; i < Points.Num(); i++)
+	{
+		FVector4d Original(Points[i].X, Points[i].X, Points[i].Y, Points[i].Y);
+		FVector4d Converted;
+		if (!TestTrue("Single point conversion", GDALInterface::ConvertCoordinates(Original, Converted, "EPSG:4326", "EPSG:2154"))) return false;
+
+		// batches promise exactly the same results as single points
+		if (!TestTrue(FString::Printf(TEXT("Easting of point %d"), i), Batch[i].X == Converted[0])) break;
+		if (!TestTrue(FString::Printf(TEXT("Northing of point %d"), i), Batch[i].Y == Converted[2])) break;
+	}
+
+	// and back
+	if (!TestTrue("Inverse batch conversion", TransformRegistry::Transform("EPSG:2154", "EPSG:4326", Batch))) return false;
+	for (int32 i = 0; i < Points.Num(); i++)
+	{
+		if (!TestTrue(FString::Printf(TEXT("Round trip of point %d"), i), Batch[i].Equals(Points[i], 1e-9))) break;
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGlobalCoordinatesBatchTest, "LandscapeCombinator.Coordinates.GlobalCoordinatesBatchMatchesSinglePoint",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGlobalCoordinatesBatchTest::RunTest(const FString& Parameters)
+{
+	TGuardValue<int32> BatchSize(TransformRegistry::ParallelBatchSize, 256);
+
+	UGlobalCoordinates* GlobalCoordinates = MakeGlobalCoordinates();
+	const TArray<FVector2D> Points = RandomPoints(1000);
+
+	TArray<FVector2D> Locations = Points;
+	if (!TestTrue("Batch conversion", GlobalCoordinates->GetUnrealCoordinatesFromCRS(Locations, "EPSG:4326"))) return false;
+
+	TArray<FVector2D> SnapshotLocations = Points;
+	TestTrue("Snapshot batch conversion", GlobalCoordinates->GetSnapshot().GetUnrealCoordinatesFromCRS(SnapshotLocations, "EPSG:4326"));
+	TestTrue("Snapshot gives the same locations", SnapshotLocations == Locations);
+
+	for (int32 i = 0; i < Points.Num(); i++)
+	{
+		FVector2D XY;
+		if (!TestTrue("Single point conversion", GlobalCoordinates->GetUnrealCoordinatesFromCRS(Points[i].X, Points[i].Y, "EPSG:4326", XY))) return false;
+
+		if (!TestTrue(FString::Printf(TEXT("Location of point %d"), i), Locations[i] == XY)) break;
+	}
+
+	TArray<FVector2D> Coordinates = Locations;
+	if (!TestTrue("Inverse batch conversion", GlobalCoordinates->GetCRSCoordinatesFromUnrealLocations(Coordinates, "EPSG:4326"))) return false;
+	for (int32 i = 0; i < Points.Num(); i++)
+	{
+		FVector2D Single;
+		if (!TestTrue("Inverse single point conversion", GlobalCoordinates->GetCRSCoordinatesFromUnrealLocation(Locations[i], "EPSG:4326", Single))) return false;
+		if (!TestTrue(FString::Printf(TEXT("Coordinates of point %d"), i), Coordinates[i] == Single)) break;
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCoordinatesInvalidCRSTest, "LandscapeCombinator.Coordinates.InvalidCRSFails",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FCoordinatesInvalidCRSTest::RunTest(const FString& Parameters)
+{
+	// the error dialogs are logged instead of waiting for a user
+	TGuardValue<bool> Unattended(GIsRunningUnattendedScript, true);
+
+	const FString InvalidCRS = "EPSG:0";
+	const TArray<FVector2D> Points = RandomPoints(10);
+
+	FVector4d Original(2, 3, 45, 46);
+	FVector4d Converted;
+	TestFalse("Single point conversion from an invalid CRS", GDALInterface::ConvertCoordinates(Original, Converted, InvalidCRS, "EPSG:2154"));
+	TestFalse("Single point conversion to an invalid CRS", GDALInterface::ConvertCoordinates(Original, Converted, "EPSG:4326", InvalidCRS));
+
+	TArray<FVector2D> Batch = Points;
+	TestFalse("Batch conversion from an invalid CRS", TransformRegistry::Transform(InvalidCRS, "EPSG:2154", Batch));
+	TestTrue("Points are left untouched", Batch == Points);
+	TestFalse("Batch conversion to an invalid CRS", TransformRegistry::Transform("EPSG:4326", InvalidCRS, Batch));
+
+	UGlobalCoordinates* GlobalCoordinates = MakeGlobalCoordinates();
+	TArray<FVector2D> Locations = Points;
+	TestFalse("GlobalCoordinates batch conversion from an invalid CRS", GlobalCoordinates->GetUnrealCoordinatesFromCRS(Locations, InvalidCRS));
+
+	GlobalCoordinates->CRS = InvalidCRS;
+	TestFalse("Snapshot batch conversion with an invalid level CRS", GlobalCoordinates->GetSnapshot().GetUnrealCoordinatesFromCRS(Locations, "EPSG:4326"));
+
+	return true;
+}
+
+#endif
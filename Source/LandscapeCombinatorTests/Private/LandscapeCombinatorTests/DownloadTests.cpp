@@ -0,0 +1,262 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "LandscapeCombinatorTests/TestFixtures.h"
+
+#include "FileDownloader/Download.h"
+#include "FileDownloader/DownloadCache.h"
+#include "FileDownloader/StreamingSHA256.h"
+
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static TArray<uint8> MakeBody(int32 Size, uint8 Seed)
+{
+	TArray<uint8> Body;
+	Body.SetNumUninitialized(Size);
+	for (int32 i = 0; i < Size; i++) Body[i] = (uint8) (i * 31 + Seed);
+	return Body;
+}
+
+static bool FileEquals(const FString& File, const TArray<uint8>& Expected)
+{
+	TArray<uint8> Content;
+	return FFileHelper::LoadFileToArray(Content, *File, FILEREAD_Silent) && Content == Expected;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDownloadRedirectTest, "LandscapeCombinator.Download.Redirect",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FDownloadRedirectTest::RunTest(const FString& Parameters)
+{
+	FLoopbackScope Scope;
+	if (!TestTrue("Loopback server started", Scope.IsValid())) return false;
+
+	TArray<uint8> Body = MakeBody(300000, 1);
+	FLoopbackResource Resource;
+	Resource.Body = Body;
+	Scope.Server.Serve("/data/file.bin", Resource);
+
+	FString URL = Scope.URL("/data/file.bin");
+	FString File = Scope.TempFile("file.bin");
+	TestTrue("Download succeeded", Download::SynchronousFromURL(URL, File));
+	TestTrue("Downloaded file has the served content", FileEquals(File, Body));
+	TestEqual("GET requests", Scope.Server.GetRequests("GET", "/data/file.bin").Num(), 1);
+
+	// the cache is keyed on the original URL, not on the loopback one
+	FDownloadCacheEntry Entry;
+	TestTrue("Cache entry for the original URL", DownloadCache::Find(URL, Entry));
+	TestEqual("Cached hash", Entry.SHA256, FStreamingSHA256::HashBytes(Body));
+	TestEqual("Cached size", Entry.Size, (int64) Body.Num());
+
+	// a second download is served from the cache
+	TestTrue("Second download succeeded", Download::SynchronousFromURL(URL, File));
+	TestEqual("GET requests after the second download", Scope.Server.GetRequests("GET", "/data/file.bin").Num(), 1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDownloadRetryTest, "LandscapeCombinator.Download.RetryAfterServerError",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FDownloadRetryTest::RunTest(const FString& Parameters)
+{
+	FLoopbackScope Scope;
+	if (!TestTrue("Loopback server started", Scope.IsValid())) return false;
+
+	TArray<uint8> Body = MakeBody(1000, 2);
+	FLoopbackResource Resource;
+	Resource.Body = Body;
+	Resource.NumFaults = 1;
+	Resource.FaultCode = 503;
+	Resource.LatencySeconds = 0.05;
+	Scope.Server.Serve("/busy.bin", Resource);
+
+	FString File = Scope.TempFile("busy.bin");
+	TestTrue("Download succeeded", Download::SynchronousFromURL(Scope.URL("/busy.bin"), File));
+	TestTrue("Downloaded file has the served content", FileEquals(File, Body));
+	TestEqual("GET requests", Scope.Server.GetRequests("GET", "/busy.bin").Num(), 2);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDownloadNotFoundTest, "LandscapeCombinator.Download.NotFound",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FDownloadNotFoundTest::RunTest(const FString& Parameters)
+{
+	FLoopbackScope Scope;
+	if (!TestTrue("Loopback server started", Scope.IsValid())) return false;
+
+	AddExpectedError("Error while downloading|Request was not successful", EAutomationExpectedErrorFlags::Contains, 0);
+
+	FString File = Scope.TempFile("missing.bin");
+	TestFalse("Download failed", Download::SynchronousFromURL(Scope.URL("/missing.bin"), File));
+	TestFalse("No file", FPaths::FileExists(File));
+	TestFalse("No part file", FPaths::FileExists(File + ".part"));
+
+	// 404 is not retryable
+	TestEqual("GET requests", Scope.Server.GetRequests("GET", "/missing.bin").Num(), 1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDownloadTruncatedTest, "LandscapeCombinator.Download.TruncatedResponseIsResumed",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FDownloadTruncatedTest::RunTest(const FString& Parameters)
+{
+	FLoopbackScope Scope;
+	if (!TestTrue("Loopback server started", Scope.IsValid())) return false;
+
+	TArray<uint8> Body = MakeBody(200000, 3);
+	FLoopbackResource Resource;
+	Resource.Body = Body;
+	Resource.ETag = "\"v1\"";
+	Resource.NumFaults = 1;
+	Resource.TruncateAfter = 50000;
+	Scope.Server.Serve("/archive.zip", Resource);
+
+	FString File = Scope.TempFile("archive.zip");
+	TestTrue("Download succeeded", Download::SynchronousFromURL(Scope.URL("/archive.zip"), File));
+	TestTrue("Downloaded file has the served content", FileEquals(File, Body));
+	TestFalse("Part file was renamed", FPaths::FileExists(File + ".part"));
+
+	TArray<FLoopbackRequest> Requests = Scope.Server.GetRequests("GET", "/archive.zip");
+	if (TestEqual("GET requests", Requests.Num(), 2))
+	{
+		TestEqual("Second request resumes", Requests[1].Headers.FindRef("range"), FString("bytes=50000-"));
+		TestEqual("Second request is conditional", Requests[1].Headers.FindRef("if-range"), Resource.ETag);
+	}
+
+	FDownloadCacheEntry Entry;
+	TestTrue("Cache entry", DownloadCache::Find(Scope.URL("/archive.zip"), Entry));
+	TestEqual("Hash covers the resumed bytes", Entry.SHA256, FStreamingSHA256::HashBytes(Body));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDownloadAlwaysTruncatedTest, "LandscapeCombinator.Download.AlwaysTruncatedFails",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FDownloadAlwaysTruncatedTest::RunTest(const FString& Parameters)
+{
+	FLoopbackScope Scope;
+	if (!TestTrue("Loopback server started", Scope.IsValid())) return false;
+
+	AddExpectedError("Error while downloading|Request was not successful|was truncated|Error while saving", EAutomationExpectedErrorFlags::Contains, 0);
+
+	FLoopbackResource Resource;
+	Resource.Body = MakeBody(100000, 4);
+	Resource.ETag = "\"v1\"";
+	Resource.NumFaults = 1000;
+	Resource.TruncateAfter = 1000;
+	Scope.Server.Serve("/flaky.bin", Resource);
+
+	FString File = Scope.TempFile("flaky.bin");
+	TestFalse("Download failed", Download::SynchronousFromURLExpecting(Scope.URL("/flaky.bin"), File, Resource.Body.Num()));
+	TestFalse("No incomplete file", FPaths::FileExists(File));
+	TestEqual("One GET request per attempt", Scope.Server.GetRequests("GET", "/flaky.bin").Num(), Download::RetryPolicy.MaxAttempts);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDownloadResumePartFileTest, "LandscapeCombinator.Download.ResumePartFile",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FDownloadResumePartFileTest::RunTest(const FString& Parameters)
+{
+	FLoopbackScope Scope;
+	if (!TestTrue("Loopback server started", Scope.IsValid())) return false;
+
+	TArray<uint8> Body = MakeBody(150000, 5);
+	FLoopbackResource Resource;
+	Resource.Body = Body;
+	Resource.ETag = "\"v2\"";
+	Scope.Server.Serve("/resume.bin", Resource);
+
+	// part file left by an interrupted download of the same version
+	FString File = Scope.TempFile("resume.bin");
+	TArray<uint8> Part(Body.GetData(), 60000);
+	FFileHelper::SaveArrayToFile(Part, *(File + ".part"));
+	FFileHelper::SaveStringToFile(Resource.ETag, *(File + ".part.validator"));
+
+	TestTrue("Download succeeded", Download::SynchronousFromURL(Scope.URL("/resume.bin"), File));
+	TestTrue("Downloaded file has the served content", FileEquals(File, Body));
+	TestFalse("Part file was renamed", FPaths::FileExists(File + ".part"));
+	TestFalse("Validator was deleted", FPaths::FileExists(File + ".part.validator"));
+
+	TArray<FLoopbackRequest> Requests = Scope.Server.GetRequests("GET", "/resume.bin");
+	if (TestEqual("GET requests", Requests.Num(), 1))
+	{
+		TestEqual("Request resumes", Requests[0].Headers.FindRef("range"), FString("bytes=60000-"));
+		TestEqual("Request is conditional", Requests[0].Headers.FindRef("if-range"), Resource.ETag);
+	}
+
+	FDownloadCacheEntry Entry;
+	TestTrue("Cache entry", DownloadCache::Find(Scope.URL("/resume.bin"), Entry));
+	TestEqual("Hash covers the part file", Entry.SHA256, FStreamingSHA256::HashBytes(Body));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDownloadStalePartFileTest, "LandscapeCombinator.Download.StalePartFileIsReplaced",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FDownloadStalePartFileTest::RunTest(const FString& Parameters)
+{
+	FLoopbackScope Scope;
+	if (!TestTrue("Loopback server started", Scope.IsValid())) return false;
+
+	TArray<uint8> Body = MakeBody(150000, 6);
+	FLoopbackResource Resource;
+	Resource.Body = Body;
+	Resource.ETag = "\"new\"";
+	Scope.Server.Serve("/stale.bin", Resource);
+
+	// part file of a previous version of the resource, which the server does not resume
+	FString File = Scope.TempFile("stale.bin");
+	FFileHelper::SaveArrayToFile(MakeBody(60000, 7), *(File + ".part"));
+	FFileHelper::SaveStringToFile(FString("\"old\""), *(File + ".part.validator"));
+
+	TestTrue("Download succeeded", Download::SynchronousFromURL(Scope.URL("/stale.bin"), File));
+	TestTrue("Downloaded file has the served content", FileEquals(File, Body));
+	TestEqual("GET requests", Scope.Server.GetRequests("GET", "/stale.bin").Num(), 1);
+
+	FDownloadCacheEntry Entry;
+	TestTrue("Cache entry", DownloadCache::Find(Scope.URL("/stale.bin"), Entry));
+	TestEqual("Hash does not cover the stale part file", Entry.SHA256, FStreamingSHA256::HashBytes(Body));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDownloadHashMismatchTest, "LandscapeCombinator.Download.HashMismatchRedownloads",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FDownloadHashMismatchTest::RunTest(const FString& Parameters)
+{
+	FLoopbackScope Scope;
+	if (!TestTrue("Loopback server started", Scope.IsValid())) return false;
+
+	TArray<uint8> Body = MakeBody(80000, 8);
+	FLoopbackResource Resource;
+	Resource.Body = Body;
+	Scope.Server.Serve("/checked.bin", Resource);
+
+	FString URL = Scope.URL("/checked.bin");
+	TestTrue("Download succeeded", Download::SynchronousFromURL(URL, Scope.TempFile("first.bin")));
+
+	// same size, different content: the cache must not trust it
+	AddExpectedError("is corrupted", EAutomationExpectedErrorFlags::Contains, 0);
+	FString File = Scope.TempFile("second.bin");
+	FFileHelper::SaveArrayToFile(MakeBody(Body.Num(), 9), *File);
+
+	TestTrue("Second download succeeded", Download::SynchronousFromURL(URL, File));
+	TestTrue("Corrupted file was replaced", FileEquals(File, Body));
+	TestEqual("GET requests", Scope.Server.GetRequests("GET", "/checked.bin").Num(), 2);
+
+	return true;
+}
+
+#endif
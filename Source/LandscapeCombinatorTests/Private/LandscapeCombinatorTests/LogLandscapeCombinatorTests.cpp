@@ -0,0 +1,5 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "LandscapeCombinatorTests/LogLandscapeCombinatorTests.h"
+
+DEFINE_LOG_CATEGORY(LogLandscapeCombinatorTests);
@@ -0,0 +1,8 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <Logging/LogMacros.h>
+
+DECLARE_LOG_CATEGORY_EXTERN(LogLandscapeCombinatorTests, Log, All);
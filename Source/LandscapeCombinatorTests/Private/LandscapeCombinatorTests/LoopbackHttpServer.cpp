@@ -0,0 +1,319 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "LandscapeCombinatorTests/LoopbackHttpServer.h"
+#include "LandscapeCombinatorTests/LogLandscapeCombinatorTests.h"
+
+#include "Common/TcpListener.h"
+#include "Common/TcpSocketBuilder.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
+#include "Interfaces/IPv4/IPv4Endpoint.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+FLoopbackResource FLoopbackResource::FromString(const FString& Text, FString ContentType)
+{
+	FLoopbackResource Resource;
+	FTCHARToUTF8 UTF8(*Text);
+	Resource.Body.Append((const uint8*) UTF8.Get(), UTF8.Length());
+	Resource.ContentType = ContentType;
+	return Resource;
+}
+
+FLoopbackResource FLoopbackResource::FromCode(int32 Code)
+{
+	FLoopbackResource Resource;
+	Resource.Code = Code;
+	Resource.bAcceptRanges = false;
+	return Resource;
+}
+
+bool FLoopbackHttpServer::Start()
+{
+	ListenSocket = FTcpSocketBuilder(TEXT("LoopbackHttpServer"))
+		.AsBlocking()
+		.AsReusable()
+		.BoundToEndpoint(FIPv4Endpoint(FIPv4Address(127, 0, 0, 1), 0))
+		.Listening(16)
+		.Build();
+
+	if (!ListenSocket)
+	{
+		UE_LOG(LogLandscapeCombinatorTests, Error, TEXT("Could not create the socket of the loopback HTTP server"));
+		return false;
+	}
+
+	Port = ListenSocket->GetPortNo();
+	Listener = MakeUnique<FTcpListener>(*ListenSocket, FTimespan::FromMilliseconds(10));
+	Listener->OnConnectionAccepted().BindRaw(this, &FLoopbackHttpServer::HandleConnection);
+
+	UE_LOG(LogLandscapeCombinatorTests, Log, TEXT("Loopback HTTP server listening on %s"), *URL());
+	return true;
+}
+
+void FLoopbackHttpServer::Stop()
+{
+	// waits for the thread of the listener, which does not own the socket
+	Listener.Reset();
+
+	if (ListenSocket)
+	{
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ListenSocket);
+		ListenSocket = nullptr;
+	}
+}
+
+FString FLoopbackHttpServer::URL(FString Path) const
+{
+	return FString::Printf(TEXT("http://127.0.0.1:%d%s"), Port, *Path);
+}
+
+void FLoopbackHttpServer::Serve(FString Path, FLoopbackResource Resource)
+{
+	FScopeLock ScopeLock(&Lock);
+	Resources.Add(Path, Resource);
+}
+
+void FLoopbackHttpServer::ServeDirectory(FString PathPrefix, FString Directory)
+{
+	FScopeLock ScopeLock(&Lock);
+	Directories.Add({ PathPrefix, Directory });
+}
+
+void FLoopbackHttpServer::Route(FString PathPrefix, TFunction<FLoopbackResource(const FLoopbackRequest&)> Handler)
+{
+	FScopeLock ScopeLock(&Lock);
+	Routes.Add({ PathPrefix, Handler });
+}
+
+TArray<FLoopbackRequest> FLoopbackHttpServer::GetRequests() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Requests;
+}
+
+TArray<FLoopbackRequest> FLoopbackHttpServer::GetRequests(FString Verb, FString Path) const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Requests.FilterByPredicate([&](const FLoopbackRequest& Request) { return Request.Verb == Verb && Request.Path == Path; });
+}
+
+bool FLoopbackHttpServer::Find(const FLoopbackRequest& Request, FLoopbackResource& OutResource, bool& bOutFault)
+{
+	const bool bGet = Request.Verb == "GET";
+	bOutFault = false;
+
+	TFunction<FLoopbackResource(const FLoopbackRequest&)> Handler;
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		if (FLoopbackResource* Resource = Resources.Find(Request.Path))
+		{
+			OutResource = *Resource;
+			if (bGet && Resource->NumFaults > 0)
+			{
+				Resource->NumFaults--;
+				bOutFault = true;
+			}
+			return true;
+		}
+
+		int32 BestDirectory = -1;
+		for (int32 i = 0; i < Directories.Num(); i++)
+		{
+			if (Request.Path.StartsWith(Directories[i].Key) && (BestDirectory == -1 || Directories[i].Key.Len() > Directories[BestDirectory].Key.Len()))
+			{
+				BestDirectory = i;
+			}
+		}
+		if (BestDirectory != -1)
+		{
+			FString File = FPaths::Combine(Directories[BestDirectory].Value, Request.Path.RightChop(Directories[BestDirectory].Key.Len()));
+			return FFileHelper::LoadFileToArray(OutResource.Body, *File, FILEREAD_Silent);
+		}
+
+		int32 BestRoute = -1;
+		for (int32 i = 0; i < Routes.Num(); i++)
+		{
+			if (Request.Path.StartsWith(Routes[i].Key) && (BestRoute == -1 || Routes[i].Key.Len() > Routes[BestRoute].Key.Len()))
+			{
+				BestRoute = i;
+			}
+		}
+		if (BestRoute != -1) Handler = Routes[BestRoute].Value;
+	}
+
+	if (!Handler) return false;
+
+	// outside of the lock, handlers may take their time
+	OutResource = Handler(Request);
+	bOutFault = bGet && OutResource.NumFaults > 0;
+	return true;
+}
+
+static FString ReasonPhrase(int32 Code)
+{
+	switch (Code)
+	{
+		case 200: return "OK";
+		case 206: return "Partial Content";
+		case 304: return "Not Modified";
+		case 404: return "Not Found";
+		case 416: return "Range Not Satisfiable";
+		case 500: return "Internal Server Error";
+		case 503: return "Service Unavailable";
+		default: return "Status";
+	}
+}
+
+bool FLoopbackHttpServer::HandleConnection(FSocket* Socket, const FIPv4Endpoint& Endpoint)
+{
+	FLoopbackRequest Request;
+	if (!ReadRequest(Socket, Request)) return false;
+
+	{
+		FScopeLock ScopeLock(&Lock);
+		Requests.Add(Request);
+	}
+
+	FLoopbackResource Resource;
+	bool bFault = false;
+	if (!Find(Request, Resource, bFault)) Resource = FLoopbackResource::FromCode(404);
+
+	if (Resource.LatencySeconds > 0) FPlatformProcess::Sleep(Resource.LatencySeconds);
+
+	int32 Code = Resource.Code;
+	int64 Total = Resource.Body.Num();
+	int64 Start = 0;
+	int64 Length = Total;
+	FString Headers;
+
+	if (bFault && Resource.FaultCode != 0)
+	{
+		Code = Resource.FaultCode;
+		Length = 0;
+	}
+	else if (Code == 200 && Resource.bAcceptRanges)
+	{
+		// only open-ended ranges are used by FileDownloader
+		FString Range = Request.Headers.FindRef("range");
+		FString IfRange = Request.Headers.FindRef("if-range");
+		FString From, To;
+		if (Range.StartsWith("bytes=") && Range.RightChop(6).Split("-", &From, &To) && (IfRange.IsEmpty() || IfRange == Resource.ETag))
+		{
+			Start = FCString::Atoi64(*From);
+			if (Start >= Total)
+			{
+				Code = 416;
+				Start = 0;
+				Length = 0;
+				Headers += FString::Printf(TEXT("Content-Range: bytes */%lld\r\n"), Total);
+			}
+			else
+			{
+				Code = 206;
+				Length = Total - Start;
+				Headers += FString::Printf(TEXT("Content-Range: bytes %lld-%lld/%lld\r\n"), Start, Total - 1, Total);
+			}
+		}
+	}
+
+	if (!Resource.ETag.IsEmpty()) Headers += FString::Printf(TEXT("ETag: %s\r\n"), *Resource.ETag);
+	if (Resource.bAcceptRanges) Headers += TEXT("Accept-Ranges: bytes\r\n");
+
+	FString Head = FString::Printf(
+		TEXT("HTTP/1.1 %d %s\r\nContent-Length: %lld\r\nContent-Type: %s\r\n%sConnection: close\r\n\r\n"),
+		Code, *ReasonPhrase(Code), Length, *Resource.ContentType, *Headers
+	);
+	FTCHARToUTF8 HeadUTF8(*Head);
+	if (!SendAll(Socket, (const uint8*) HeadUTF8.Get(), HeadUTF8.Length())) return false;
+
+	if (Request.Verb != "HEAD")
+	{
+		int64 ToSend = bFault && Resource.FaultCode == 0 ? FMath::Clamp<int64>(Resource.TruncateAfter, 0, Length) : Length;
+		SendAll(Socket, Resource.Body.GetData() + Start, ToSend);
+	}
+
+	// the listener closes the connection, which ends the response, or truncates it when injecting a fault
+	return false;
+}
+
+bool FLoopbackHttpServer::ReadRequest(FSocket* Socket, FLoopbackRequest& OutRequest)
+{
+	TArray<uint8> Received;
+	int32 End = INDEX_NONE;
+	const double Deadline = FPlatformTime::Seconds() + 10;
+
+	// requests without a body end with an empty line
+	while (End == INDEX_NONE)
+	{
+		if (FPlatformTime::Seconds() > Deadline) return false;
+		if (!Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromMilliseconds(100))) continue;
+
+		uint8 Buffer[4096];
+		int32 Read = 0;
+		if (!Socket->Recv(Buffer, sizeof(Buffer), Read) || Read <= 0) return false;
+		Received.Append(Buffer, Read);
+
+		for (int32 i = 0; i + 3 < Received.Num(); i++)
+		{
+			if (Received[i] == '\r' && Received[i + 1] == '\n' && Received[i + 2] == '\r' && Received[i + 3] == '\n')
+			{
+				End = i;
+				break;
+			}
+		}
+	}
+
+	FString Head(End, (const ANSICHAR*) Received.GetData());
+	TArray<FString> Lines;
+	Head.ParseIntoArray(Lines, TEXT("\r\n"), true);
+	if (Lines.IsEmpty()) return false;
+
+	TArray<FString> RequestLine;
+	Lines[0].ParseIntoArray(RequestLine, TEXT(" "), true);
+	if (RequestLine.Num() < 2) return false;
+
+	OutRequest.Verb = RequestLine[0];
+	OutRequest.Target = RequestLine[1];
+
+	FString QueryString;
+	if (!RequestLine[1].Split("?", &OutRequest.Path, &QueryString))
+	{
+		OutRequest.Path = RequestLine[1];
+	}
+
+	TArray<FString> Parameters;
+	QueryString.ParseIntoArray(Parameters, TEXT("&"), true);
+	for (auto& Parameter : Parameters)
+	{
+		FString Key, Value;
+		if (!Parameter.Split("=", &Key, &Value)) Key = Parameter;
+		OutRequest.Query.Add(FGenericPlatformHttp::UrlDecode(Key), FGenericPlatformHttp::UrlDecode(Value));
+	}
+
+	for (int32 i = 1; i < Lines.Num(); i++)
+	{
+		FString Name, Value;
+		if (Lines[i].Split(":", &Name, &Value))
+		{
+			OutRequest.Headers.Add(Name.TrimStartAndEnd().ToLower(), Value.TrimStartAndEnd());
+		}
+	}
+
+	return true;
+}
+
+bool FLoopbackHttpServer::SendAll(FSocket* Socket, const uint8* Data, int64 Size)
+{
+	while (Size > 0)
+	{
+		int32 Sent = 0;
+		if (!Socket->Send(Data, (int32) FMath::Min<int64>(Size, 64 * 1024), Sent) || Sent <= 0) return false;
+		Data += Sent;
+		Size -= Sent;
+	}
+	return true;
+}
@@ -0,0 +1,84 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FSocket;
+class FTcpListener;
+struct FIPv4Endpoint;
+
+// A response of FLoopbackHttpServer, with the faults to inject
+struct FLoopbackResource
+{
+	int32 Code = 200;
+	TArray<uint8> Body;
+	FString ContentType = "application/octet-stream";
+
+	// Sent when not empty, and compared with If-Range before honoring a Range header
+	FString ETag;
+	bool bAcceptRanges = true;
+
+	// Delay before each response
+	float LatencySeconds = 0;
+
+	// The first `NumFaults` GET responses answer `FaultCode` with an empty body if it is not 0,
+	// or else announce the whole body but close the connection after `TruncateAfter` bytes of it
+	int32 NumFaults = 0;
+	int32 FaultCode = 0;
+	int64 TruncateAfter = 0;
+
+	static FLoopbackResource FromString(const FString& Text, FString ContentType = "text/plain");
+	static FLoopbackResource FromCode(int32 Code);
+};
+
+// A request received by FLoopbackHttpServer
+struct FLoopbackRequest
+{
+	FString Verb;
+	FString Target;  // as requested, with the query string
+	FString Path;    // without the query string
+	TMap<FString, FString> Query;
+	TMap<FString, FString> Headers;  // with lowercase names
+};
+
+// HTTP/1.1 server listening on 127.0.0.1, answering one request per connection from the thread of its listener.
+// Requests are answered with the resource served at their path, or else with the file of the longest matching directory,
+// or else by the handler of the longest matching route, or else with 404.
+class FLoopbackHttpServer
+{
+public:
+	~FLoopbackHttpServer() { Stop(); }
+
+	// Listens on a port chosen by the system
+	bool Start();
+	void Stop();
+
+	// "http://127.0.0.1:<port>" followed by `Path`
+	FString URL(FString Path = "") const;
+
+	void Serve(FString Path, FLoopbackResource Resource);
+	void ServeDirectory(FString PathPrefix, FString Directory);
+	void Route(FString PathPrefix, TFunction<FLoopbackResource(const FLoopbackRequest&)> Handler);
+
+	// Requests received so far, in their order of arrival
+	TArray<FLoopbackRequest> GetRequests() const;
+	TArray<FLoopbackRequest> GetRequests(FString Verb, FString Path) const;
+
+private:
+	bool HandleConnection(FSocket* Socket, const FIPv4Endpoint& Endpoint);
+	bool Find(const FLoopbackRequest& Request, FLoopbackResource& OutResource, bool& bOutFault);
+
+	static bool ReadRequest(FSocket* Socket, FLoopbackRequest& OutRequest);
+	static bool SendAll(FSocket* Socket, const uint8* Data, int64 Size);
+
+	FSocket* ListenSocket = nullptr;
+	TUniquePtr<FTcpListener> Listener;
+	int32 Port = 0;
+
+	mutable FCriticalSection Lock;
+	TMap<FString, FLoopbackResource> Resources;
+	TArray<TPair<FString, FString>> Directories;
+	TArray<TPair<FString, TFunction<FLoopbackResource(const FLoopbackRequest&)>>> Routes;
+	TArray<FLoopbackRequest> Requests;
+};
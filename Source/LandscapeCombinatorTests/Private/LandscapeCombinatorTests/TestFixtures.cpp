@@ -0,0 +1,174 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "LandscapeCombinatorTests/TestFixtures.h"
+#include "LandscapeCombinatorTests/LogLandscapeCombinatorTests.h"
+
+#include "FileDownloader/Download.h"
+#include "FileDownloader/DownloadCache.h"
+#include "GDALInterface/GDALInterface.h"
+
+#include "Async/TaskGraphInterfaces.h"
+#include "Containers/Ticker.h"
+#include "HAL/PlatformFileManager.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include <atomic>
+
+FLoopbackScope::FLoopbackScope()
+{
+	Id = FGuid::NewGuid().ToString(EGuidFormats::Digits);
+	Origin = FString::Printf(TEXT("https://loopback.test/%s/"), *Id);
+	TempDir = FPaths::Combine(FPaths::ProjectSavedDir(), "LandscapeCombinatorTests", Id);
+	IPlatformFile::GetPlatformPhysical().CreateDirectoryTree(*TempDir);
+
+	SavedRetryPolicy = Download::RetryPolicy;
+	Download::RetryPolicy.MaxAttempts = 3;
+	Download::RetryPolicy.InitialBackoffSeconds = 0.05;
+	Download::RetryPolicy.MaxBackoffSeconds = 0.1;
+
+	bStarted = Server.Start();
+	if (bStarted) Download::AddRedirect(Origin, Server.URL("/"));
+}
+
+FLoopbackScope::~FLoopbackScope()
+{
+	Download::RemoveRedirect(Origin);
+	Download::RetryPolicy = SavedRetryPolicy;
+
+	for (auto& Request : Server.GetRequests())
+	{
+		DownloadCache::Remove(URL(Request.Target));
+	}
+	Server.Stop();
+
+	IPlatformFile &PlatformFile = IPlatformFile::GetPlatformPhysical();
+	for (auto& Path : ToDelete)
+	{
+		if (PlatformFile.DirectoryExists(*Path)) PlatformFile.DeleteDirectoryRecursively(*Path);
+		else PlatformFile.DeleteFile(*Path);
+	}
+	PlatformFile.DeleteDirectoryRecursively(*TempDir);
+}
+
+FString LandscapeCombinatorTests::FixturesDir()
+{
+	TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin("LandscapeCombinator");
+	if (!Plugin.IsValid()) return "";
+	return FPaths::Combine(Plugin->GetBaseDir(), "Source", "LandscapeCombinatorTests", "Fixtures");
+}
+
+FString LandscapeCombinatorTests::LoadFixture(FString Name)
+{
+	FString Content;
+	FString File = FPaths::Combine(FixturesDir(), Name);
+	if (!FFileHelper::LoadFileToString(Content, *File))
+	{
+		UE_LOG(LogLandscapeCombinatorTests, Error, TEXT("Could not read fixture %s"), *File);
+	}
+	return Content;
+}
+
+bool LandscapeCombinatorTests::WaitOnGameThread(TFunction<void(TFunction<void(bool)>)> Action, float TimeoutSeconds)
+{
+	check(IsInGameThread());
+
+	// -1 while running, the callback may still be called after a timeout
+	TSharedRef<std::atomic<int32>, ESPMode::ThreadSafe> Result = MakeShared<std::atomic<int32>, ESPMode::ThreadSafe>(-1);
+	Action([Result](bool bSuccess) { *Result = bSuccess ? 1 : 0; });
+
+	const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+	double LastTime = FPlatformTime::Seconds();
+	while (*Result == -1 && FPlatformTime::Seconds() < Deadline)
+	{
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+
+		double Now = FPlatformTime::Seconds();
+		FTSTicker::GetCoreTicker().Tick(Now - LastTime);
+		LastTime = Now;
+
+		FPlatformProcess::Sleep(0.01);
+	}
+
+	if (*Result == -1)
+	{
+		UE_LOG(LogLandscapeCombinatorTests, Error, TEXT("Timed out after %.0f seconds"), TimeoutSeconds);
+		return false;
+	}
+	return *Result == 1;
+}
+
+TArray<uint8> LandscapeCombinatorTests::EncodeRaster(FString Driver, int Width, int Height, TArray<uint8> Color, bool bPaletted, FString CRS, FVector4d Extent)
+{
+	GDALDriver *MemDriver = GetGDALDriverManager()->GetDriverByName("MEM");
+	GDALDriver *OutDriver = GetGDALDriverManager()->GetDriverByName(TCHAR_TO_UTF8(*Driver));
+	if (!MemDriver || !OutDriver || Color.IsEmpty()) return {};
+
+	GDALDataset *Dataset = MemDriver->Create("", Width, Height, bPaletted ? 1 : Color.Num(), GDT_Byte, nullptr);
+	if (!Dataset) return {};
+
+	if (bPaletted)
+	{
+		GDALColorTable ColorTable;
+		GDALColorEntry Entry = { Color[0], Color.Num() > 1 ? Color[1] : Color[0], Color.Num() > 2 ? Color[2] : Color[0], 255 };
+		ColorTable.SetColorEntry(0, &Entry);
+		Dataset->GetRasterBand(1)->SetColorTable(&ColorTable);
+		Dataset->GetRasterBand(1)->Fill(0);
+	}
+	else
+	{
+		for (int Band = 0; Band < Color.Num(); Band++)
+		{
+			Dataset->GetRasterBand(Band + 1)->Fill(Color[Band]);
+		}
+	}
+
+	if (!CRS.IsEmpty())
+	{
+		OGRSpatialReference SpatialReference;
+		if (!GDALInterface::SetCRSFromUserInput(SpatialReference, CRS))
+		{
+			GDALClose(Dataset);
+			return {};
+		}
+		double GeoTransform[6] = { Extent[0], (Extent[1] - Extent[0]) / Width, 0, Extent[3], 0, -(Extent[3] - Extent[2]) / Height };
+		Dataset->SetSpatialRef(&SpatialReference);
+		Dataset->SetGeoTransform(GeoTransform);
+	}
+
+	FString MemFile = FString::Printf(TEXT("/vsimem/LandscapeCombinatorTests/%s"), *FGuid::NewGuid().ToString());
+	GDALDataset *Encoded = OutDriver->CreateCopy(TCHAR_TO_UTF8(*MemFile), Dataset, 0, nullptr, nullptr, nullptr);
+	GDALClose(Dataset);
+	if (!Encoded) return {};
+	GDALClose(Encoded);
+
+	vsi_l_offset Length = 0;
+	GByte *Data = VSIGetMemFileBuffer(TCHAR_TO_UTF8(*MemFile), &Length, true);
+	if (!Data) return {};
+
+	TArray<uint8> Result(Data, (int32) Length);
+	CPLFree(Data);
+	VSIUnlink(TCHAR_TO_UTF8(*(MemFile + ".aux.xml")));
+	return Result;
+}
+
+TArray<uint8> LandscapeCombinatorTests::ReadPixel(FString File, int X, int Y)
+{
+	GDALDataset *Dataset = (GDALDataset *) GDALOpen(TCHAR_TO_UTF8(*File), GA_ReadOnly);
+	if (!Dataset) return {};
+
+	TArray<uint8> Pixel;
+	Pixel.SetNumZeroed(Dataset->GetRasterCount());
+	for (int Band = 0; Band < Dataset->GetRasterCount(); Band++)
+	{
+		if (Dataset->GetRasterBand(Band + 1)->RasterIO(GF_Read, X, Y, 1, 1, &Pixel[Band], 1, 1, GDT_Byte, 0, 0) != CE_None)
+		{
+			Pixel.Empty();
+			break;
+		}
+	}
+
+	GDALClose(Dataset);
+	return Pixel;
+}
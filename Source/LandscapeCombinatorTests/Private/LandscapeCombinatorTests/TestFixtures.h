@@ -0,0 +1,63 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LandscapeCombinatorTests/LoopbackHttpServer.h"
+
+#include "FileDownloader/RetryPolicy.h"
+
+// Starts a loopback server and redirects the downloads of a unique origin (https://loopback.test/<id>/) to it,
+// with fast retries. Everything is undone when the scope ends: the redirect, the retry policy, the download cache
+// entries of the URLs that were requested, the temporary directory and the files given to DeleteAfter.
+class FLoopbackScope
+{
+public:
+	FLoopbackScope();
+	~FLoopbackScope();
+
+	bool IsValid() const { return bStarted; }
+
+	// URL of the origin that is served from `ServerPath` (starting with "/") on the loopback server
+	FString URL(FString ServerPath) const { return Origin + ServerPath.RightChop(1); }
+
+	// Unique path in the temporary directory of the scope
+	FString TempFile(FString Name) const { return FPaths::Combine(TempDir, Name); }
+
+	void DeleteAfter(FString Path) { ToDelete.Add(Path); }
+
+	FLoopbackHttpServer Server;
+
+	// Unique name usable for files and layers
+	FString Id;
+
+private:
+	bool bStarted = false;
+	FString Origin;
+	FString TempDir;
+	FRetryPolicy SavedRetryPolicy;
+	TArray<FString> ToDelete;
+};
+
+namespace LandscapeCombinatorTests
+{
+	// Directory of the text fixtures (WMS capabilities...)
+	FString FixturesDir();
+
+	FString LoadFixture(FString Name);
+
+	// Calls `Action`, then runs the game thread tasks and tickers until `Action` calls its completion callback,
+	// for code reporting to the game thread. Returns false on timeout, and otherwise the value given to the callback.
+	bool WaitOnGameThread(TFunction<void(TFunction<void(bool)>)> Action, float TimeoutSeconds = 60);
+
+	// Encodes a `Width` x `Height` raster with the GDAL driver `Driver`, filled with `Color` (one value per band),
+	// either as bands or as one band with a color table; it is georeferenced if `CRS` is not empty.
+	// `Extent` is (MinLong, MaxLong, MinLat, MaxLat) in `CRS`. Returns an empty array on error.
+	TArray<uint8> EncodeRaster(
+		FString Driver, int Width, int Height, TArray<uint8> Color, bool bPaletted,
+		FString CRS = "", FVector4d Extent = FVector4d::Zero()
+	);
+
+	// Reads the pixel (X, Y) of all the bands of `File`, or an empty array on error
+	TArray<uint8> ReadPixel(FString File, int X, int Y);
+}
@@ -0,0 +1,68 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "LandscapeCombinatorTests/TestFixtures.h"
+
+#include "ConsoleHelpers/Console.h"
+#include "ImageDownloader/Directories.h"
+#include "ImageDownloader/Downloaders/HMViewfinderDownloader.h"
+
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FViewfinderDownloadTest, "LandscapeCombinator.Viewfinder.DownloadAndExtract",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FViewfinderDownloadTest::RunTest(const FString& Parameters)
+{
+	if (!Console::ExecProcess(TEXT("7z"), TEXT(""), false, false))
+	{
+		AddWarning("7z is not available in the PATH, skipping the Viewfinder Panoramas test");
+		return true;
+	}
+
+	FLoopbackScope Scope;
+	if (!TestTrue("Loopback server started", Scope.IsValid())) return false;
+
+	// a 3 arc-second tile: 1201 x 1201 big-endian 16-bit heights
+	TArray<uint8> HGT;
+	HGT.SetNumUninitialized(1201 * 1201 * 2);
+	for (int i = 0; i < 1201 * 1201; i++)
+	{
+		uint16 Height = (uint16) (i % 4000);
+		HGT[2 * i] = Height >> 8;
+		HGT[2 * i + 1] = Height & 0xFF;
+	}
+
+	FString MegaTile = "Loopback" + Scope.Id;
+	FString HGTFile = Scope.TempFile("N45E006.hgt");
+	FString ZipFile = Scope.TempFile(MegaTile + ".zip");
+	if (!TestTrue("HGT written", FFileHelper::SaveArrayToFile(HGT, *HGTFile))) return false;
+	FString ZipParams = FString::Format(TEXT("a -tzip \"{0}\" \"{1}\""), { ZipFile, HGTFile });
+	if (!TestTrue("Archive created", Console::ExecProcess(TEXT("7z"), *ZipParams, false, false))) return false;
+
+	Scope.Server.ServeDirectory("/dem3/", FPaths::GetPath(ZipFile));
+	Scope.DeleteAfter(FPaths::Combine(Directories::DownloadDir(), MegaTile + ".zip"));
+	Scope.DeleteAfter(FPaths::Combine(Directories::ImageDownloaderDir(), MegaTile));
+
+	TSharedRef<HMViewfinderDownloader> Fetcher = MakeShared<HMViewfinderDownloader>(MegaTile, Scope.URL("/dem3/"), false);
+	bool bFetched = LandscapeCombinatorTests::WaitOnGameThread([Fetcher](TFunction<void(bool)> OnDone)
+	{
+		Fetcher->Fetch("", {}, [Fetcher, OnDone](bool bSuccess) { OnDone(bSuccess); });
+	});
+	if (!TestTrue("Mega tile fetched", bFetched)) return false;
+
+	TestEqual("GET requests", Scope.Server.GetRequests("GET", "/dem3/" + MegaTile + ".zip").Num(), 1);
+	TestEqual("Output CRS", Fetcher->OutputCRS, FString("EPSG:4326"));
+	if (!TestEqual("Output files", Fetcher->OutputFiles.Num(), 1)) return false;
+
+	TestEqual("Extracted file name", FPaths::GetCleanFilename(Fetcher->OutputFiles[0]), FString("N45E006.hgt"));
+	TArray<uint8> Extracted;
+	TestTrue("Extracted file read", FFileHelper::LoadFileToArray(Extracted, *Fetcher->OutputFiles[0]));
+	TestTrue("Extracted file has the archived content", Extracted == HGT);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,143 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "LandscapeCombinatorTests/TestFixtures.h"
+
+#include "GDALInterface/GDALInterface.h"
+#include "ImageDownloader/WMSProvider.h"
+#include "ImageDownloader/Downloaders/HMURL.h"
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Serves the capabilities fixture, and GetMap requests with a GeoTIFF covering exactly the requested box
+static void ServeWMS(FLoopbackScope& Scope)
+{
+	FString Capabilities = LandscapeCombinatorTests::LoadFixture("WMSCapabilities.xml").Replace(TEXT("{GetMapURL}"), *Scope.URL("/wms?"));
+
+	Scope.Server.Route("/wms", [Capabilities](const FLoopbackRequest& Request)
+	{
+		if (Request.Query.FindRef("REQUEST") != "GetMap")
+		{
+			return FLoopbackResource::FromString(Capabilities, "text/xml");
+		}
+
+		TArray<FString> BBox;
+		Request.Query.FindRef("BBOX").ParseIntoArray(BBox, TEXT(","));
+		int Width = FCString::Atoi(*Request.Query.FindRef("WIDTH"));
+		int Height = FCString::Atoi(*Request.Query.FindRef("HEIGHT"));
+		if (BBox.Num() != 4 || Width <= 0 || Height <= 0) return FLoopbackResource::FromCode(400);
+
+		// the test layers have their longitudes first
+		FVector4d Extent(FCString::Atod(*BBox[0]), FCString::Atod(*BBox[2]), FCString::Atod(*BBox[1]), FCString::Atod(*BBox[3]));
+
+		FLoopbackResource Resource;
+		Resource.ContentType = "image/geotiff";
+		Resource.Body = LandscapeCombinatorTests::EncodeRaster("GTiff", Width, Height, { 42 }, false, Request.Query.FindRef("CRS"), Extent);
+		return Resource;
+	});
+}
+
+static bool LoadCapabilities(FLoopbackScope& Scope, TSharedRef<FWMSProvider> Provider)
+{
+	bool bSuccess = LandscapeCombinatorTests::WaitOnGameThread([&Scope, Provider](TFunction<void(bool)> OnDone)
+	{
+		Provider->SetFromURL(Scope.URL("/wms?SERVICE=WMS&REQUEST=GetCapabilities"), {}, nullptr, [Provider, OnDone](bool bSuccess)
+		{
+			OnDone(bSuccess);
+		});
+	});
+	Scope.DeleteAfter(Provider->CapabilitiesFile);
+	return bSuccess;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWMSCapabilitiesTest, "LandscapeCombinator.WMS.Capabilities",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FWMSCapabilitiesTest::RunTest(const FString& Parameters)
+{
+	FLoopbackScope Scope;
+	if (!TestTrue("Loopback server started", Scope.IsValid())) return false;
+	ServeWMS(Scope);
+
+	TSharedRef<FWMSProvider> Provider = MakeShared<FWMSProvider>();
+	if (!TestTrue("Capabilities loaded", LoadCapabilities(Scope, Provider))) return false;
+
+	TestEqual("Layer names", Provider->Names, TArray<FString>({ "ELEVATION", "SLOPE" }));
+	TestEqual("Layer titles", Provider->Titles, TArray<FString>({ "Elevation (test)", "Slope" }));
+	TestEqual("Layer abstracts", Provider->Abstracts, TArray<FString>({ "Synthetic elevation layer", "Slope" }));
+	TestEqual("Layer CRSs", Provider->CRSs, TArray<FString>({ "EPSG:4326", "EPSG:2154" }));
+	TestEqual("Layer MinXs", Provider->MinXs, TArray<double>({ 40, 100000 }));
+	TestEqual("Layer MaxYs", Provider->MaxYs, TArray<double>({ 10, 7200000 }));
+	TestEqual("GetMap URL", Provider->GetMapURL, Scope.URL("/wms?"));
+	TestEqual("Max width", Provider->MaxWidth, 4096);
+	TestEqual("Max height", Provider->MaxHeight, 2048);
+
+	// filtered layers are skipped
+	TSharedRef<FWMSProvider> Filtered = MakeShared<FWMSProvider>();
+	Filtered->CapabilitiesFile = Provider->CapabilitiesFile;
+	TestTrue("Filtered capabilities loaded", Filtered->LoadFromFile({}, [](FString Name) { return Name != "SLOPE"; }));
+	TestEqual("Filtered layer names", Filtered->Names, TArray<FString>({ "ELEVATION" }));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWMSGetMapTest, "LandscapeCombinator.WMS.GetMap",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FWMSGetMapTest::RunTest(const FString& Parameters)
+{
+	FLoopbackScope Scope;
+	if (!TestTrue("Loopback server started", Scope.IsValid())) return false;
+	ServeWMS(Scope);
+
+	TSharedRef<FWMSProvider> Provider = MakeShared<FWMSProvider>();
+	if (!TestTrue("Capabilities loaded", LoadCapabilities(Scope, Provider))) return false;
+
+	FString URL, FileExt;
+	bool bGeoTiff = false;
+	bool bCreated = Provider->CreateURL(
+		512, 256, "ELEVATION", "EPSG:4326", true,
+		40, 50, -10, 10,
+		45, 46, 5, 5.5,
+		URL, bGeoTiff, FileExt
+	);
+	if (!TestTrue("GetMap URL created", bCreated)) return false;
+	TestTrue("GeoTIFF format", bGeoTiff);
+	TestEqual("File extension", FileExt, FString("tif"));
+
+	FString FileName = FString::Printf(TEXT("WMS_%s.tif"), *Scope.Id);
+	TSharedRef<HMURL> Fetcher = MakeShared<HMURL>(URL, FileName, "EPSG:4326");
+	bool bFetched = LandscapeCombinatorTests::WaitOnGameThread([Fetcher](TFunction<void(bool)> OnDone)
+	{
+		Fetcher->Fetch("", {}, [Fetcher, OnDone](bool bSuccess) { OnDone(bSuccess); });
+	});
+	for (auto& File : Fetcher->OutputFiles) Scope.DeleteAfter(File);
+	if (!TestTrue("GetMap downloaded", bFetched) || !TestEqual("Output files", Fetcher->OutputFiles.Num(), 1)) return false;
+
+	TArray<FLoopbackRequest> GetMaps = Scope.Server.GetRequests("GET", "/wms").FilterByPredicate([](const FLoopbackRequest& Request)
+	{
+		return Request.Query.FindRef("REQUEST") == "GetMap";
+	});
+	if (TestEqual("GetMap requests", GetMaps.Num(), 1))
+	{
+		TestEqual("LAYERS", GetMaps[0].Query.FindRef("LAYERS"), FString("ELEVATION"));
+		TestEqual("CRS", GetMaps[0].Query.FindRef("CRS"), FString("EPSG:4326"));
+		TestEqual("FORMAT", GetMaps[0].Query.FindRef("FORMAT"), FString("image/geotiff"));
+	}
+
+	FIntPoint Pixels;
+	TestTrue("Pixels read", GDALInterface::GetPixels(Pixels, Fetcher->OutputFiles[0]));
+	TestEqual("Pixels", Pixels, FIntPoint(512, 256));
+
+	FVector4d Coordinates;
+	TestTrue("Coordinates read", GDALInterface::GetCoordinates(Coordinates, { Fetcher->OutputFiles[0] }));
+	TestEqual("MinLong", Coordinates[0], 45.0, 1e-9);
+	TestEqual("MaxLong", Coordinates[1], 46.0, 1e-9);
+	TestEqual("MinLat", Coordinates[2], 5.0, 1e-9);
+	TestEqual("MaxLat", Coordinates[3], 5.5, 1e-9);
+
+	return true;
+}
+
+#endif
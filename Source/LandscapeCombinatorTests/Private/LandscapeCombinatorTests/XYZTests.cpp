@@ -0,0 +1,205 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "LandscapeCombinatorTests/TestFixtures.h"
+
+#include "GDALInterface/GDALInterface.h"
+#include "GDALInterface/RasterBlocks.h"
+#include "ImageDownloader/Directories.h"
+#include "ImageDownloader/Downloaders/HMXYZ.h"
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static const int XYZZoom = 2;
+static const int XYZMin = 1;
+static const int XYZMax = 2;
+
+static TArray<uint8> TileColor(int X, int Y)
+{
+	return { (uint8) (60 * X), (uint8) (60 * Y), 100 };
+}
+
+// Serves /tiles/<z>/<x>/<y>.png as 256x256 PNG tiles of uniform colors, except for the tiles in `Missing`,
+// and with a color table for the tiles in `Paletted`
+static void ServeTiles(FLoopbackScope& Scope, TArray<FIntPoint> Missing = {}, TArray<FIntPoint> Paletted = {})
+{
+	Scope.Server.Route("/tiles/", [Missing, Paletted](const FLoopbackRequest& Request)
+	{
+		TArray<FString> Parts;
+		Request.Path.RightChop(7).LeftChop(4).ParseIntoArray(Parts, TEXT("/"));
+		if (Parts.Num() != 3) return FLoopbackResource::FromCode(400);
+
+		int X = FCString::Atoi(*Parts[1]);
+		int Y = FCString::Atoi(*Parts[2]);
+		if (Missing.Contains(FIntPoint(X, Y))) return FLoopbackResource::FromCode(404);
+
+		FLoopbackResource Resource;
+		Resource.ContentType = "image/png";
+		Resource.Body = LandscapeCombinatorTests::EncodeRaster("PNG", 256, 256, TileColor(X, Y), Paletted.Contains(FIntPoint(X, Y)));
+		return Resource;
+	});
+}
+
+static TSharedRef<HMXYZ> MakeFetcher(FLoopbackScope& Scope, bool bDecodeTerrarium = false)
+{
+	FString Name = "Loopback" + Scope.Id;
+	for (int X = XYZMin; X <= XYZMax; X++)
+	{
+		for (int Y = XYZMin; Y <= XYZMax; Y++)
+		{
+			Scope.DeleteAfter(FPaths::Combine(Directories::DownloadDir(), FString::Format(TEXT("{0}-{1}-{2}-{3}.png"), { Name, XYZZoom, X, Y })));
+			Scope.DeleteAfter(FPaths::Combine(Directories::DownloadDir(), FString::Format(TEXT("{0}-{1}-{2}-{3}-terrarium.tif"), { Name, XYZZoom, X, Y })));
+		}
+	}
+	Scope.DeleteAfter(FPaths::Combine(Directories::ImageDownloaderDir(), Name + "-XYZ"));
+
+	return MakeShared<HMXYZ>(
+		Name, Name, "png", Scope.URL("/tiles/{z}/{x}/{y}.png"),
+		XYZZoom, XYZMin, XYZMax, XYZMin, XYZMax,
+		false, true, bDecodeTerrarium, "", ETerrainEncoding::Terrarium
+	);
+}
+
+static bool Fetch(TSharedRef<HMXYZ> Fetcher)
+{
+	return LandscapeCombinatorTests::WaitOnGameThread([Fetcher](TFunction<void(bool)> OnDone)
+	{
+		Fetcher->Fetch("", {}, [Fetcher, OnDone](bool bSuccess) { OnDone(bSuccess); });
+	});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FXYZMosaicTest, "LandscapeCombinator.XYZ.Mosaic",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FXYZMosaicTest::RunTest(const FString& Parameters)
+{
+	FLoopbackScope Scope;
+	if (!TestTrue("Loopback server started", Scope.IsValid())) return false;
+	ServeTiles(Scope);
+
+	TSharedRef<HMXYZ> Fetcher = MakeFetcher(Scope);
+	const double StartTime = FPlatformTime::Seconds();
+	if (!TestTrue("Tiles fetched", Fetch(Fetcher))) return false;
+	const double Duration = FPlatformTime::Seconds() - StartTime;
+
+	const int NumTiles = (XYZMax - XYZMin + 1) * (XYZMax - XYZMin + 1);
+	AddInfo(FString::Printf(TEXT("Fetched and assembled %d tiles in %.2fs (%.1f tiles/s)"), NumTiles, Duration, NumTiles / FMath::Max(Duration, 1e-6)));
+
+	int NumGets = Scope.Server.GetRequests().FilterByPredicate([](const FLoopbackRequest& Request) { return Request.Verb == "GET"; }).Num();
+	TestEqual("One GET request per tile", NumGets, NumTiles);
+	if (!TestEqual("Output files", Fetcher->OutputFiles.Num(), 1)) return false;
+
+	FString Mosaic = Fetcher->OutputFiles[0];
+	TestTrue("Output is a VRT mosaic", Mosaic.EndsWith(".vrt"));
+	TestEqual("Output CRS", Fetcher->OutputCRS, FString("EPSG:3857"));
+
+	FIntPoint Pixels;
+	TestTrue("Pixels read", GDALInterface::GetPixels(Pixels, Mosaic));
+	TestEqual("Pixels", Pixels, FIntPoint(512, 512));
+
+	double MinLong, MaxLong, MinLat, MaxLat;
+	GDALInterface::XYZTileToEPSG3857(XYZMin, XYZMin, XYZZoom, MinLong, MaxLat);
+	GDALInterface::XYZTileToEPSG3857(XYZMax + 1, XYZMax + 1, XYZZoom, MaxLong, MinLat);
+
+	FVector4d Coordinates;
+	TestTrue("Coordinates read", GDALInterface::GetCoordinates(Coordinates, { Mosaic }));
+	TestEqual("MinLong", Coordinates[0], MinLong, 1e-3);
+	TestEqual("MaxLong", Coordinates[1], MaxLong, 1e-3);
+	TestEqual("MinLat", Coordinates[2], MinLat, 1e-3);
+	TestEqual("MaxLat", Coordinates[3], MaxLat, 1e-3);
+
+	// the tiles are placed west to east and north to south
+	for (int X = XYZMin; X <= XYZMax; X++)
+	{
+		for (int Y = XYZMin; Y <= XYZMax; Y++)
+		{
+			TArray<uint8> Pixel = LandscapeCombinatorTests::ReadPixel(Mosaic, 128 + 256 * (X - XYZMin), 128 + 256 * (Y - XYZMin));
+			TestEqual(FString::Printf(TEXT("Color of tile %d/%d"), X, Y), Pixel, TileColor(X, Y));
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FXYZMixedPaletteTest, "LandscapeCombinator.XYZ.MixedPalettedAndRGBTiles",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FXYZMixedPaletteTest::RunTest(const FString& Parameters)
+{
+	FLoopbackScope Scope;
+	if (!TestTrue("Loopback server started", Scope.IsValid())) return false;
+	ServeTiles(Scope, {}, { FIntPoint(XYZMin, XYZMin) });
+
+	TSharedRef<HMXYZ> Fetcher = MakeFetcher(Scope);
+	if (!TestTrue("Tiles fetched", Fetch(Fetcher))) return false;
+	if (!TestEqual("Output files", Fetcher->OutputFiles.Num(), 1)) return false;
+
+	// the paletted tile is expanded to RGBA, and the RGB tiles get an opaque alpha instead of none
+	for (int X = XYZMin; X <= XYZMax; X++)
+	{
+		for (int Y = XYZMin; Y <= XYZMax; Y++)
+		{
+			TArray<uint8> Expected = TileColor(X, Y);
+			Expected.Add(255);
+			TArray<uint8> Pixel = LandscapeCombinatorTests::ReadPixel(Fetcher->OutputFiles[0], 128 + 256 * (X - XYZMin), 128 + 256 * (Y - XYZMin));
+			TestEqual(FString::Printf(TEXT("Color of tile %d/%d"), X, Y), Pixel, Expected);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FXYZTerrariumTest, "LandscapeCombinator.XYZ.TerrariumDecoding",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FXYZTerrariumTest::RunTest(const FString& Parameters)
+{
+	FLoopbackScope Scope;
+	if (!TestTrue("Loopback server started", Scope.IsValid())) return false;
+	ServeTiles(Scope);
+
+	TSharedRef<HMXYZ> Fetcher = MakeFetcher(Scope, true);
+	if (!TestTrue("Tiles fetched", Fetch(Fetcher))) return false;
+	if (!TestEqual("Output files", Fetcher->OutputFiles.Num(), 1)) return false;
+
+	FGDALDatasetHandle Mosaic = FGDALDatasetHandle::Open(Fetcher->OutputFiles[0]);
+	if (!TestTrue("Mosaic opened", (bool) Mosaic)) return false;
+	TestEqual("Bands", Mosaic->GetRasterCount(), 1);
+	TestEqual("Data type", (int) Mosaic->GetRasterBand(1)->GetRasterDataType(), (int) GDT_Float32);
+
+	for (int X = XYZMin; X <= XYZMax; X++)
+	{
+		for (int Y = XYZMin; Y <= XYZMax; Y++)
+		{
+			TArray<uint8> Color = TileColor(X, Y);
+			float Elevation = 0;
+			Mosaic->GetRasterBand(1)->RasterIO(GF_Read, 128 + 256 * (X - XYZMin), 128 + 256 * (Y - XYZMin), 1, 1, &Elevation, 1, 1, GDT_Float32, 0, 0);
+
+			// Terrarium decoding is exact in single precision
+			TestEqual(FString::Printf(TEXT("Elevation of tile %d/%d"), X, Y), Elevation, Color[0] * 256.0f + Color[1] + Color[2] / 256.0f - 32768.0f);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FXYZMissingTileTest, "LandscapeCombinator.XYZ.MissingTileFails",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FXYZMissingTileTest::RunTest(const FString& Parameters)
+{
+	FLoopbackScope Scope;
+	if (!TestTrue("Loopback server started", Scope.IsValid())) return false;
+	ServeTiles(Scope, { FIntPoint(XYZMax, XYZMin) });
+
+	AddExpectedError("Error while downloading|Request was not successful", EAutomationExpectedErrorFlags::Contains, 0);
+
+	TSharedRef<HMXYZ> Fetcher = MakeFetcher(Scope);
+	TestFalse("Fetch failed", Fetch(Fetcher));
+	TestTrue("No mosaic", Fetcher->OutputFiles.IsEmpty());
+
+	return true;
+}
+
+#endif
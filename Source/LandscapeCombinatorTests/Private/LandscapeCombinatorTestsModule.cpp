@@ -0,0 +1,9 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "LandscapeCombinatorTestsModule.h"
+
+#define LOCTEXT_NAMESPACE "FLandscapeCombinatorTestsModule"
+
+IMPLEMENT_MODULE(FLandscapeCombinatorTestsModule, LandscapeCombinatorTests)
+
+#undef LOCTEXT_NAMESPACE
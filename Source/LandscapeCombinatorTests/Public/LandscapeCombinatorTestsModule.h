@@ -0,0 +1,8 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Modules/ModuleManager.h"
+
+class FLandscapeCombinatorTestsModule : public IModuleInterface {};
@@ -0,0 +1,107 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#include "LandscapeUtils/HeightfieldSampler.h"
+#include "LandscapeUtils/LogLandscapeUtils.h"
+
+#include "Async/ParallelFor.h"
+#include "LandscapeDataAccess.h"
+#include "LandscapeEdit.h"
+#include "LandscapeInfo.h"
+
+TSharedPtr<FHeightfieldSampler, ESPMode::ThreadSafe> FHeightfieldSampler::Create(ALandscape* Landscape, FBox2D WorldRegion)
+{
+	check(IsInGameThread());
+
+	ULandscapeInfo* LandscapeInfo = Landscape ? Landscape->GetLandscapeInfo() : nullptr;
+	if (!LandscapeInfo || LandscapeInfo->XYtoComponentMap.IsEmpty()) return nullptr;
+
+	int32 MinX, MinY, MaxX, MaxY;
+	if (!LandscapeInfo->GetLandscapeExtent(MinX, MinY, MaxX, MaxY)) return nullptr;
+
+	TSharedPtr<FHeightfieldSampler, ESPMode::ThreadSafe> Sampler = MakeShared<FHeightfieldSampler, ESPMode::ThreadSafe>();
+	Sampler->LandscapeToWorld = Landscape->LandscapeActorToWorld();
+
+	// the region is extended to the vertices around it, so that its borders can be interpolated
+	if (WorldRegion.bIsValid)
+	{
+		FBox2D LocalRegion(ForceInit);
+		for (const FVector2D& Corner : { WorldRegion.Min, WorldRegion.Max, FVector2D(WorldRegion.Min.X, WorldRegion.Max.Y), FVector2D(WorldRegion.Max.X, WorldRegion.Min.Y) })
+		{
+			FVector Local = Sampler->LandscapeToWorld.InverseTransformPosition(FVector(Corner, 0));
+			LocalRegion += FVector2D(Local.X, Local.Y);
+		}
+		MinX = FMath::Max(MinX, FMath::FloorToInt32(LocalRegion.Min.X));
+		MinY = FMath::Max(MinY, FMath::FloorToInt32(LocalRegion.Min.Y));
+		MaxX = FMath::Min(MaxX, FMath::CeilToInt32(LocalRegion.Max.X));
+		MaxY = FMath::Min(MaxY, FMath::CeilToInt32(LocalRegion.Max.Y));
+	}
+	if (MinX > MaxX || MinY > MaxY) return nullptr;
+
+	Sampler->Min = FIntPoint(MinX, MinY);
+	Sampler->Max = FIntPoint(MaxX, MaxY);
+	Sampler->ComponentSizeQuads = LandscapeInfo->ComponentSizeQuads;
+	for (auto& [ComponentIndex, Component] : LandscapeInfo->XYtoComponentMap)
+	{
+		if (IsValid(Component)) Sampler->LoadedComponents.Add(ComponentIndex);
+	}
+
+	// vertices of components that are not loaded are not written, and are never read either
+	Sampler->Heights.SetNumZeroed((MaxX - MinX + 1) * (MaxY - MinY + 1));
+	FHeightmapAccessor<false> HeightmapAccessor(LandscapeInfo);
+	HeightmapAccessor.GetDataFast(MinX, MinY, MaxX, MaxY, Sampler->Heights.GetData());
+
+	UE_LOG(LogLandscapeUtils, Log, TEXT("Copied %d x %d heights of Landscape %s (%d loaded components)"),
+		MaxX - MinX + 1, MaxY - MinY + 1, *Landscape->GetActorLabel(), Sampler->LoadedComponents.Num()
+	);
+
+	return Sampler;
+}
+
+bool FHeightfieldSampler::GetZ(double X, double Y, double& OutZ) const
+{
+	FVector Local = LandscapeToWorld.InverseTransformPosition(FVector(X, Y, 0));
+	if (!(Local.X >= Min.X && Local.X <= Max.X && Local.Y >= Min.Y && Local.Y <= Max.Y)) return false;
+
+	// the quad containing the location, the last quad for locations on the last vertices
+	const int32 X0 = FMath::Max(Min.X, FMath::Min(FMath::FloorToInt32(Local.X), Max.X - 1));
+	const int32 Y0 = FMath::Max(Min.Y, FMath::Min(FMath::FloorToInt32(Local.Y), Max.Y - 1));
+	const int32 X1 = FMath::Min(X0 + 1, Max.X);
+	const int32 Y1 = FMath::Min(Y0 + 1, Max.Y);
+
+	FIntPoint ComponentIndex(FMath::DivideAndRoundDown(X0, ComponentSizeQuads), FMath::DivideAndRoundDown(Y0, ComponentSizeQuads));
+	if (!LoadedComponents.Contains(ComponentIndex)) return false;
+
+	const int32 Width = Max.X - Min.X + 1;
+	auto HeightAt = [&](int32 PX, int32 PY) { return (double) Heights[(PX - Min.X) + (PY - Min.Y) * Width]; };
+
+	const double AlphaX = Local.X - X0;
+	const double AlphaY = Local.Y - Y0;
+	const double Height = FMath::Lerp(
+		FMath::Lerp(HeightAt(X0, Y0), HeightAt(X1, Y0), AlphaX),
+		FMath::Lerp(HeightAt(X0, Y1), HeightAt(X1, Y1), AlphaX),
+		AlphaY
+	);
+
+	const double LocalZ = (Height - LandscapeDataAccess::MidValue) * LANDSCAPE_ZSCALE;
+	OutZ = LandscapeToWorld.TransformPosition(FVector(Local.X, Local.Y, LocalZ)).Z;
+	return true;
+}
+
+void FHeightfieldSampler::GetZ(TArrayView<const FVector2D> Locations, TArrayView<TOptional<double>> OutZ) const
+{
+	check(Locations.Num() == OutZ.Num());
+
+	const int32 ChunkSize = FMath::Max(1, ParallelBatchSize);
+	const int32 NumChunks = FMath::DivideAndRoundUp(Locations.Num(), ChunkSize);
+
+	ParallelFor(NumChunks, [&](int32 Chunk)
+	{
+		const int32 End = FMath::Min(Locations.Num(), (Chunk + 1) * ChunkSize);
+		for (int32 i = Chunk * ChunkSize; i < End; i++)
+		{
+			double Z;
+			if (GetZ(Locations[i].X, Locations[i].Y, Z)) OutZ[i] = Z;
+			else OutZ[i].Reset();
+		}
+	}, NumChunks <= 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+}
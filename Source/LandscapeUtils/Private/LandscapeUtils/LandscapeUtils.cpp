@@ -2,6 +2,7 @@
 
 #include "LandscapeUtils/LandscapeUtils.h"
 #include "LandscapeUtils/LogLandscapeUtils.h"
+#include "LandscapeUtils/HeightfieldSampler.h"
 
 #include "Internationalization/Regex.h"
 #include "Editor.h"
@@ -308,7 +309,7 @@ FCollisionQueryParams LandscapeUtils::CustomCollisionQueryParams(AActor *Actor)
 	if (Actor->IsA<ALandscape>())
 	{
 		ALandscape *Landscape = Cast<ALandscape>(Actor);
-		TArray<ALandscapeStreamingProxy*> LandscapeStreamingProxies = GetLandscapeStreamingProxies(Landscape);
+		TSet<AActor*> LandscapeStreamingProxies(GetLandscapeStreamingProxies(Landscape));
 		for (auto &SomeActor : Actors)
 		{
 			if (SomeActor != Landscape && !LandscapeStreamingProxies.Contains(SomeActor))
@@ -356,4 +357,32 @@ bool LandscapeUtils::GetZ(UWorld* World, FCollisionQueryParams CollisionQueryPar
 	}
 }
 
+void LandscapeUtils::GetZ(AActor* Actor, FCollisionQueryParams CollisionQueryParams, TArrayView<const FVector2D> Locations, TArray<TOptional<double>> &OutZ)
+{
+	OutZ.Reset();
+	OutZ.SetNum(Locations.Num());
+
+	if (ALandscape* Landscape = Cast<ALandscape>(Actor))
+	{
+		FBox2D Region(ForceInit);
+		for (const FVector2D& Location : Locations) Region += Location;
+
+		TSharedPtr<FHeightfieldSampler, ESPMode::ThreadSafe> Sampler = FHeightfieldSampler::Create(Landscape, Region);
+		if (Sampler) Sampler->GetZ(Locations, OutZ);
+	}
+
+	UWorld* World = Actor->GetWorld();
+	int32 NumTraces = 0;
+	for (int32 i = 0; i < Locations.Num(); i++)
+	{
+		if (OutZ[i].IsSet()) continue;
+
+		double Z;
+		NumTraces++;
+		if (GetZ(World, CollisionQueryParams, Locations[i].X, Locations[i].Y, Z)) OutZ[i] = Z;
+	}
+
+	UE_LOG(LogLandscapeUtils, Log, TEXT("GetZ: %d locations on %s, %d of them with line traces"), Locations.Num(), *Actor->GetActorLabel(), NumTraces);
+}
+
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,37 @@
+// Copyright 2023 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Landscape.h"
+
+// A copy of the heightmap of a landscape (including its streaming proxies), sampled bilinearly in landscape space.
+// Creating it reads the heightmap once, after which each query costs a few multiplications instead of a line trace,
+// and queries can be made from any thread.
+class LANDSCAPEUTILS_API FHeightfieldSampler
+{
+public:
+	// Copies the heightmap of `Landscape` under `WorldRegion`, or all of it when `WorldRegion` is not valid; must be called from the game thread.
+	// Returns nullptr if no heightmap data is loaded there.
+	static TSharedPtr<FHeightfieldSampler, ESPMode::ThreadSafe> Create(ALandscape* Landscape, FBox2D WorldRegion = FBox2D(ForceInit));
+
+	// World height of the landscape at the world location (X, Y), or false outside of the copied region and on components that were not loaded
+	bool GetZ(double X, double Y, double& OutZ) const;
+
+	// Same for many locations, in parallel for large arrays; `OutZ` is left unset for the locations without height
+	void GetZ(TArrayView<const FVector2D> Locations, TArrayView<TOptional<double>> OutZ) const;
+
+	static inline int32 ParallelBatchSize = 4096;
+
+private:
+	FTransform LandscapeToWorld;
+
+	// Vertices of the copy, inclusive, in landscape space
+	FIntPoint Min;
+	FIntPoint Max;
+	TArray<uint16> Heights;
+
+	// Components that were loaded when the copy was made, by component index
+	int32 ComponentSizeQuads = 0;
+	TSet<FIntPoint> LoadedComponents;
+};
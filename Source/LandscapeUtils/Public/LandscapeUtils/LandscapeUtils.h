@@ -22,4 +22,8 @@ public:
 	static ALandscape* GetLandscapeFromLabel(FString LandscapeLabel);
 	static FCollisionQueryParams CustomCollisionQueryParams(AActor* Actor);
 	static bool GetZ(UWorld* World, FCollisionQueryParams CollisionQueryParams, double x, double y, double &OutZ);
+
+	// Heights of `Actor` at many locations: sampled from the heightmap when `Actor` is a landscape, and found with line traces
+	// (using `CollisionQueryParams`) for other actors and where the heightmap data is not loaded; `OutZ` is unset where nothing was hit
+	static void GetZ(AActor* Actor, FCollisionQueryParams CollisionQueryParams, TArrayView<const FVector2D> Locations, TArray<TOptional<double>> &OutZ);
 };
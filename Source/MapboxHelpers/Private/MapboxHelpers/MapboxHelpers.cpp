@@ -2,444 +2,297 @@
 
 #include "MapboxHelpers/MapboxHelpers.h"
 #include "MapboxHelpers/LogMapboxHelpers.h"
-#include "GDALInterface/GDALInterface.h"
+#include "GDALInterface/DatasetPool.h"
+#include "GDALInterface/RasterBlocks.h"
+
+#include "Async/Async.h"
+#include "Math/RandomStream.h"
+#include "Math/UnrealMathVectorCommon.h"
+#include "Misc/MessageDialog.h"
 
 #define LOCTEXT_NAMESPACE "FMapboxHelpersModule"
 
-bool MapboxHelpers::DecodeMapboxOneBand(FString InputFile, FString OutputFile, bool *bShowedDialog)
+static void ShowErrorOnce(bool *bShowedDialog, const FText& Message)
 {
-	/* Read the RGB bands from `InputFile` */
+	UE_LOG(LogMapboxHelpers, Error, TEXT("%s"), *Message.ToString());
 
-	GDALDataset *Dataset = (GDALDataset *) GDALOpen(TCHAR_TO_UTF8(*InputFile), GA_ReadOnly);
+	if (*bShowedDialog) return;
+	*bShowedDialog = true;
 
-	if (!Dataset)
+	// tiles are decoded from download callbacks, which may run outside of the game thread
+	if (IsInGameThread())
 	{
-		if (!*bShowedDialog)
-		{
-			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
-				LOCTEXT("MapboxHelpers::6", "Could not read file {0} using GDAL."),
-				FText::FromString(OutputFile)
-			));
-			*bShowedDialog = true;
-		}
-		return false;
+		FMessageDialog::Open(EAppMsgType::Ok, Message);
 	}
-
-
-	if (Dataset->GetRasterCount() != 1)
+	else
 	{
-		if (!*bShowedDialog)
-		{
-			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
-				LOCTEXT("MapboxHelpers::0", "Expected one band from Mapbox heightmap {0}, but got {1} instead."),
-				FText::FromString(InputFile),
-				FText::AsNumber(Dataset->GetRasterCount())
-			));
-			*bShowedDialog = true;
-		}
-		return false;
+		AsyncTask(ENamedThreads::GameThread, [Message]() { FMessageDialog::Open(EAppMsgType::Ok, Message); });
 	}
+}
 
+bool MapboxHelpers::DecodeMapboxOneBand(FString InputFile, FString OutputFile, bool *bShowedDialog)
+{
+	return DecodeTerrainRGB(InputFile, OutputFile, ETerrainEncoding::Mapbox, bShowedDialog);
+}
 
-	GDALColorTable* ColorTable = Dataset->GetRasterBand(1)->GetColorTable();
-    if (!ColorTable)
-	{
-		if (!*bShowedDialog)
-		{
-			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
-				LOCTEXT("MapboxHelpers::00", "Expected to have a Color Table in the Mapbox heightmap {0}."),
-				FText::FromString(InputFile)
-			));
-			*bShowedDialog = true;
-		}
-        GDALClose(Dataset);
-        return false;
-    }
-
-	
-	int SizeX = Dataset->GetRasterXSize();
-	int SizeY = Dataset->GetRasterYSize();
-	
-	uint8* CodeBand = (uint8*) malloc(SizeX * SizeY * (sizeof uint8));
+bool MapboxHelpers::DecodeMapboxThreeBands(FString InputFile, FString OutputFile, bool *bShowedDialog)
+{
+	return DecodeTerrainRGB(InputFile, OutputFile, ETerrainEncoding::Mapbox, bShowedDialog);
+}
 
-	if (!CodeBand)
+float MapboxHelpers::DecodePixel(ETerrainEncoding Encoding, uint8 Red, uint8 Green, uint8 Blue)
+{
+	if (Encoding == ETerrainEncoding::Terrarium)
 	{
-		if (!*bShowedDialog)
-		{
-			FMessageDialog::Open(EAppMsgType::Ok,
-				LOCTEXT("MapboxHelpers::7", "Not enough memory to allocate for decoding mapbox data.")
-			);
-			*bShowedDialog = true;
-		}
-		GDALClose(Dataset);
-		if (CodeBand) free(CodeBand);
-		return false;
+		// exact in single precision
+		return Red * 256.0f + Green + Blue / 256.0f - 32768.0f;
 	}
-
-	
-	CPLErr ReadErr = Dataset->GetRasterBand(1)->RasterIO(GF_Read, 0, 0, SizeX, SizeY, CodeBand, SizeX, SizeY, GDT_Byte, 0, 0);
-
-	if (ReadErr != CE_None)
+	else
 	{
-		if (!*bShowedDialog)
-		{
-			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
-				LOCTEXT("MapboxHelpers::7", "There was an error while reading heightmap data from file {0}."),
-				FText::FromString(OutputFile)
-			));
-			*bShowedDialog = true;
-		}
-		free(CodeBand);
-		GDALClose(Dataset);
-		return false;
+		// the 24-bit code is exact in single precision, but not its product with 0.1: below 9000 meters,
+		// the decoded elevation is within 2 millimeters of the exact one, for an encoding precision of 10 centimeters
+		return (Red * 65536.0f + Green * 256.0f + Blue) * 0.1f - 10000.0f;
 	}
-	
+}
 
+void MapboxHelpers::DecodeRow(ETerrainEncoding Encoding, const uint8* Red, const uint8* Green, const uint8* Blue, float* Elevations, int32 Count)
+{
+	const bool bTerrarium = Encoding == ETerrainEncoding::Terrarium;
+	const VectorRegister4Float RedScale = VectorSetFloat1(bTerrarium ? 256.0f : 65536.0f);
+	const VectorRegister4Float GreenScale = VectorSetFloat1(bTerrarium ? 1.0f : 256.0f);
+	const VectorRegister4Float BlueScale = VectorSetFloat1(bTerrarium ? 1.0f / 256 : 1.0f);
+	const VectorRegister4Float Scale = VectorSetFloat1(bTerrarium ? 1.0f : 0.1f);
+	const VectorRegister4Float Offset = VectorSetFloat1(bTerrarium ? -32768.0f : -10000.0f);
+
+	int32 i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		VectorRegister4Float Code = VectorMultiply(VectorLoadByte4(Red + i), RedScale);
+		Code = VectorMultiplyAdd(VectorLoadByte4(Green + i), GreenScale, Code);
+		Code = VectorMultiplyAdd(VectorLoadByte4(Blue + i), BlueScale, Code);
+		VectorStore(VectorMultiplyAdd(Code, Scale, Offset), Elevations + i);
+	}
 
-	/* Prepare GDAL Drivers */
+	for (; i < Count; i++)
+	{
+		Elevations[i] = DecodePixel(Encoding, Red[i], Green[i], Blue[i]);
+	}
+}
 
-	GDALDriver *MEMDriver = GetGDALDriverManager()->GetDriverByName("MEM");
-	GDALDriver *TIFDriver = GetGDALDriverManager()->GetDriverByName("GTiff");
+bool MapboxHelpers::DecodeTerrainRGB(FString InputFile, FString OutputFile, ETerrainEncoding Encoding, bool *bShowedDialog)
+{
+	FGDALDatasetHandle Dataset = FGDALDatasetHandle::Open(InputFile);
 
-	if (!TIFDriver || !MEMDriver)
+	if (!Dataset)
 	{
-		if (!*bShowedDialog)
-		{
-			FMessageDialog::Open(EAppMsgType::Ok,
-				LOCTEXT("MapboxHelpers::3", "Could not load GDAL drivers.")
-			);
-			*bShowedDialog = true;
-			GDALClose(Dataset);
-		}
-		free(CodeBand);
+		ShowErrorOnce(bShowedDialog, FText::Format(
+			LOCTEXT("MapboxHelpers::6", "Could not read file {0} using GDAL."),
+			FText::FromString(InputFile)
+		));
 		return false;
 	}
-	
 
+	const int SizeX = Dataset->GetRasterXSize();
+	const int SizeY = Dataset->GetRasterYSize();
+	const int NumBands = Dataset->GetRasterCount();
 
-	/* Decode and write the HeightmapData to `OutputFile` */
+	/* Paletted tiles are decoded through a lookup table indexed by the palette entry */
 
-	float* HeightmapData = (float*) malloc(SizeX * SizeY * sizeof(float));
+	GDALColorTable* ColorTable = NumBands >= 1 ? Dataset->GetRasterBand(1)->GetColorTable() : nullptr;
+	TArray<uint8> PaletteRed, PaletteGreen, PaletteBlue;
 
-	if (!HeightmapData)
+	if (NumBands < 3)
 	{
-		if (!*bShowedDialog)
+		if (NumBands != 1 || !ColorTable)
 		{
-			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
-				LOCTEXT("MapboxHelpers::12", "Not enough memory to allocate for decoding mapbox data."),
-				FText::FromString(OutputFile)
+			ShowErrorOnce(bShowedDialog, FText::Format(
+				LOCTEXT("MapboxHelpers::0", "Expected three bands or one band with a color table from terrain heightmap {0}, but got {1} bands instead."),
+				FText::FromString(InputFile),
+				FText::AsNumber(NumBands)
 			));
-			*bShowedDialog = true;
+			return false;
 		}
-		free(CodeBand);
-		return false;
-	}
-
 
-	for (int X = 0; X < SizeX; X++)
-	{
-		for (int Y = 0; Y < SizeY; Y++)
+		for (int Index = 0; Index < ColorTable->GetColorEntryCount(); Index++)
 		{
-			int i = X + Y * SizeX;
-			const GDALColorEntry *ColorEntry = ColorTable->GetColorEntry(CodeBand[i]);
-			if (!ColorEntry)
-			{
-				if (!*bShowedDialog)
-				{
-					FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
-						LOCTEXT("MapboxHelpers::12", "No Color Entry for X = {0}, Y = {1}, Index = {2}, i = {3}, ColorTable Entry Count: {4}"),
-						FText::AsNumber(X),
-						FText::AsNumber(Y),
-						FText::AsNumber(CodeBand[i]),
-						FText::AsNumber(i),
-						FText::AsNumber(ColorTable->GetColorEntryCount())
-					));
-					*bShowedDialog = true;
-				}
-				free(CodeBand);
-				GDALClose(Dataset);
-				return false;
-			}
-			float R = ColorEntry->c1;
-			float G = ColorEntry->c2;
-			float B = ColorEntry->c3;
-			HeightmapData[i] = -10000 + ((R * 256 * 256 + G * 256 + B) * 0.1);
+			const GDALColorEntry* ColorEntry = ColorTable->GetColorEntry(Index);
+			PaletteRed.Add(ColorEntry->c1);
+			PaletteGreen.Add(ColorEntry->c2);
+			PaletteBlue.Add(ColorEntry->c3);
 		}
 	}
-	free(CodeBand);
-	GDALClose(Dataset);
-	
 
+	/* Create the output directly, without an in-memory copy of the whole raster */
 
-	GDALDataset *NewDataset = MEMDriver->Create(
-		"",
-		SizeX, SizeY,
-		1, // nBands
-		GDT_Float32,
-		nullptr
-	);
-	
-
-	if (!NewDataset)
-	{
-		if (!*bShowedDialog)
-		{
-			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
-				LOCTEXT("MapboxHelpers::4", "There was an error while creating a GDAL Dataset."),
-				FText::FromString(InputFile)
-			));
-			*bShowedDialog = true;
-		}
-		free(HeightmapData);
-		return false;
-	}
-	CPLErr WriteErr = NewDataset->GetRasterBand(1)->RasterIO(GF_Write, 0, 0, SizeX, SizeY, HeightmapData, SizeX, SizeY, GDT_Float32, 0, 0);
-
+	GDALDriver *TIFDriver = GetGDALDriverManager()->GetDriverByName("GTiff");
 
-	if (WriteErr != CE_None)
+	if (!TIFDriver)
 	{
-		if (!*bShowedDialog)
-		{
-			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
-				LOCTEXT("MapboxHelpers::5", "There was an error while writing heightmap data to file {0}. (Error: {1})"),
-				FText::FromString(OutputFile),
-				FText::AsNumber(WriteErr, &FNumberFormattingOptions::DefaultNoGrouping())
-			));
-			*bShowedDialog = true;
-		}
-		GDALClose(NewDataset);
-		free(HeightmapData);
+		ShowErrorOnce(bShowedDialog, LOCTEXT("MapboxHelpers::3", "Could not load GDAL drivers."));
 		return false;
 	}
 
+	DatasetPool::Invalidate(OutputFile);
 
-	GDALDataset *TIFDataset = TIFDriver->CreateCopy(TCHAR_TO_UTF8(*OutputFile), NewDataset, 1, nullptr, nullptr, nullptr);
-	GDALClose(NewDataset);
+	char** Options = nullptr;
+	Options = CSLSetNameValue(Options, "TILED", "YES");
+	FGDALDatasetHandle NewDataset(TIFDriver->Create(TCHAR_TO_UTF8(*OutputFile), SizeX, SizeY, 1, GDT_Float32, Options));
+	CSLDestroy(Options);
 
-	if (!TIFDataset)
+	if (!NewDataset)
 	{
-		if (!*bShowedDialog)
-		{
-			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
-				LOCTEXT("MapboxHelpers::5", "Could not write heightmap to file {0}."),
-				FText::FromString(OutputFile),
-				FText::AsNumber(WriteErr, &FNumberFormattingOptions::DefaultNoGrouping())
-			));
-			*bShowedDialog = true;
-		}
-		free(HeightmapData);
+		ShowErrorOnce(bShowedDialog, FText::Format(
+			LOCTEXT("MapboxHelpers::4", "Could not create heightmap file {0}.\n{1}"),
+			FText::FromString(OutputFile),
+			FText::FromString(FString(CPLGetLastErrorMsg()))
+		));
 		return false;
 	}
 
-	
-	GDALClose(TIFDataset);
+	double GeoTransform[6];
+	if (Dataset->GetGeoTransform(GeoTransform) == CE_None) NewDataset->SetGeoTransform(GeoTransform);
+	if (Dataset->GetSpatialRef()) NewDataset->SetSpatialRef(Dataset->GetSpatialRef());
 
-	return true;
-}
+	/* Decode strip by strip, row by row */
 
-bool MapboxHelpers::DecodeMapboxThreeBands(FString InputFile, FString OutputFile, bool *bShowedDialog)
-{
-	/* Read the RGB bands from `InputFile` */
+	const int StripRows = FMath::Clamp(RowsPerStrip, 1, FMath::Max(1, SizeY));
+	const int64 StripPixels = (int64) SizeX * StripRows;
 
-	GDALDataset *Dataset = (GDALDataset *) GDALOpen(TCHAR_TO_UTF8(*InputFile), GA_ReadOnly);
+	TArray<uint8> Red, Green, Blue;
+	TArray<float> Elevations;
+	Red.SetNumUninitialized(StripPixels);
+	Green.SetNumUninitialized(StripPixels);
+	Blue.SetNumUninitialized(StripPixels);
+	Elevations.SetNumUninitialized(StripPixels);
 
-	if (!Dataset)
+	for (int Y0 = 0; Y0 < SizeY; Y0 += StripRows)
 	{
-		if (!*bShowedDialog)
-		{
-			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
-				LOCTEXT("MapboxHelpers::6", "Could not read file {0} using GDAL."),
-				FText::FromString(OutputFile)
-			));
-			*bShowedDialog = true;
-		}
-		return false;
-	}
+		const int Rows = FMath::Min(StripRows, SizeY - Y0);
+		const int64 Pixels = (int64) SizeX * Rows;
 
-	if (Dataset->GetRasterCount() < 3)
-	{
-		if (!*bShowedDialog)
+		if (ColorTable)
 		{
-			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
-				LOCTEXT("MapboxHelpers::0", "Expected at least three bands from Mapbox heightmap {0}, but got {1} instead."),
-				FText::FromString(InputFile),
-				FText::AsNumber(Dataset->GetRasterCount())
-			));
-			*bShowedDialog = true;
+			if (Dataset->GetRasterBand(1)->RasterIO(GF_Read, 0, Y0, SizeX, Rows, Red.GetData(), SizeX, Rows, GDT_Byte, 0, 0) != CE_None)
+			{
+				ShowErrorOnce(bShowedDialog, FText::Format(
+					LOCTEXT("MapboxHelpers::7", "There was an error while reading heightmap data from file {0}."),
+					FText::FromString(InputFile)
+				));
+				return false;
+			}
+
+			for (int64 i = 0; i < Pixels; i++)
+			{
+				const uint8 Index = Red[i];
+				if (Index >= PaletteRed.Num())
+				{
+					ShowErrorOnce(bShowedDialog, FText::Format(
+						LOCTEXT("MapboxHelpers::12", "No Color Entry for X = {0}, Y = {1}, Index = {2}, ColorTable Entry Count: {3}"),
+						FText::AsNumber(i % SizeX),
+						FText::AsNumber(Y0 + i / SizeX),
+						FText::AsNumber(Index),
+						FText::AsNumber(PaletteRed.Num())
+					));
+					return false;
+				}
+				Red[i] = PaletteRed[Index];
+				Green[i] = PaletteGreen[Index];
+				Blue[i] = PaletteBlue[Index];
+			}
 		}
-		return false;
-	}
-	
-	int SizeX = Dataset->GetRasterXSize();
-	int SizeY = Dataset->GetRasterYSize();
-	
-	uint8* RedBand = (uint8*) malloc(SizeX * SizeY * (sizeof uint8));
-	uint8* GreenBand = (uint8*) malloc(SizeX * SizeY * (sizeof uint8));
-	uint8* BlueBand = (uint8*) malloc(SizeX * SizeY * (sizeof uint8));
-
-	if (!RedBand || !GreenBand || !BlueBand)
-	{
-		if (!*bShowedDialog)
+		else
 		{
-			FMessageDialog::Open(EAppMsgType::Ok,
-				LOCTEXT("MapboxHelpers::7", "Not enough memory to allocate for decoding mapbox data.")
-			);
-			*bShowedDialog = true;
-		}
-		GDALClose(Dataset);
-		if (RedBand) free(RedBand);
-		if (GreenBand) free(GreenBand);
-		if (BlueBand) free(BlueBand);
-		return false;
-	}
-	
-	CPLErr ReadErr1 = Dataset->GetRasterBand(1)->RasterIO(GF_Read, 0, 0, SizeX, SizeY, RedBand, SizeX, SizeY, GDT_Byte, 0, 0);
-	CPLErr ReadErr2 = Dataset->GetRasterBand(2)->RasterIO(GF_Read, 0, 0, SizeX, SizeY, GreenBand, SizeX, SizeY, GDT_Byte, 0, 0);
-	CPLErr ReadErr3 = Dataset->GetRasterBand(3)->RasterIO(GF_Read, 0, 0, SizeX, SizeY, BlueBand, SizeX, SizeY, GDT_Byte, 0, 0);
+			uint8* Planes[3] = { Red.GetData(), Green.GetData(), Blue.GetData() };
+			CPLErr ReadErr = CE_None;
+			for (int Band = 0; Band < 3 && ReadErr == CE_None; Band++)
+			{
+				ReadErr = Dataset->GetRasterBand(Band + 1)->RasterIO(GF_Read, 0, Y0, SizeX, Rows, Planes[Band], SizeX, Rows, GDT_Byte, 0, 0);
+			}
 
-	if (ReadErr1 != CE_None || ReadErr2 != CE_None || ReadErr3 != CE_None)
-	{
-		if (!*bShowedDialog)
-		{
-			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
-				LOCTEXT("MapboxHelpers::7", "There was an error while reading heightmap data from file {0}."),
-				FText::FromString(OutputFile)
-			));
-			*bShowedDialog = true;
+			if (ReadErr != CE_None)
+			{
+				ShowErrorOnce(bShowedDialog, FText::Format(
+					LOCTEXT("MapboxHelpers::7", "There was an error while reading heightmap data from file {0}."),
+					FText::FromString(InputFile)
+				));
+				return false;
+			}
 		}
-		free(RedBand);
-		free(GreenBand);
-		free(BlueBand);
-		GDALClose(Dataset);
-		return false;
-	}
-	
-
 
-	/* Prepare GDAL Drivers */
-
-	GDALDriver *MEMDriver = GetGDALDriverManager()->GetDriverByName("MEM");
-	GDALDriver *TIFDriver = GetGDALDriverManager()->GetDriverByName("GTiff");
-
-	if (!TIFDriver || !MEMDriver)
-	{
-		if (!*bShowedDialog)
+		for (int Row = 0; Row < Rows; Row++)
 		{
-			FMessageDialog::Open(EAppMsgType::Ok,
-				LOCTEXT("MapboxHelpers::3", "Could not load GDAL drivers.")
-			);
-			*bShowedDialog = true;
-			GDALClose(Dataset);
+			const int64 Start = (int64) Row * SizeX;
+			DecodeRow(Encoding, Red.GetData() + Start, Green.GetData() + Start, Blue.GetData() + Start, Elevations.GetData() + Start, SizeX);
 		}
-		free(RedBand);
-		free(GreenBand);
-		free(BlueBand);
-		return false;
-	}
-	
-
 
-	/* Decode and write the HeightmapData to `OutputFile` */
+		CPLErr WriteErr = NewDataset->GetRasterBand(1)->RasterIO(GF_Write, 0, Y0, SizeX, Rows, Elevations.GetData(), SizeX, Rows, GDT_Float32, 0, 0);
 
-	float* HeightmapData = (float*) malloc(SizeX * SizeY * sizeof(float));
-
-	if (!HeightmapData)
-	{
-		if (!*bShowedDialog)
+		if (WriteErr != CE_None)
 		{
-			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
-				LOCTEXT("MapboxHelpers::12", "Not enough memory to allocate for decoding mapbox data."),
-				FText::FromString(OutputFile)
+			ShowErrorOnce(bShowedDialog, FText::Format(
+				LOCTEXT("MapboxHelpers::5", "There was an error while writing heightmap data to file {0}. (Error: {1})"),
+				FText::FromString(OutputFile),
+				FText::AsNumber(WriteErr, &FNumberFormattingOptions::DefaultNoGrouping())
 			));
-			*bShowedDialog = true;
+			return false;
 		}
-		free(RedBand);
-		free(GreenBand);
-		free(BlueBand);
-		return false;
 	}
 
+	return true;
+}
 
-	for (int X = 0; X < SizeX; X++)
+void MapboxHelpers::Benchmark(int32 Size, int32 Iterations)
+{
+	const int64 NumPixels = (int64) Size * Size;
+	TArray<uint8> Red, Green, Blue;
+	TArray<float> Elevations;
+	Red.SetNumUninitialized(NumPixels);
+	Green.SetNumUninitialized(NumPixels);
+	Blue.SetNumUninitialized(NumPixels);
+	Elevations.SetNumUninitialized(NumPixels);
+
+	FRandomStream Random(0);
+	for (int64 i = 0; i < NumPixels; i++)
 	{
-		for (int Y = 0; Y < SizeY; Y++)
-		{
-			int i = X + Y * SizeX;
-			float R = RedBand[i];
-			float G = GreenBand[i];
-			float B = BlueBand[i];
-			HeightmapData[i] = -10000 + ((R * 256 * 256 + G * 256 + B) * 0.1);
-		}
+		Red[i] = Random.RandHelper(256);
+		Green[i] = Random.RandHelper(256);
+		Blue[i] = Random.RandHelper(256);
 	}
-	free(RedBand);
-	free(GreenBand);
-	free(BlueBand);
-	GDALClose(Dataset);
-	
-
-
-	GDALDataset *NewDataset = MEMDriver->Create(
-		"",
-		SizeX, SizeY,
-		1, // nBands
-		GDT_Float32,
-		nullptr
-	);
-	
 
-	if (!NewDataset)
+	double Start = FPlatformTime::Seconds();
+	for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
 	{
-		if (!*bShowedDialog)
+		// the decoding loop used before DecodeRow
+		for (int X = 0; X < Size; X++)
 		{
-			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
-				LOCTEXT("MapboxHelpers::4", "There was an error while creating a GDAL Dataset."),
-				FText::FromString(InputFile)
-			));
-			*bShowedDialog = true;
+			for (int Y = 0; Y < Size; Y++)
+			{
+				int64 i = X + (int64) Y * Size;
+				float R = Red[i];
+				float G = Green[i];
+				float B = Blue[i];
+				Elevations[i] = -10000 + ((R * 256 * 256 + G * 256 + B) * 0.1);
+			}
 		}
-		free(HeightmapData);
-		return false;
 	}
-	CPLErr WriteErr = NewDataset->GetRasterBand(1)->RasterIO(GF_Write, 0, 0, SizeX, SizeY, HeightmapData, SizeX, SizeY, GDT_Float32, 0, 0);
-
+	const double ColumnMajorSeconds = (FPlatformTime::Seconds() - Start) / Iterations;
+	const float Checksum = Elevations[NumPixels / 2];
 
-	if (WriteErr != CE_None)
+	Start = FPlatformTime::Seconds();
+	for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
 	{
-		if (!*bShowedDialog)
+		for (int Y = 0; Y < Size; Y++)
 		{
-			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
-				LOCTEXT("MapboxHelpers::5", "There was an error while writing heightmap data to file {0}. (Error: {1})"),
-				FText::FromString(OutputFile),
-				FText::AsNumber(WriteErr, &FNumberFormattingOptions::DefaultNoGrouping())
-			));
-			*bShowedDialog = true;
+			const int64 RowStart = (int64) Y * Size;
+			DecodeRow(ETerrainEncoding::Mapbox, Red.GetData() + RowStart, Green.GetData() + RowStart, Blue.GetData() + RowStart, Elevations.GetData() + RowStart, Size);
 		}
-		GDALClose(NewDataset);
-		free(HeightmapData);
-		return false;
 	}
+	const double RowSeconds = (FPlatformTime::Seconds() - Start) / Iterations;
 
-
-	GDALDataset *TIFDataset = TIFDriver->CreateCopy(TCHAR_TO_UTF8(*OutputFile), NewDataset, 1, nullptr, nullptr, nullptr);
-	GDALClose(NewDataset);
-
-	if (!TIFDataset)
-	{
-		if (!*bShowedDialog)
-		{
-			FMessageDialog::Open(EAppMsgType::Ok, FText::Format(
-				LOCTEXT("MapboxHelpers::5", "Could not write heightmap to file {0}."),
-				FText::FromString(OutputFile),
-				FText::AsNumber(WriteErr, &FNumberFormattingOptions::DefaultNoGrouping())
-			));
-			*bShowedDialog = true;
-		}
-		free(HeightmapData);
-		return false;
-	}
-	
-	GDALClose(TIFDataset);
-	return true;
+	UE_LOG(LogMapboxHelpers, Log, TEXT("Decoding a %dx%d tile: %.2f ms per-pixel column-major, %.2f ms DecodeRow (x%.1f), difference at the center %f"),
+		Size, Size, ColumnMajorSeconds * 1000, RowSeconds * 1000, RowSeconds > 0 ? ColumnMajorSeconds / RowSeconds : 0,
+		FMath::Abs(Checksum - Elevations[NumPixels / 2])
+	);
 }
 
-#undef LOCTEXT_NAMESPACE
\ No newline at end of file
+#undef LOCTEXT_NAMESPACE
@@ -4,9 +4,32 @@
 
 #include "CoreMinimal.h"
 
+// How elevations are stored in the red, green and blue channels of terrain tiles
+enum class ETerrainEncoding : uint8
+{
+	// -10000 + (R * 256 * 256 + G * 256 + B) * 0.1
+	Mapbox,
+
+	// (R * 256 + G + B / 256) - 32768
+	Terrarium
+};
+
 class MAPBOXHELPERS_API MapboxHelpers
 {
 public:
 	static bool DecodeMapboxOneBand(FString InputFile, FString OutputFile, bool *bShowedDialog);
 	static bool DecodeMapboxThreeBands(FString InputFile, FString OutputFile, bool *bShowedDialog);
+
+	// Decodes an RGB or paletted terrain tile into a single-band Float32 GeoTIFF, a few rows at a time
+	static bool DecodeTerrainRGB(FString InputFile, FString OutputFile, ETerrainEncoding Encoding, bool *bShowedDialog);
+
+	// Decodes `Count` contiguous pixels, four at a time with SSE or NEON when available
+	static void DecodeRow(ETerrainEncoding Encoding, const uint8* Red, const uint8* Green, const uint8* Blue, float* Elevations, int32 Count);
+	static float DecodePixel(ETerrainEncoding Encoding, uint8 Red, uint8 Green, uint8 Blue);
+
+	// Logs the time taken by DecodeRow and by the former per-pixel, column-major loop on a random Size x Size tile
+	static void Benchmark(int32 Size = 4096, int32 Iterations = 10);
+
+	// Number of rows decoded between two writes to the output file
+	static inline int32 RowsPerStrip = 256;
 };
@@ -5,6 +5,7 @@
 #include "SplineImporter/Overpass.h"
 #include "FileDownloader/Download.h"
 #include "Coordinates/LevelCoordinates.h"
+#include "Coordinates/CoordinatesSubsystem.h"
 
 #include "PCGContext.h"
 #include "PCGCustomVersion.h"
@@ -187,17 +188,32 @@ bool FPCGOGRFilterElement::ExecuteInternal(FPCGContext* Context) const
 		TSet<FVector2D> InsideLocations;
 		OGRMultiPoint *AllPoints = (OGRMultiPoint*) OGRGeometryFactory::createGeometry(OGRwkbGeometryType::wkbMultiPoint);
 
+		// all the points are converted in one call
+		TArray<FVector2D> AllCoordinates4326;
+		AllCoordinates4326.Reserve(PCGPoints.Num());
 		for (const FPCGPoint& PCGPoint : PCGPoints)
 		{
 			const FVector& Location0 = PCGPoint.Transform.GetLocation();
-			const FVector2D& Location = { Location0.X, Location0.Y };
-			FVector2D Coordinates4326;
+			AllCoordinates4326.Add({ Location0.X, Location0.Y });
+		}
 
-			if (!ALevelCoordinates::GetCRSCoordinatesFromUnrealLocation(Context->SourceComponent->GetWorld(), Location, "EPSG:4326", Coordinates4326))
-			{
-				PCGE_LOG_C(Error, GraphAndLog, Context, LOCTEXT("NoData", "Unable to convert coordinates, make sure that you have a LevelCoordinates actor in your level"));
-				return false;
-			}
+		// PCG elements can run outside of the game thread, so they use a copy of the coordinates parameters
+		UCoordinatesSubsystem* CoordinatesSubsystem = Context->SourceComponent->GetWorld()->GetSubsystem<UCoordinatesSubsystem>();
+		FGlobalCoordinatesSnapshot CoordinatesSnapshot;
+		if (
+			!CoordinatesSubsystem ||
+			!CoordinatesSubsystem->GetSnapshot(CoordinatesSnapshot) ||
+			!CoordinatesSnapshot.GetCRSCoordinatesFromUnrealLocations(AllCoordinates4326, "EPSG:4326")
+		)
+		{
+			PCGE_LOG_C(Error, GraphAndLog, Context, LOCTEXT("NoData", "Unable to convert coordinates, make sure that you have a LevelCoordinates actor in your level"));
+			return false;
+		}
+
+		for (int32 i = 0; i < PCGPoints.Num(); i++)
+		{
+			const FVector& Location0 = PCGPoints[i].Transform.GetLocation();
+			const FVector2D& Coordinates4326 = AllCoordinates4326[i];
 			OGRPoint Point4326(Coordinates4326[0], Coordinates4326[1]);
 
 			PCGPointToPoint.Add(Location0, Coordinates4326);
@@ -168,11 +168,14 @@ void ASplineImporter::GenerateSplines()
 		);
 	}
 	
-	EAppReturnType::Type UserResponse = FMessageDialog::Open(EAppMsgType::OkCancel, IntroMessage);
-	if (UserResponse == EAppReturnType::Cancel) 
+	if (!IsRunningCommandlet())
 	{
-		UE_LOG(LogSplineImporter, Log, TEXT("User cancelled adding landscape splines."));
-		return;
+		EAppReturnType::Type UserResponse = FMessageDialog::Open(EAppMsgType::OkCancel, IntroMessage);
+		if (UserResponse == EAppReturnType::Cancel) 
+		{
+			UE_LOG(LogSplineImporter, Log, TEXT("User cancelled adding landscape splines."));
+			return;
+		}
 	}
 
 	// Delete existing spline collections before generating new ones
@@ -200,23 +203,46 @@ void ASplineImporter::GenerateSplines()
 				return;
 			}
 
-			OGRCoordinateTransformation *OGRTransform = GlobalCoordinates->GetCRSTransformer("EPSG:4326");
+			// the points of all the lines are converted in one call
+			TArray<FVector2D> Locations;
+			for (FPointList& PointList : PointLists)
+			{
+				for (OGRPoint& Point : PointList.Points)
+				{
+					Locations.Add({ Point.getX(), Point.getY() });
+				}
+			}
 
-			if (!OGRTransform)
+			if (!GlobalCoordinates->GetUnrealCoordinatesFromCRS(Locations, "EPSG:4326"))
 			{
-				FMessageDialog::Open(EAppMsgType::Ok,
-					LOCTEXT("LandscapeNotFound", "Landscape Combinator Error: Could not create OGR Coordinate Transformation.")
-				);
 				return;
 			}
 
+			// the heights are sampled from the heightmap when placing on a landscape, with line traces only as a fallback
+			TArray<TOptional<double>> Heights;
+			LandscapeUtils::GetZ(ActorOrLandscapeToPlaceSplines, CollisionQueryParams, Locations, Heights);
+
+			TArray<TOptional<FVector>> WorldLocations;
+			WorldLocations.SetNum(Locations.Num());
+			for (int32 i = 0; i < Locations.Num(); i++)
+			{
+				if (Heights[i].IsSet())
+				{
+					WorldLocations[i] = FVector(Locations[i], Heights[i].GetValue()) + SplinePointsOffset;
+				}
+				else
+				{
+					UE_LOG(LogSplineImporter, Warning, TEXT("No collision for point %f, %f"), Locations[i].X, Locations[i].Y);
+				}
+			}
+
 			if (bUseLandscapeSplines)
 			{
-				GenerateLandscapeSplines(Landscape, CollisionQueryParams, OGRTransform, GlobalCoordinates, PointLists);
+				GenerateLandscapeSplines(Landscape, PointLists, WorldLocations);
 			}
 			else
 			{
-				GenerateRegularSplines(ActorOrLandscapeToPlaceSplines, CollisionQueryParams, OGRTransform, GlobalCoordinates, PointLists);
+				GenerateRegularSplines(ActorOrLandscapeToPlaceSplines, PointLists, WorldLocations);
 			}
 		}
 	});
@@ -355,10 +381,8 @@ void ASplineImporter::LoadGDALDataset(TFunction<void(GDALDataset*)> OnComplete)
 
 void ASplineImporter::GenerateLandscapeSplines(
 	ALandscape *Landscape,
-	FCollisionQueryParams CollisionQueryParams,
-	OGRCoordinateTransformation *OGRTransform,
-	UGlobalCoordinates *GlobalCoordinates,
-	TArray<FPointList> &PointLists
+	TArray<FPointList> &PointLists,
+	TArrayView<const TOptional<FVector>> Locations
 )
 {
 
@@ -426,10 +450,12 @@ void ASplineImporter::GenerateLandscapeSplines(
 	);
 	PointsTask.MakeDialog();
 
+	int32 Offset = 0;
 	for (auto &PointList : PointLists)
 	{
 		PointsTask.EnterProgressFrame();
-		AddLandscapeSplinesPoints(Landscape, CollisionQueryParams, OGRTransform, GlobalCoordinates, LandscapeSplinesComponent, PointList, Points);
+		AddLandscapeSplinesPoints(Landscape, LandscapeSplinesComponent, PointList, Locations.Slice(Offset, PointList.Points.Num()), Points);
+		Offset += PointList.Points.Num();
 	}
 
 	UE_LOG(LogSplineImporter, Log, TEXT("Found %d control points"), Points.Num());
@@ -446,7 +472,7 @@ void ASplineImporter::GenerateLandscapeSplines(
 	for (auto &PointList : PointLists)
 	{
 		LandscapeSplinesTask.EnterProgressFrame();
-		AddLandscapeSplines(Landscape, CollisionQueryParams, OGRTransform, GlobalCoordinates, LandscapeSplinesComponent, PointList, Points);
+		AddLandscapeSplines(Landscape, LandscapeSplinesComponent, PointList, Points);
 	}
 	
 	UE_LOG(LogSplineImporter, Log, TEXT("Added %d segments"), LandscapeSplinesComponent->GetSegments().Num());
@@ -461,44 +487,23 @@ void ASplineImporter::GenerateLandscapeSplines(
 
 void ASplineImporter::AddLandscapeSplinesPoints(
 	ALandscape* Landscape,
-	FCollisionQueryParams CollisionQueryParams,
-	OGRCoordinateTransformation *OGRTransform,
-	UGlobalCoordinates *GlobalCoordinates,
 	ULandscapeSplinesComponent* LandscapeSplinesComponent,
 	FPointList &PointList,
+	TArrayView<const TOptional<FVector>> Locations,
 	TMap<FVector2D, ULandscapeSplineControlPoint*> &ControlPoints
 )
 {
-	UWorld *World = Landscape->GetWorld();
 	FTransform WorldToComponent = LandscapeSplinesComponent->GetComponentToWorld().Inverse();
 
-	for (OGRPoint &Point : PointList.Points)
+	for (int i = 0; i < PointList.Points.Num(); i++)
 	{
+		OGRPoint &Point = PointList.Points[i];
 		double Longitude = Point.getX();
 		double Latitude = Point.getY();
-		
-		// copy before converting
-		double ConvertedLongitude = Point.getX();
-		double ConvertedLatitude = Point.getY();
-
-		if (!OGRTransform->Transform(1, &ConvertedLongitude, &ConvertedLatitude))
-		{	
-			FMessageDialog::Open(EAppMsgType::Ok,
-				LOCTEXT("NoLandscapeSplinesComponent", "Landscape Combinator Error: Internal error while converting coordinates.")
-			);
-			return;
-		}
-
-		FVector2D XY;
-		GlobalCoordinates->GetUnrealCoordinatesFromCRS(ConvertedLongitude, ConvertedLatitude, XY);
 
-		double x = XY[0]; 
-		double y = XY[1];
-		double z;
-		if (LandscapeUtils::GetZ(World, CollisionQueryParams, x, y, z))
+		if (Locations[i].IsSet())
 		{
-			FVector Location = FVector(x, y, z) + SplinePointsOffset;
-			FVector LocalLocation = LandscapeSplinesComponent->GetComponentToWorld().InverseTransformPosition(Location);
+			FVector LocalLocation = LandscapeSplinesComponent->GetComponentToWorld().InverseTransformPosition(Locations[i].GetValue());
 			ULandscapeSplineControlPoint* ControlPoint = NewObject<ULandscapeSplineControlPoint>(LandscapeSplinesComponent, NAME_None, RF_Transactional);
 			ControlPoint->Location = LocalLocation;
 			LandscapeSplinesComponent->GetControlPoints().Add(ControlPoint);
@@ -507,18 +512,11 @@ void ASplineImporter::AddLandscapeSplinesPoints(
 			ControlPoint->SideFalloff = 200;
 			ControlPoints.Add( { Longitude, Latitude } , ControlPoint);
 		}
-		else
-		{
-			UE_LOG(LogSplineImporter, Warning, TEXT("No collision for point %f, %f"), x, y);
-		}
 	}
 }
 
 void ASplineImporter::AddLandscapeSplines(
 	ALandscape* Landscape,
-	FCollisionQueryParams CollisionQueryParams,
-	OGRCoordinateTransformation *OGRTransform,
-	UGlobalCoordinates *GlobalCoordinates,
 	ULandscapeSplinesComponent* LandscapeSplinesComponent,
 	FPointList &PointList,
 	TMap<FVector2D, ULandscapeSplineControlPoint*> &Points
@@ -533,7 +531,7 @@ void ASplineImporter::AddLandscapeSplines(
 		FVector2D OGRLocation1 = { Point1.getX(), Point1.getY() };
 		FVector2D OGRLocation2 = { Point2.getX(), Point2.getY() };
 
-		// this may happen when GetZ returned false in `AddPoints`
+		// this may happen when no height was found for a point in `AddLandscapeSplinesPoints`
 		if (!Points.Contains(OGRLocation1) || !Points.Contains(OGRLocation2))
 		{
 			continue;
@@ -572,10 +570,8 @@ void ASplineImporter::AddLandscapeSplines(
 
 void ASplineImporter::GenerateRegularSplines(
 	AActor *Actor,
-	FCollisionQueryParams CollisionQueryParams,
-	OGRCoordinateTransformation *OGRTransform,
-	UGlobalCoordinates *GlobalCoordinates,
-	TArray<FPointList> &PointLists
+	TArray<FPointList> &PointLists,
+	TArrayView<const TOptional<FVector>> Locations
 )
 {
 	UWorld *World = Actor->GetWorld();
@@ -616,6 +612,7 @@ void ASplineImporter::GenerateRegularSplines(
 	SplinesTask.MakeDialog();
 
 	int i = 0;
+	int32 Offset = 0;
 	for (auto &PointList : PointLists)
 	{
 		i++;
@@ -652,7 +649,8 @@ void ASplineImporter::GenerateRegularSplines(
 			SplineOwners.Add(SplineOwner);
 		}
 		SplinesTask.EnterProgressFrame();
-		AddRegularSpline(SplineOwner, CollisionQueryParams, OGRTransform, GlobalCoordinates, PointList);
+		AddRegularSpline(SplineOwner, PointList, Locations.Slice(Offset, PointList.Points.Num()));
+		Offset += PointList.Points.Num();
 	}
 	
 	GEditor->SelectActor(this, false, true);
@@ -662,14 +660,10 @@ void ASplineImporter::GenerateRegularSplines(
 
 void ASplineImporter::AddRegularSpline(
 	AActor* SplineOwner,
-	FCollisionQueryParams CollisionQueryParams,
-	OGRCoordinateTransformation *OGRTransform,
-	UGlobalCoordinates *GlobalCoordinates,
-	FPointList &PointList
+	FPointList &PointList,
+	TArrayView<const TOptional<FVector>> Locations
 )
 {
-	UWorld *World = SplineOwner->GetWorld();
-	
 	int NumPoints = PointList.Points.Num();
 	if (NumPoints == 0) return;
 
@@ -719,36 +713,9 @@ void ASplineImporter::AddRegularSpline(
 	{
 		if (Last != First || i < NumPoints - 1) // don't add last point in case the spline is a closed loop
 		{
-			OGRPoint Point = PointList.Points[i];
-			double Longitude = Point.getX();
-			double Latitude = Point.getY();
-		
-			// copy before converting
-			double ConvertedLongitude = Longitude;
-			double ConvertedLatitude = Latitude;
-				
-			if (!OGRTransform->Transform(1, &ConvertedLongitude, &ConvertedLatitude))
-			{
-				FMessageDialog::Open(EAppMsgType::Ok,
-					LOCTEXT("NoLandscapeSplinesComponent", "Landscape Combinator Error: Internal error while converting coordinates.")
-				);
-				return;
-			}
-			
-			FVector2D XY;
-			GlobalCoordinates->GetUnrealCoordinatesFromCRS(ConvertedLongitude, ConvertedLatitude, XY);
-
-			double x = XY[0];
-			double y = XY[1];
-			double z;
-			if (LandscapeUtils::GetZ(World, CollisionQueryParams, x, y, z))
-			{
-				FVector Location = FVector(x, y, z) + SplinePointsOffset;
-				SplineComponent->AddSplinePoint(Location, ESplineCoordinateSpace::World, false);
-			}
-			else
+			if (Locations[i].IsSet())
 			{
-				UE_LOG(LogSplineImporter, Warning, TEXT("No collision for point %f, %f"), x, y);
+				SplineComponent->AddSplinePoint(Locations[i].GetValue(), ESplineCoordinateSpace::World, false);
 			}
 		}
 	}
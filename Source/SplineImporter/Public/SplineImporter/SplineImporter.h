@@ -173,29 +173,25 @@ private:
 	void LoadGDALDatasetFromQuery(FString Query, TFunction<void(GDALDataset*)> OnComplete);
 	void LoadGDALDatasetFromShortQuery(FString ShortQuery, TFunction<void(GDALDataset*)> OnComplete);
 
+	// `Locations` are the world locations of the points of `PointLists` on the landscape or actor, one list after the other,
+	// and are unset for the points where no height was found
+
 	void GenerateLandscapeSplines(
 		ALandscape *Landscape,
-		FCollisionQueryParams CollisionQueryParams,
-		OGRCoordinateTransformation *OGRTransform,
-		UGlobalCoordinates *GlobalCoordinates,
-		TArray<FPointList> &PointLists
+		TArray<FPointList> &PointLists,
+		TArrayView<const TOptional<FVector>> Locations
 	);
 
 	void AddLandscapeSplinesPoints(
 		ALandscape* Landscape,
-		FCollisionQueryParams CollisionQueryParams,
-		OGRCoordinateTransformation *OGRTransform,
-		UGlobalCoordinates *GlobalCoordinates,
 		ULandscapeSplinesComponent* LandscapeSplinesComponent,
 		FPointList &PointList,
+		TArrayView<const TOptional<FVector>> Locations,
 		TMap<FVector2D, ULandscapeSplineControlPoint*> &Points
 	);
 
 	void AddLandscapeSplines(
 		ALandscape* Landscape,
-		FCollisionQueryParams CollisionQueryParams,
-		OGRCoordinateTransformation *OGRTransform,
-		UGlobalCoordinates *GlobalCoordinates,
 		ULandscapeSplinesComponent* LandscapeSplinesComponent,
 		FPointList &PointList,
 		TMap<FVector2D, ULandscapeSplineControlPoint*> &Points
@@ -203,18 +199,14 @@ private:
 
 	void GenerateRegularSplines(
 		AActor *Actor,
-		FCollisionQueryParams CollisionQueryParams,
-		OGRCoordinateTransformation *OGRTransform,
-		UGlobalCoordinates *GlobalCoordinates,
-		TArray<FPointList> &PointLists
+		TArray<FPointList> &PointLists,
+		TArrayView<const TOptional<FVector>> Locations
 	);
 
 	void AddRegularSpline(
 		AActor* SplineOwner,
-		FCollisionQueryParams CollisionQueryParams,
-		OGRCoordinateTransformation *OGRTransform,
-		UGlobalCoordinates *GlobalCoordinates,
-		FPointList &PointList
+		FPointList &PointList,
+		TArrayView<const TOptional<FVector>> Locations
 	);
 };
 